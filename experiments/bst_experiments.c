@@ -2,12 +2,24 @@
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
+#include <unistd.h>
 #include "../include/bst.h"
+#include "../include/rb_tree.h"
+#include "../include/treap.h"
+#include "../include/splay_tree.h"
 #include "../include/utils.h"
+#include "../include/key_stream.h"
 
 #define MAX_TREES 300     // Number of trees to build for each size (3x for better avg)
 #define MIN_SIZE 10       // Start small to see the full curve
 #define MAX_SIZE 100000   // Maximum tree size for all methods
+#define TREAP_BASE_SIZE 1000000   // treap union benchmark: deltas of 10 .. 1e6 keys into 1e6
+#define SCAPEGOAT_ALPHA 0.7        // depth limit log_{1/alpha} n for the scapegoat runs
+#define ZIPF_S 1.0                 // skew of the lookup stream: key of popularity rank r drawn with p ~ 1/r^s
+#define ZIPF_QUERIES 1000000       // lookups per tree in the splay benchmark
+#define ZIPF_HOT 100               // "hot set" = this many most popular keys
+#define TEARDOWN_SIZE 10000000    // teardown benchmark: one tree of 1e7 nodes per method
+#define TEARDOWN_MIN_THREADS 4     // thread curve goes at least this far
 #define NUM_SIZES 80      // More data points for better resolution
 
 typedef enum {
@@ -267,7 +279,7 @@ void run_comparison_experiments() {
     
     // Height comparison
     printf("\n=== Height Comparison ===\n");
-    printf("n,no_shuffle,fisher_yates,randomize_inplace,permute_sort\n");
+    printf("n,no_shuffle,fisher_yates,randomize_inplace,permute_sort,red_black_sorted\n");
     
     for (int size_idx = 0; size_idx < size_count; size_idx++) {
         int n = sizes[size_idx];
@@ -297,12 +309,23 @@ void run_comparison_experiments() {
             avg_height /= num_trees;
             printf(",%.2f", avg_height);
         }
+        
+        // 5th series: red-black tree fed the sorted (NoShuffle) keys
+        int* keys = generate_sequence(n);
+        Tree* T = create_tree();
+        for (int i = 0; i < n; i++) {
+            rb_tree_insert(T, create_node(keys[i]));
+        }
+        printf(",%.2f", (double)tree_height(T->root));
+        destroy_tree(T->root);
+        free(T);
+        free(keys);
         printf("\n");
     }
     
     // Build time timing
     printf("\n=== Build Time Comparison ===\n");
-    printf("n,no_shuffle,fisher_yates,randomize_inplace,permute_sort\n");
+    printf("n,no_shuffle,fisher_yates,randomize_inplace,permute_sort,red_black_sorted,bulk_load_sorted,hinted_sorted\n");
     
     for (int size_idx = 0; size_idx < size_count; size_idx++) {
         int n = sizes[size_idx];
@@ -335,6 +358,66 @@ void run_comparison_experiments() {
             avg_time /= num_trees;
             printf(",%.4f", avg_time);
         }
+        
+        // red-black on sorted keys
+        int num_trees = 10;
+        double avg_time = 0;
+        for (int tree_num = 0; tree_num < num_trees; tree_num++) {
+            int* keys = generate_sequence(n);
+            Tree* T = create_tree();
+
+            double start_time = get_time_ms();
+            for (int i = 0; i < n; i++) {
+                rb_tree_insert(T, create_node(keys[i]));
+            }
+            double end_time = get_time_ms();
+
+            avg_time += (end_time - start_time);
+
+            destroy_tree(T->root);
+            free(T);
+            free(keys);
+        }
+        printf(",%.4f", avg_time / num_trees);
+
+        // O(n) bulk load of the same sorted keys (one allocation)
+        avg_time = 0;
+        for (int tree_num = 0; tree_num < num_trees; tree_num++) {
+            int* keys = generate_sequence(n);
+
+            double start_time = get_time_ms();
+            Tree* T = tree_build_from_sorted(keys, n);
+            double end_time = get_time_ms();
+
+            avg_time += (end_time - start_time);
+
+            destroy_arena_tree(T);
+            free(keys);
+        }
+        printf(",%.4f", avg_time / num_trees);
+
+        // plain BST fed sorted keys, previous node as the insert hint
+        avg_time = 0;
+        for (int tree_num = 0; tree_num < num_trees; tree_num++) {
+            int* keys = generate_sequence(n);
+            Tree* T = create_tree();
+
+            double start_time = get_time_ms();
+            Node* last = NULL;
+            for (int i = 0; i < n; i++) {
+                Node* z = create_node(keys[i]);
+                tree_insert_hint(T, last, z);
+                last = z;
+            }
+            double end_time = get_time_ms();
+
+            avg_time += (end_time - start_time);
+
+            destroy_tree(T->root);
+            free(T);
+            free(keys);
+        }
+        printf(",%.4f", avg_time / num_trees);
         printf("\n");
     }
     
@@ -426,11 +509,428 @@ void run_comparison_experiments() {
         printf("\n");
     }
     
+    // malloc per node vs per-tree arena, random keys
+    printf("\n=== Arena Build/Destroy Comparison ===\n");
+    printf("n,malloc_build_ms,arena_build_ms,malloc_destroy_ms,arena_destroy_ms\n");
+
+    for (int size_idx = 0; size_idx < size_count; size_idx++) {
+        int n = sizes[size_idx];
+        int num_trees = (n <= 1000) ? 20 : 10;
+
+        double malloc_build = 0, arena_build = 0, malloc_destroy = 0, arena_destroy = 0;
+        for (int tree_num = 0; tree_num < num_trees; tree_num++) {
+            int* keys = generate_sequence(n);
+            fisher_yates(keys, n);
+
+            Tree* T = create_tree();
+            double start_time = get_time_ms();
+            for (int i = 0; i < n; i++) {
+                tree_insert(T, create_node(keys[i]));
+            }
+            double mid_time = get_time_ms();
+            destroy_tree(T->root);
+            double end_time = get_time_ms();
+            free(T);
+            malloc_build += mid_time - start_time;
+            malloc_destroy += end_time - mid_time;
+
+            T = create_arena_tree();
+            start_time = get_time_ms();
+            for (int i = 0; i < n; i++) {
+                tree_insert(T, tree_alloc_node(T, keys[i]));
+            }
+            mid_time = get_time_ms();
+            destroy_arena_tree(T);
+            end_time = get_time_ms();
+            arena_build += mid_time - start_time;
+            arena_destroy += end_time - mid_time;
+
+            free(keys);
+        }
+        printf("%d,%.4f,%.4f,%.4f,%.4f\n", n, malloc_build / num_trees, arena_build / num_trees,
+               malloc_destroy / num_trees, arena_destroy / num_trees);
+    }
+
+    // treap gets random shape from hashed priorities -> no shuffle needed first
+    printf("\n=== Treap vs Shuffle + BST ===\n");
+    printf("n,shuffle_build_ms,treap_sorted_build_ms,bst_shuffled_height,treap_sorted_height\n");
+
+    for (int size_idx = 0; size_idx < size_count; size_idx++) {
+        int n = sizes[size_idx];
+        int num_trees = (n <= 1000) ? 20 : 10;
+
+        double shuffle_build = 0, treap_build = 0, bst_height = 0, treap_height = 0;
+        for (int tree_num = 0; tree_num < num_trees; tree_num++) {
+            int* keys = generate_sequence(n);
+            Tree* T = create_tree();
+            double start_time = get_time_ms();
+            fisher_yates(keys, n);
+            for (int i = 0; i < n; i++) {
+                tree_insert(T, create_node(keys[i]));
+            }
+            shuffle_build += get_time_ms() - start_time;
+            bst_height += tree_height(T->root);
+            destroy_tree(T->root);
+            free(T);
+
+            // fresh seed per tree so the heights average over different shapes
+            treap_set_seed((unsigned int)rand());
+            free(keys);
+            keys = generate_sequence(n);        // sorted, the worst case for a plain BST
+            T = create_tree();
+            start_time = get_time_ms();
+            for (int i = 0; i < n; i++) {
+                treap_insert(T, create_node(keys[i]));
+            }
+            treap_build += get_time_ms() - start_time;
+            treap_height += tree_height(T->root);
+            destroy_tree(T->root);
+            free(T);
+            free(keys);
+        }
+        printf("%d,%.4f,%.4f,%.2f,%.2f\n", n, shuffle_build / num_trees, treap_build / num_trees,
+               bst_height / num_trees, treap_height / num_trees);
+    }
+
+    // sorted keys, no per-node balance data: scapegoat mode vs plain + one DSW pass
+    printf("\n=== Scapegoat Mode on Sorted Keys ===\n");
+    printf("n,plain_height,scapegoat_height,plain_build_ms,scapegoat_build_ms,dsw_rebalance_ms,rebalanced_height\n");
+
+    for (int size_idx = 0; size_idx < size_count; size_idx++) {
+        int n = sizes[size_idx];
+        int* keys = generate_sequence(n);
+
+        Tree* T = create_tree();
+        double start_time = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            tree_insert(T, create_node(keys[i]));
+        }
+        double plain_ms = get_time_ms() - start_time;
+        int plain_height = tree_height(T->root);
+
+        start_time = get_time_ms();
+        tree_rebalance(T);
+        double dsw_ms = get_time_ms() - start_time;
+        int rebalanced_height = tree_height(T->root);
+        destroy_tree(T->root);
+        free(T);
+
+        T = create_tree();
+        tree_set_scapegoat(T, SCAPEGOAT_ALPHA);
+        start_time = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            tree_insert(T, create_node(keys[i]));
+        }
+        double scapegoat_ms = get_time_ms() - start_time;
+        int scapegoat_height = tree_height(T->root);
+        destroy_tree(T->root);
+        free(T);
+        free(keys);
+
+        printf("%d,%d,%d,%.4f,%.4f,%.4f,%d\n", n, plain_height, scapegoat_height,
+               plain_ms, scapegoat_ms, dsw_ms, rebalanced_height);
+    }
+
     free(sizes);
 }
 
-int main(void) {
+// Merge a delta of m keys into a treap of TREAP_BASE_SIZE keys:
+// treap_union vs one treap_insert per key
+void run_treap_union_experiment() {
+    printf("\n=== Treap Union vs Repeated Insert ===\n");
+    printf("base_n,m,insert_each_ms,union_ms,delta_build_ms\n");
+
+    int n = TREAP_BASE_SIZE;
+    int* evens = generate_sequence(n);
+    int* odds = generate_sequence(n);
+    fisher_yates(odds, n);
+    for (int i = 0; i < n; i++) {
+        evens[i] = 2 * evens[i];             // base: 2, 4, .., 2n
+        odds[i] = 2 * odds[i] - 1;           // delta: random odd keys, never in the base
+    }
+
+    for (int m = 10; m <= n; m *= 10) {
+        Tree* base = create_tree();
+        for (int i = 0; i < n; i++) {
+            treap_insert(base, create_node(evens[i]));
+        }
+        double start_time = get_time_ms();
+        for (int i = 0; i < m; i++) {
+            treap_insert(base, create_node(odds[i]));
+        }
+        double insert_ms = get_time_ms() - start_time;
+        destroy_tree(base->root);
+        free(base);
+
+        base = create_tree();
+        for (int i = 0; i < n; i++) {
+            treap_insert(base, create_node(evens[i]));
+        }
+        Tree* delta = create_tree();
+        start_time = get_time_ms();
+        for (int i = 0; i < m; i++) {
+            treap_insert(delta, create_node(odds[i]));
+        }
+        double delta_ms = get_time_ms() - start_time;
+        start_time = get_time_ms();
+        treap_union(base, delta);
+        double union_ms = get_time_ms() - start_time;
+        destroy_tree(base->root);
+        free(base);
+        free(delta);
+
+        printf("%d,%d,%.4f,%.4f,%.4f\n", n, m, insert_ms, union_ms, delta_ms);
+    }
+
+    free(evens);
+    free(odds);
+}
+
+// depth of key below root (root = 1, like tree_height), 0 if missing
+static int key_depth(Node* x, int key) {
+    int d = 1;
+    while (x != NULL && key != x->key) {
+        x = (key < x->key) ? x->left : x->right;
+        d++;
+    }
+    return x == NULL ? 0 : d;
+}
+
+// Zipf-distributed lookups (a few keys get most of them) against a plain BST
+// and a red-black tree built from the same shuffled keys, and a splay tree.
+// avg_depth = depth of the looked up key at the moment of the lookup (for the
+// splay tree that is the amortized cost), hot_depth = mean depth of the
+// ZIPF_HOT most popular keys once the stream is over.
+void run_zipf_splay_experiment() {
+    printf("\n=== Zipf Lookups: BST vs Red-Black vs Splay ===\n");
+    printf("n,bst_ms,rb_ms,splay_ms,bst_avg_depth,rb_avg_depth,splay_avg_depth,bst_hot_depth,rb_hot_depth,splay_hot_depth\n");
+
+    int* queries = (int*)malloc(ZIPF_QUERIES * sizeof(int));
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        int* keys = generate_sequence(n);
+        int* popular = generate_sequence(n);    // popular[r] = key with popularity rank r + 1
+        fisher_yates(keys, n);
+        fisher_yates(popular, n);
+
+        double* cdf = (double*)malloc(n * sizeof(double));
+        double total = 0;
+        for (int r = 0; r < n; r++) {
+            total += 1.0 / pow(r + 1, ZIPF_S);
+            cdf[r] = total;
+        }
+        for (int q = 0; q < ZIPF_QUERIES; q++) {
+            double u = total * ((double)rand() / RAND_MAX);
+            int lo = 0, hi = n - 1;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (cdf[mid] < u) lo = mid + 1;
+                else hi = mid;
+            }
+            queries[q] = popular[lo];
+        }
+
+        Tree* trees[3];
+        for (int t = 0; t < 3; t++) {
+            trees[t] = create_arena_tree();
+            for (int i = 0; i < n; i++) {
+                Node* z = tree_alloc_node(trees[t], keys[i]);
+                if (t == 0) tree_insert(trees[t], z);
+                else if (t == 1) rb_tree_insert(trees[t], z);
+                else splay_tree_insert(trees[t], z);
+            }
+        }
+
+        double ms[3], avg_depth[3], hot_depth[3];
+        for (int t = 0; t < 3; t++) {
+            Tree* T = trees[t];
+            double start_time = get_time_ms();
+            for (int q = 0; q < ZIPF_QUERIES; q++) {
+                if (t == 2) splay_tree_search(T, queries[q]);
+                else tree_search(T->root, queries[q]);
+            }
+            ms[t] = get_time_ms() - start_time;
+
+            // second pass over the same stream, the splay tree is warm by now
+            long long depth_sum = 0;
+            for (int q = 0; q < ZIPF_QUERIES; q++) {
+                depth_sum += key_depth(T->root, queries[q]);
+                if (t == 2) splay_tree_search(T, queries[q]);
+            }
+            avg_depth[t] = (double)depth_sum / ZIPF_QUERIES;
+
+            depth_sum = 0;
+            int hot = n < ZIPF_HOT ? n : ZIPF_HOT;
+            for (int r = 0; r < hot; r++) {
+                depth_sum += key_depth(T->root, popular[r]);
+            }
+            hot_depth[t] = (double)depth_sum / hot;
+            destroy_arena_tree(T);
+        }
+
+        printf("%d,%.4f,%.4f,%.4f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", n, ms[0], ms[1], ms[2],
+               avg_depth[0], avg_depth[1], avg_depth[2], hot_depth[0], hot_depth[1], hot_depth[2]);
+        free(cdf);
+        free(keys);
+        free(popular);
+    }
+    free(queries);
+}
+
+// middle of by_key[lo..hi] on top -> balanced, whatever order the nodes were malloc'd in
+static Node* link_balanced(Node** by_key, int lo, int hi, Node* parent) {
+    if (lo > hi) return NULL;
+    int mid = lo + (hi - lo) / 2;
+    Node* x = by_key[mid];
+    x->p = parent;
+    x->left = link_balanced(by_key, lo, mid - 1, x);
+    x->right = link_balanced(by_key, mid + 1, hi, x);
+    return x;
+}
+
+// malloc'd nodes allocated in random key order (so neighbours in the tree are
+// scattered in memory like after random inserts), linked without n log n inserts
+static Tree* malloc_balanced_tree(int n) {
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    Node** by_key = (Node**)malloc(n * sizeof(Node*));
+    for (int i = 0; i < n; i++) {
+        by_key[keys[i] - 1] = create_node(keys[i]);
+    }
+    Tree* T = create_tree();
+    T->root = link_balanced(by_key, 0, n - 1, NULL);
+    free(by_key);
+    free(keys);
+    return T;
+}
+
+// Teardown of one 1e7-node tree: what the destroy experiment does (delete the
+// root over and over), destroy_tree, destroy_tree_parallel on 1..N threads,
+// and an arena tree that gives its slabs back in one go. Wall clock.
+void run_teardown_experiment() {
+    printf("\n=== Teardown of a 10M-Node Tree ===\n");
+    printf("method,threads,n,ms\n");
+
+    int n = TEARDOWN_SIZE;
+    Tree* T = malloc_balanced_tree(n);
+    double start_time = get_wall_time_ms();
+    while (T->root != NULL) {
+        Node* z = T->root;
+        tree_delete(T, z);
+        free(z);
+    }
+    printf("root_delete,1,%d,%.2f\n", n, get_wall_time_ms() - start_time);
+    free(T);
+
+    T = malloc_balanced_tree(n);
+    start_time = get_wall_time_ms();
+    destroy_tree(T->root);
+    printf("destroy_tree,1,%d,%.2f\n", n, get_wall_time_ms() - start_time);
+    free(T);
+
+    int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < TEARDOWN_MIN_THREADS) max_threads = TEARDOWN_MIN_THREADS;
+    for (int t = 1; ; t *= 2) {
+        if (t > max_threads) t = max_threads;
+        T = malloc_balanced_tree(n);
+        start_time = get_wall_time_ms();
+        destroy_tree_parallel(T->root, t);
+        printf("destroy_tree_parallel,%d,%d,%.2f\n", t, n, get_wall_time_ms() - start_time);
+        free(T);
+        if (t == max_threads) break;
+    }
+
+    int* keys = generate_sequence(n);
+    T = tree_build_from_sorted(keys, n);
+    start_time = get_wall_time_ms();
+    destroy_arena_tree(T);
+    printf("destroy_arena_tree,1,%d,%.2f\n", n, get_wall_time_ms() - start_time);
+    free(keys);
+}
+
+// --keys / --keys64: the build and lookup numbers for a captured key file
+// instead of 1..n, keys read straight off the mapped file. File order is
+// kept (shuffle it beforehand for the random case); a sorted file gets the
+// stream bulk load, and is the O(n^2) case for the plain BST row.
+int run_key_file_experiment(const char* path, int width) {
+    KeyStream* S = key_stream_open(path, width);
+    if (S == NULL) {
+        printf("Cannot read %s as packed %d-bit keys\n", path, 8 * width);
+        return 1;
+    }
+    printf("Key file: %s (%zu keys, %d-bit)\n", path, S->count, 8 * width);
+    printf("\n=== Key File Ingestion ===\n");
+    printf("method,n,ms,height,skipped\n");
+
+    Tree* R = create_arena_tree();
+    double start = get_time_ms();
+    size_t got;
+    const int* keys;
+    long n = 0;
+    while ((keys = key_stream_next(S, 0, &got)) != NULL) {
+        for (size_t i = 0; i < got; i++) rb_tree_insert(R, tree_alloc_node(R, keys[i]));
+        n += (long)got;
+    }
+    printf("rb_tree_insert,%ld,%.2f,%d,%zu\n", n, get_time_ms() - start, tree_height(R->root), S->skipped);
+    fflush(stdout);
+
+    // plain BST on a big sorted file is the O(n^2) case: row left out
+    key_stream_rewind(S);
+    Tree* T = NULL;
+    if (key_stream_is_sorted(S) && n > MAX_SIZE) {
+        printf("tree_insert_stream,%ld,sorted_skipped,,\n", n);
+    }
+    else {
+        T = create_arena_tree();
+        start = get_time_ms();
+        tree_insert_stream(T, S);
+        printf("tree_insert_stream,%ld,%.2f,%d,%zu\n", n, get_time_ms() - start, tree_height(T->root), S->skipped);
+    }
+    fflush(stdout);
+
+    key_stream_rewind(S);
+    start = get_time_ms();
+    Tree* B = tree_build_from_stream(S);
+    if (B != NULL) {
+        printf("tree_build_from_stream,%ld,%.2f,%d,%zu\n", n, get_time_ms() - start, tree_height(B->root), S->skipped);
+        destroy_arena_tree(B);
+    }
+    else {
+        printf("tree_build_from_stream,%ld,%s,,%zu\n", n, S->skipped ? "keys_dropped" : "unsorted", S->skipped);
+    }
+
+    // every key looked up once, in file order
+    printf("\n=== Key File Lookups ===\n");
+    printf("tree,n,ms,ns_per_lookup,all_found\n");
+    Tree* trees[2] = {R, T};
+    const char* names[2] = {"red_black", "bst"};
+    for (int t = 0; t < 2 && trees[t] != NULL; t++) {
+        key_stream_rewind(S);
+        long found = 0;
+        start = get_time_ms();
+        while ((keys = key_stream_next(S, 0, &got)) != NULL) {
+            for (size_t i = 0; i < got; i++) found += tree_search(trees[t]->root, keys[i]) != NULL;
+        }
+        double ms = get_time_ms() - start;
+        printf("%s,%ld,%.2f,%.1f,%s\n", names[t], n, ms, n > 0 ? ms * 1e6 / n : 0.0, found == n ? "yes" : "no");
+        destroy_arena_tree(trees[t]);
+    }
+    key_stream_close(S);
+    return 0;
+}
+
+int main(int argc, char** argv) {
     srand(time(NULL));
+
+    const char* key_path;
+    int key_width;
+    int args = key_stream_parse_args(argc, argv, &key_path, &key_width);
+    if (args < 0) {
+        printf("usage: %s [--keys FILE | --keys64 FILE]\n", argv[0]);
+        return 1;
+    }
+    if (args > 0) {
+        return run_key_file_experiment(key_path, key_width);
+    }
     
     printf("BST Experiments - Comparing Four Shuffling Methods\n");
     printf("===================================================\n");
@@ -438,6 +938,7 @@ int main(void) {
     printf("2. Fisher-Yates (Classic) - Random Case O(log n) height\n");
     printf("3. RANDOMIZE-IN-PLACE (CLRS) - Random Case O(log n) height\n");
     printf("4. PERMUTE-BY-SORTING (CLRS) - Random Case O(log n) height\n");
+    printf("(+ red-black tree on sorted keys in the comparisons - O(log n) worst case)\n");
     printf("\nSize range: %d to %d\n", MIN_SIZE, MAX_SIZE);
     printf("Number of size points: up to %d\n", NUM_SIZES);
     printf("Size progression: n = %d * 1.2^i\n", MIN_SIZE);
@@ -453,6 +954,9 @@ int main(void) {
     // comparisons
     printf("\n[5/5] Running comparison experiments...\n");
     run_comparison_experiments();
+    run_treap_union_experiment();
+    run_zipf_splay_experiment();
+    run_teardown_experiment();
     
     printf("\nAll experiments completed!\n");
     
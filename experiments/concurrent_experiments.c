@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/bst.h"
+#include "../include/concurrent_bst.h"
+#include "../include/lockfree_bst.h"
+#include "../include/utils.h"
+
+#define CONC_TREE_SIZE 1000000   // keys in the tree for every run
+#define CONC_RUN_MS 1000         // each (mode, thread count) point runs this long
+#define CONC_MIN_THREADS 4       // reader curve goes at least this far
+#define WRITER_PAUSE_US 20       // one writer, delete + insert, then a short pause -> read-mostly
+#define MIXED_KEY_RANGE 1000000  // mixed-ops run: keys drawn from 1..range, half of them in at the start
+#define MIXED_SEARCH_PCT 50      // rest split evenly between insert and delete
+
+typedef enum {
+    MODE_LOCKFREE,   // conc_tree_*: no lock for readers, epochs for reclamation
+    MODE_RWLOCK,     // plain bst.c behind a pthread rwlock
+    MODE_MUTEX       // plain bst.c behind one global mutex (what callers do today)
+} ConcMode;
+
+const char* get_mode_name(ConcMode mode) {
+    switch (mode) {
+        case MODE_LOCKFREE: return "lockfree_epoch";
+        case MODE_RWLOCK: return "rwlock";
+        case MODE_MUTEX: return "mutex";
+        default: return "Unknown";
+    }
+}
+
+typedef struct {
+    ConcMode mode;
+    ConcurrentTree* CT;
+    Tree* T;
+    pthread_mutex_t mutex;
+    pthread_rwlock_t rwlock;
+    int n;
+    int stop;
+} Shared;
+
+typedef struct {
+    Shared* S;
+    unsigned int seed;
+    long ops;
+} Worker;
+
+static void* reader_thread(void* arg) {
+    Worker* w = (Worker*)arg;
+    Shared* S = w->S;
+    ConcReader* r = (S->mode == MODE_LOCKFREE) ? conc_reader_register(S->CT) : NULL;
+    long ops = 0;
+    while (!__atomic_load_n(&S->stop, __ATOMIC_RELAXED)) {
+        for (int i = 0; i < 64; i++) {
+            int key = 1 + rand_r(&w->seed) % S->n;
+            if (S->mode == MODE_LOCKFREE) {
+                conc_tree_search(r, key);
+            }
+            else if (S->mode == MODE_RWLOCK) {
+                pthread_rwlock_rdlock(&S->rwlock);
+                tree_search(S->T->root, key);
+                pthread_rwlock_unlock(&S->rwlock);
+            }
+            else {
+                pthread_mutex_lock(&S->mutex);
+                tree_search(S->T->root, key);
+                pthread_mutex_unlock(&S->mutex);
+            }
+        }
+        ops += 64;
+    }
+    if (r != NULL) conc_reader_unregister(r);
+    w->ops = ops;
+    return NULL;
+}
+
+// take a random key out and put it straight back, so the key set stays 1..n
+static void* writer_thread(void* arg) {
+    Worker* w = (Worker*)arg;
+    Shared* S = w->S;
+    long ops = 0;
+    while (!__atomic_load_n(&S->stop, __ATOMIC_RELAXED)) {
+        int key = 1 + rand_r(&w->seed) % S->n;
+        if (S->mode == MODE_LOCKFREE) {
+            conc_tree_delete(S->CT, key);
+            conc_tree_insert(S->CT, key);
+        }
+        else {
+            if (S->mode == MODE_RWLOCK) pthread_rwlock_wrlock(&S->rwlock);
+            else pthread_mutex_lock(&S->mutex);
+            Node* z = tree_search(S->T->root, key);
+            tree_delete(S->T, z);
+            free(z);
+            tree_insert(S->T, create_node(key));
+            if (S->mode == MODE_RWLOCK) pthread_rwlock_unlock(&S->rwlock);
+            else pthread_mutex_unlock(&S->mutex);
+        }
+        ops++;
+        usleep(WRITER_PAUSE_US);
+    }
+    w->ops = ops;
+    return NULL;
+}
+
+// Read-mostly throughput: `readers` threads doing lookups of random keys,
+// one writer doing delete + insert pairs, for CONC_RUN_MS of wall time
+void experiment_read_scaling() {
+    printf("\n=== Read-Mostly Lookup Throughput ===\n");
+    printf("mode,readers,lookups_per_sec,writes_per_sec\n");
+
+    int n = CONC_TREE_SIZE;
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < CONC_MIN_THREADS) max_threads = CONC_MIN_THREADS;
+
+    for (ConcMode mode = MODE_LOCKFREE; mode <= MODE_MUTEX; mode++) {
+        Shared S;
+        S.mode = mode;
+        S.n = n;
+        S.CT = NULL;
+        S.T = NULL;
+        pthread_mutex_init(&S.mutex, NULL);
+        pthread_rwlock_init(&S.rwlock, NULL);
+        if (mode == MODE_LOCKFREE) {
+            S.CT = conc_tree_create();
+            for (int i = 0; i < n; i++) conc_tree_insert(S.CT, keys[i]);
+        }
+        else {
+            S.T = create_tree();
+            for (int i = 0; i < n; i++) tree_insert(S.T, create_node(keys[i]));
+        }
+
+        for (int t = 1; ; t *= 2) {
+            if (t > max_threads) t = max_threads;
+            S.stop = 0;
+            Worker* w = (Worker*)malloc((t + 1) * sizeof(Worker));
+            pthread_t* tid = (pthread_t*)malloc((t + 1) * sizeof(pthread_t));
+            for (int i = 0; i <= t; i++) {
+                w[i].S = &S;
+                w[i].seed = (unsigned int)rand();
+                w[i].ops = 0;
+            }
+            double start = get_wall_time_ms();
+            pthread_create(&tid[0], NULL, writer_thread, &w[0]);
+            for (int i = 1; i <= t; i++) pthread_create(&tid[i], NULL, reader_thread, &w[i]);
+            usleep(CONC_RUN_MS * 1000);
+            __atomic_store_n(&S.stop, 1, __ATOMIC_RELAXED);
+            long lookups = 0;
+            for (int i = 0; i <= t; i++) {
+                pthread_join(tid[i], NULL);
+                if (i > 0) lookups += w[i].ops;
+            }
+            double secs = (get_wall_time_ms() - start) / 1000.0;
+            printf("%s,%d,%.0f,%.0f\n", get_mode_name(mode), t, lookups / secs, w[0].ops / secs);
+            fflush(stdout);
+            free(w);
+            free(tid);
+            if (t == max_threads) break;
+        }
+
+        if (S.CT != NULL) conc_tree_destroy(S.CT);
+        if (S.T != NULL) {
+            destroy_tree(S.T->root);
+            free(S.T);
+        }
+        pthread_mutex_destroy(&S.mutex);
+        pthread_rwlock_destroy(&S.rwlock);
+    }
+    free(keys);
+}
+
+// ---------- mixed operations: lock-free tree vs bst.c behind a mutex ----------
+
+typedef enum {
+    IMPL_LOCKFREE,   // lf_tree_*: Natarajan-Mittal, every thread inserts and deletes
+    IMPL_MUTEX       // bst.c with one global mutex around every operation
+} MixedImpl;
+
+const char* get_impl_name(MixedImpl impl) {
+    switch (impl) {
+        case IMPL_LOCKFREE: return "lockfree_nm";
+        case IMPL_MUTEX: return "mutex_bst";
+        default: return "Unknown";
+    }
+}
+
+typedef struct {
+    MixedImpl impl;
+    LFTree* LT;
+    Tree* T;
+    pthread_mutex_t mutex;
+    int range;
+    int stop;
+} MixedShared;
+
+typedef struct {
+    MixedShared* S;
+    unsigned int seed;
+    long ops;
+    long net;        // successful inserts - successful deletes
+} MixedWorker;
+
+// set semantics on both sides, so the two do the same work per operation
+static int mixed_op(MixedShared* S, LFThread* h, int op, int key) {
+    if (S->impl == IMPL_LOCKFREE) {
+        if (op == 0) return lf_tree_insert(h, key);
+        if (op == 1) return -lf_tree_delete(h, key);
+        lf_tree_search(h, key);
+        return 0;
+    }
+    int d = 0;
+    pthread_mutex_lock(&S->mutex);
+    Node* x = tree_search(S->T->root, key);
+    if (op == 0 && x == NULL) {
+        tree_insert(S->T, create_node(key));
+        d = 1;
+    }
+    else if (op == 1 && x != NULL) {
+        tree_delete(S->T, x);
+        free(x);
+        d = -1;
+    }
+    pthread_mutex_unlock(&S->mutex);
+    return d;
+}
+
+static void* mixed_thread(void* arg) {
+    MixedWorker* w = (MixedWorker*)arg;
+    MixedShared* S = w->S;
+    LFThread* h = (S->impl == IMPL_LOCKFREE) ? lf_thread_register(S->LT) : NULL;
+    long ops = 0, net = 0;
+    while (!__atomic_load_n(&S->stop, __ATOMIC_RELAXED)) {
+        for (int i = 0; i < 64; i++) {
+            int r = rand_r(&w->seed) % 100;
+            int op = (r < MIXED_SEARCH_PCT) ? 2 : (r < (100 + MIXED_SEARCH_PCT) / 2) ? 0 : 1;
+            net += mixed_op(S, h, op, 1 + rand_r(&w->seed) % S->range);
+        }
+        ops += 64;
+    }
+    if (h != NULL) lf_thread_unregister(h);
+    w->ops = ops;
+    w->net = net;
+    return NULL;
+}
+
+static int mixed_count(MixedShared* S) {
+    if (S->impl == IMPL_LOCKFREE) return lf_tree_count(S->LT);
+    int count = 0;
+    for (Node* x = tree_min(S->T->root); x != NULL; x = tree_successor(x)) count++;
+    return count;
+}
+
+// Every thread runs the same mix for CONC_RUN_MS of wall time. The tree
+// starts with half the key range in, shuffled, so inserts and deletes hit
+// about as often as they miss and the size stays put. Doubles as a stress
+// run: the final key count has to equal start + all successful inserts -
+// all successful deletes.
+void experiment_mixed_ops() {
+    printf("\n=== Mixed Insert/Delete/Search Throughput ===\n");
+    printf("impl,threads,ops_per_sec,final_count_ok\n");
+
+    int range = MIXED_KEY_RANGE;
+    int* keys = generate_sequence(range);
+    fisher_yates(keys, range);
+    int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < CONC_MIN_THREADS) max_threads = CONC_MIN_THREADS;
+
+    for (MixedImpl impl = IMPL_LOCKFREE; impl <= IMPL_MUTEX; impl++) {
+        for (int t = 1; ; t *= 2) {
+            if (t > max_threads) t = max_threads;
+            MixedShared S;
+            S.impl = impl;
+            S.range = range;
+            S.stop = 0;
+            S.LT = NULL;
+            S.T = NULL;
+            pthread_mutex_init(&S.mutex, NULL);
+            if (impl == IMPL_LOCKFREE) {
+                S.LT = lf_tree_create();
+                LFThread* h = lf_thread_register(S.LT);
+                for (int i = 0; i < range / 2; i++) lf_tree_insert(h, keys[i]);
+                lf_thread_unregister(h);
+            }
+            else {
+                S.T = create_tree();
+                for (int i = 0; i < range / 2; i++) tree_insert(S.T, create_node(keys[i]));
+            }
+
+            MixedWorker* w = (MixedWorker*)malloc(t * sizeof(MixedWorker));
+            pthread_t* tid = (pthread_t*)malloc(t * sizeof(pthread_t));
+            for (int i = 0; i < t; i++) {
+                w[i].S = &S;
+                w[i].seed = (unsigned int)rand();
+                w[i].ops = 0;
+                w[i].net = 0;
+            }
+            double start = get_wall_time_ms();
+            for (int i = 0; i < t; i++) pthread_create(&tid[i], NULL, mixed_thread, &w[i]);
+            usleep(CONC_RUN_MS * 1000);
+            __atomic_store_n(&S.stop, 1, __ATOMIC_RELAXED);
+            long ops = 0, net = 0;
+            for (int i = 0; i < t; i++) {
+                pthread_join(tid[i], NULL);
+                ops += w[i].ops;
+                net += w[i].net;
+            }
+            double secs = (get_wall_time_ms() - start) / 1000.0;
+            int ok = (mixed_count(&S) == range / 2 + net);
+            printf("%s,%d,%.0f,%s\n", get_impl_name(impl), t, ops / secs, ok ? "yes" : "no");
+            fflush(stdout);
+            free(w);
+            free(tid);
+
+            if (S.LT != NULL) lf_tree_destroy(S.LT);
+            if (S.T != NULL) {
+                destroy_tree(S.T->root);
+                free(S.T);
+            }
+            pthread_mutex_destroy(&S.mutex);
+            if (t == max_threads) break;
+        }
+    }
+    free(keys);
+}
+
+int main(void) {
+    srand(time(NULL));
+
+    printf("Concurrent BST Experiments\n");
+    printf("==========================\n");
+    printf("Tree size: %d keys, %d ms per point, one writer (delete + insert, %d us pause)\n",
+           CONC_TREE_SIZE, CONC_RUN_MS, WRITER_PAUSE_US);
+    printf("Mixed run: keys 1..%d, %d%% search, rest insert/delete\n", MIXED_KEY_RANGE, MIXED_SEARCH_PCT);
+
+    experiment_read_scaling();
+    experiment_mixed_ops();
+
+    printf("\nAll concurrent experiments completed!\n");
+    printf("Results can be plotted to show:\n");
+    printf("  1. Lookup throughput vs reader threads: lock-free + epochs vs rwlock vs mutex\n");
+    printf("  2. Mixed insert/delete/search throughput vs threads: lock-free BST vs mutex-wrapped bst.c\n");
+
+    return 0;
+}
@@ -2,14 +2,70 @@
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
+#include <string.h>
+#include <unistd.h>
 #include "../include/bst.h"
 #include "../include/os_tree.h"
+#include "../include/os_rb_tree.h"
+#include "../include/frozen_tree.h"
+#include "../include/compact_tree.h"
+#include "../include/bplus_tree.h"
+#include "../include/persistent_tree.h"
+#include "../include/tree_image.h"
 #include "../include/utils.h"
+#include "../include/key_stream.h"
+#include "../include/fenwick_tree.h"
+#include "../include/sliding_window.h"
 
 #define MIN_SIZE 10
 #define MAX_SIZE 100000
 #define NUM_SIZES 80
 
+#define FROZEN_MIN_SIZE 100000     // frozen snapshot benchmark: 1e5 .. 1e7 keys
+#define FROZEN_MAX_SIZE 10000000   // (1e8 would need ~7GB for the two pointer trees)
+#define FROZEN_QUERIES 1000000
+
+#define COMPACT_MIN_SIZE 100000    // compact layout benchmark: 1e5 .. 1e7 keys
+#define COMPACT_MAX_SIZE 10000000
+
+#define BPT_MIN_SIZE 100000        // B+-tree benchmark: 1e5 .. 1e7 keys
+#define BPT_MAX_SIZE 10000000
+
+#define BATCH_MIN_SIZE 1000000     // batched lookup benchmark: 1e6 and 1e7 keys,
+#define BATCH_MAX_SIZE 10000000    // batch sizes 1, 2, 4 .. 4096
+#define BATCH_MAX 4096
+
+#define STREAM_MIN_SIZE 1000       // sorted-stream insert benchmark: 1000 .. 64000 keys
+#define STREAM_MAX_SIZE 64000      // (root inserts are O(n^2) here, so kept small)
+
+#define PARALLEL_BUILD_SIZE 10000000  // parallel bulk load: shuffled keys, 1 .. N threads
+#define PARALLEL_MIN_THREADS 4        // curve goes at least this far even on small machines
+
+#define SNAPSHOT_MIN_SIZE 10000       // snapshot cost: 1e4 .. 1e6 keys
+#define SNAPSHOT_MAX_SIZE 1000000
+#define SNAPSHOT_UPDATES 10000        // inserts timed after each snapshot
+
+#define IMAGE_SIZE 1000000            // startup benchmark: rebuild vs reopening a mapped image
+#define IMAGE_BENCH_SIZE 50000000     // --startup-bench: minutes of rebuild, ~2.5 GB of nodes, ~0.8 GB image
+#define IMAGE_QUERIES 1000            // first queries after startup (they pay the page faults)
+#define IMAGE_PATH "data/startup_image.bin"   // removed again afterwards
+
+#define KEYRANK_MIN_SIZE 10000        // rank by key / range count: 1e4 .. 1e6 keys
+#define KEYRANK_MAX_SIZE 1000000
+#define KEYRANK_QUERIES 100000
+
+#define MULTI_SIZE 10000000           // multi-select: 1e7 keys, 1 .. 65536 quantiles at once
+#define MULTI_MAX_M 65536
+#define MULTI_WORK 1000000            // selects per measurement, repeated over the set
+
+#define FENWICK_MIN_SIZE 100000       // Fenwick vs pointer OS-tree: dense keys 1..n, 1e5 .. 1e7
+#define FENWICK_MAX_SIZE 10000000
+#define FENWICK_QUERIES 1000000
+
+#define WINDOW_MIN 1000               // sliding-window quantiles: w = 1e3 .. 1e7
+#define WINDOW_MAX 10000000
+#define WINDOW_TICKS 1000000          // samples timed once the window is full
+
 
 int* generate_sizes(int* count) {
     int* sizes = (int*)malloc(NUM_SIZES * sizeof(int));
@@ -178,10 +234,64 @@ void experiment_delete_comparison() {
     free(sizes);
 }
 
+// OS-tree from the sorted keys 1..n (NoShuffle), plain or red-black.
+// nodes (optional) gets node i-1 -> key i for the rank experiment.
+OSTree* build_sorted_os_tree(int n, int balanced, OSNode** nodes) {
+    int* keys = generate_sequence(n);
+    no_shuffle(keys, n);
+
+    OSTree* os_tree = os_create_tree();
+    for (int i = 0; i < n; i++) {
+        OSNode* node = os_create_node(keys[i]);
+        if (balanced)
+            os_rb_tree_insert(os_tree, node);
+        else
+            os_tree_insert(os_tree, node);
+        if (nodes)
+            nodes[i] = node;
+    }
+    free(keys);
+    return os_tree;
+}
+
+// us per os_select on a sorted-input tree
+double time_select_sorted(int n, int balanced, int num_operations) {
+    OSTree* os_tree = build_sorted_os_tree(n, balanced, NULL);
+
+    double start = get_time_ms();
+    for (int op = 0; op < num_operations; op++) {
+        OSNode* result = os_select(os_tree->root, random_range(1, n));
+        volatile int temp __attribute__((unused)) = result ? result->key : 0;
+    }
+    double end = get_time_ms();
+
+    os_destroy_tree(os_tree->root);
+    free(os_tree);
+    return (end - start) * 1000.0 / num_operations;
+}
+
+// us per os_rank on a sorted-input tree
+double time_rank_sorted(int n, int balanced, int num_operations) {
+    OSNode** nodes = (OSNode**)malloc(n * sizeof(OSNode*));
+    OSTree* os_tree = build_sorted_os_tree(n, balanced, nodes);
+
+    double start = get_time_ms();
+    for (int op = 0; op < num_operations; op++) {
+        int rank = os_rank(os_tree, nodes[random_range(0, n - 1)]);
+        volatile int temp __attribute__((unused)) = rank;
+    }
+    double end = get_time_ms();
+
+    os_destroy_tree(os_tree->root);
+    free(os_tree);
+    free(nodes);
+    return (end - start) * 1000.0 / num_operations;
+}
+
 //os select
 void experiment_os_select() {
     printf("\n=== Experiment 3: OS-SELECT Runtime ===\n");
-    printf("n,avg_time_ms,time_per_operation_us\n");
+    printf("n,avg_time_ms,time_per_operation_us,plain_sorted_us,balanced_sorted_us\n");
 
     int size_count;
     int* sizes = generate_sizes(&size_count);
@@ -232,7 +342,11 @@ void experiment_os_select() {
         final_avg_time /= 3.0;
         double time_per_op = (final_avg_time * 1000.0) / num_operations;  // Convert to microseconds
 
-        printf("%d,%.4f,%.3f\n", n, final_avg_time, time_per_op);
+        // NoShuffle input: plain tree is a chain, red-black one stays O(log n)
+        double plain_sorted = time_select_sorted(n, 0, num_operations);
+        double balanced_sorted = time_select_sorted(n, 1, num_operations);
+
+        printf("%d,%.4f,%.3f,%.3f,%.3f\n", n, final_avg_time, time_per_op, plain_sorted, balanced_sorted);
     }
 
     free(sizes);
@@ -241,7 +355,7 @@ void experiment_os_select() {
 
 void experiment_os_rank() {
     printf("\n=== Experiment 4: OS-RANK Runtime ===\n");
-    printf("n,avg_time_ms,time_per_operation_us\n");
+    printf("n,avg_time_ms,time_per_operation_us,plain_sorted_us,balanced_sorted_us\n");
 
     int size_count;
     int* sizes = generate_sizes(&size_count);
@@ -295,15 +409,947 @@ void experiment_os_rank() {
         final_avg_time /= 3.0;
         double time_per_op = (final_avg_time * 1000.0) / num_operations;  // Convert to microseconds
 
-        printf("%d,%.4f,%.3f\n", n, final_avg_time, time_per_op);
+        double plain_sorted = time_rank_sorted(n, 0, num_operations);
+        double balanced_sorted = time_rank_sorted(n, 1, num_operations);
+
+        printf("%d,%.4f,%.3f,%.3f,%.3f\n", n, final_avg_time, time_per_op, plain_sorted, balanced_sorted);
     }
 
     free(sizes);
 }
 
-int main(void) {
+// Pointer trees vs their Eytzinger snapshots, random shape (shuffled inserts)
+void experiment_frozen_snapshot() {
+    printf("\n=== Experiment 5: Frozen Snapshot vs Pointer Lookups ===\n");
+    printf("n,tree_search_ns,frozen_search_ns,os_select_ns,frozen_select_ns,frozen_rank_ns\n");
+
+    int* queries = (int*)malloc(FROZEN_QUERIES * sizeof(int));
+
+    for (int n = FROZEN_MIN_SIZE; n <= FROZEN_MAX_SIZE; n *= 10) {
+        int* keys = generate_sequence(n);
+        fisher_yates(keys, n);
+
+        Tree* bst_tree = create_tree();
+        OSTree* os_tree = os_create_tree();
+        for (int i = 0; i < n; i++) {
+            tree_insert(bst_tree, create_node(keys[i]));
+            os_tree_insert(os_tree, os_create_node(keys[i]));
+        }
+        FrozenTree* frozen = os_tree_freeze(os_tree);
+
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            queries[q] = random_range(1, n);
+        }
+
+        // volatile sink so the lookups cannot be optimised away
+        volatile long sink = 0;
+        double start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += tree_search(bst_tree->root, queries[q])->key;
+        }
+        double tree_search_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += frozen_search(frozen, queries[q]);
+        }
+        double frozen_search_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += os_select(os_tree->root, queries[q])->key;
+        }
+        double os_select_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += frozen_select(frozen, queries[q]);
+        }
+        double frozen_select_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += frozen_rank(frozen, queries[q]);
+        }
+        double frozen_rank_ms = get_time_ms() - start;
+
+        double to_ns = 1e6 / FROZEN_QUERIES;
+        printf("%d,%.1f,%.1f,%.1f,%.1f,%.1f\n", n, tree_search_ms * to_ns, frozen_search_ms * to_ns,
+               os_select_ms * to_ns, frozen_select_ms * to_ns, frozen_rank_ms * to_ns);
+
+        frozen_destroy(frozen);
+        destroy_tree(bst_tree->root);
+        free(bst_tree);
+        os_destroy_tree(os_tree->root);
+        free(os_tree);
+        free(keys);
+    }
+
+    free(queries);
+}
+
+void experiment_compact_layout() {
+    printf("\n=== Experiment 6: Compact Index Layout vs Pointer Layout ===\n");
+    printf("n,ptr_os_bytes_per_node,compact_os_bytes_per_node,ptr_insert_ns,compact_insert_ns,"
+           "ptr_search_ns,compact_search_ns,ptr_select_ns,compact_select_ns,ptr_rank_ns,compact_rank_ns\n");
+
+    int* queries = (int*)malloc(FROZEN_QUERIES * sizeof(int));
+
+    for (int n = COMPACT_MIN_SIZE; n <= COMPACT_MAX_SIZE; n *= 10) {
+        int* keys = generate_sequence(n);
+        fisher_yates(keys, n);
+
+        // pointer OS-tree (one malloc per node) vs compact OS-tree (one array)
+        OSTree* os_tree = os_create_tree();
+        double start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            os_tree_insert(os_tree, os_create_node(keys[i]));
+        }
+        double ptr_insert_ms = get_time_ms() - start;
+
+        CompactOSTree* compact = cos_tree_create(16);   // let it grow like the pointer tree does
+        start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            cos_tree_insert(compact, keys[i]);
+        }
+        double compact_insert_ms = get_time_ms() - start;
+
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            queries[q] = random_range(1, n);
+        }
+
+        volatile long sink = 0;
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += os_tree_search(os_tree->root, queries[q])->key;
+        }
+        double ptr_search_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += cos_tree_search(compact, queries[q]);
+        }
+        double compact_search_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += os_select(os_tree->root, queries[q])->key;
+        }
+        double ptr_select_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += cos_select(compact, queries[q]);
+        }
+        double compact_select_ms = get_time_ms() - start;
+
+        // rank needs the node first, so look them all up outside the timed loop
+        OSNode** ptr_nodes = (OSNode**)malloc(FROZEN_QUERIES * sizeof(OSNode*));
+        uint32_t* handles = (uint32_t*)malloc(FROZEN_QUERIES * sizeof(uint32_t));
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            ptr_nodes[q] = os_tree_search(os_tree->root, queries[q]);
+            handles[q] = cos_tree_search(compact, queries[q]);
+        }
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += os_rank(os_tree, ptr_nodes[q]);
+        }
+        double ptr_rank_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += cos_rank(compact, handles[q]);
+        }
+        double compact_rank_ms = get_time_ms() - start;
+
+        double to_ns = 1e6 / FROZEN_QUERIES;
+        printf("%d,%zu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", n,
+               sizeof(OSNode), (double)cos_tree_bytes(compact) / n,
+               ptr_insert_ms * 1e6 / n, compact_insert_ms * 1e6 / n,
+               ptr_search_ms * to_ns, compact_search_ms * to_ns,
+               ptr_select_ms * to_ns, compact_select_ms * to_ns,
+               ptr_rank_ms * to_ns, compact_rank_ms * to_ns);
+
+        free(ptr_nodes);
+        free(handles);
+        cos_tree_destroy(compact);
+        os_destroy_tree(os_tree->root);
+        free(os_tree);
+        free(keys);
+    }
+
+    free(queries);
+}
+
+// Average number of nodes a successful tree_search visits (~ cache lines touched)
+double average_search_depth(Tree* T, int* queries, int m) {
+    long steps = 0;
+    for (int q = 0; q < m; q++) {
+        Node* x = T->root;
+        while (x != NULL && x->key != queries[q]) {
+            x = (queries[q] < x->key) ? x->left : x->right;
+            steps++;
+        }
+        steps++;
+    }
+    return (double)steps / m;
+}
+
+void experiment_bplus_tree() {
+    printf("\n=== Experiment 7: B+-Tree vs Binary Trees ===\n");
+    printf("n,bst_avg_depth,bpt_levels,bst_insert_ns,bpt_insert_ns,bpt_counted_insert_ns,"
+           "tree_search_ns,bpt_search_ns,os_select_ns,bpt_select_ns,os_rank_by_key_ns,bpt_rank_ns\n");
+
+    int* queries = (int*)malloc(FROZEN_QUERIES * sizeof(int));
+
+    for (int n = BPT_MIN_SIZE; n <= BPT_MAX_SIZE; n *= 10) {
+        int* keys = generate_sequence(n);
+        fisher_yates(keys, n);
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            queries[q] = random_range(1, n);
+        }
+        double to_ns = 1e6 / FROZEN_QUERIES;
+        volatile long sink = 0;
+
+        // BST vs plain B+-tree: insert + search
+        Tree* bst_tree = create_tree();
+        double start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            tree_insert(bst_tree, create_node(keys[i]));
+        }
+        double bst_insert_ms = get_time_ms() - start;
+
+        BPlusTree* plain = bpt_create(0);
+        start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            bpt_insert(plain, keys[i]);
+        }
+        double bpt_insert_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += tree_search(bst_tree->root, queries[q])->key;
+        }
+        double tree_search_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += bpt_key(bpt_search(plain, queries[q]));
+        }
+        double bpt_search_ms = get_time_ms() - start;
+
+        double depth = average_search_depth(bst_tree, queries, FROZEN_QUERIES);
+        int levels = plain->height + 1;
+        bpt_destroy(plain);
+        destroy_tree(bst_tree->root);
+        free(bst_tree);
+
+        // OS-tree vs counted B+-tree: select + rank
+        OSTree* os_tree = os_create_tree();
+        for (int i = 0; i < n; i++) {
+            os_tree_insert(os_tree, os_create_node(keys[i]));
+        }
+        BPlusTree* counted = bpt_create(1);
+        start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            bpt_insert(counted, keys[i]);
+        }
+        double bpt_counted_insert_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += os_select(os_tree->root, queries[q])->key;
+        }
+        double os_select_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += bpt_key(bpt_select(counted, queries[q]));
+        }
+        double bpt_select_ms = get_time_ms() - start;
+
+        // bpt_rank goes by key, so give the OS-tree the search it needs to find the node
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += os_rank(os_tree, os_tree_search(os_tree->root, queries[q]));
+        }
+        double os_rank_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += bpt_rank(counted, queries[q]);
+        }
+        double bpt_rank_ms = get_time_ms() - start;
+
+        printf("%d,%.1f,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", n, depth, levels,
+               bst_insert_ms * 1e6 / n, bpt_insert_ms * 1e6 / n, bpt_counted_insert_ms * 1e6 / n,
+               tree_search_ms * to_ns, bpt_search_ms * to_ns,
+               os_select_ms * to_ns, bpt_select_ms * to_ns,
+               os_rank_ms * to_ns, bpt_rank_ms * to_ns);
+
+        bpt_destroy(counted);
+        os_destroy_tree(os_tree->root);
+        free(os_tree);
+        free(keys);
+    }
+
+    free(queries);
+}
+
+void experiment_batched_lookups() {
+    printf("\n=== Experiment 8: Batched Lookups (batch size vs per-key latency) ===\n");
+    printf("n,batch_size,tree_search_ns,search_batch_ns,os_select_ns,select_batch_ns\n");
+
+    int* queries = (int*)malloc(FROZEN_QUERIES * sizeof(int));
+    Node** found = (Node**)malloc(BATCH_MAX * sizeof(Node*));
+    OSNode** selected = (OSNode**)malloc(BATCH_MAX * sizeof(OSNode*));
+
+    for (int n = BATCH_MIN_SIZE; n <= BATCH_MAX_SIZE; n *= 10) {
+        int* keys = generate_sequence(n);
+        fisher_yates(keys, n);
+        Tree* bst_tree = create_tree();
+        OSTree* os_tree = os_create_tree();
+        for (int i = 0; i < n; i++) {
+            tree_insert(bst_tree, create_node(keys[i]));
+            os_tree_insert(os_tree, os_create_node(keys[i]));
+        }
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            queries[q] = random_range(1, n);
+        }
+        double to_ns = 1e6 / FROZEN_QUERIES;
+        volatile long sink = 0;
+
+        // one-at-a-time baselines, same for every batch size
+        double start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += tree_search(bst_tree->root, queries[q])->key;
+        }
+        double tree_search_ms = get_time_ms() - start;
+
+        start = get_time_ms();
+        for (int q = 0; q < FROZEN_QUERIES; q++) {
+            sink += os_select(os_tree->root, queries[q])->key;
+        }
+        double os_select_ms = get_time_ms() - start;
+
+        for (int b = 1; b <= BATCH_MAX; b *= 2) {
+            start = get_time_ms();
+            for (int q = 0; q < FROZEN_QUERIES; q += b) {
+                int m = (FROZEN_QUERIES - q < b) ? FROZEN_QUERIES - q : b;
+                tree_search_batch(bst_tree, queries + q, m, found);
+                sink += found[m - 1]->key;
+            }
+            double search_batch_ms = get_time_ms() - start;
+
+            start = get_time_ms();
+            for (int q = 0; q < FROZEN_QUERIES; q += b) {
+                int m = (FROZEN_QUERIES - q < b) ? FROZEN_QUERIES - q : b;
+                os_select_batch(os_tree, queries + q, m, selected);
+                sink += selected[m - 1]->key;
+            }
+            double select_batch_ms = get_time_ms() - start;
+
+            printf("%d,%d,%.1f,%.1f,%.1f,%.1f\n", n, b, tree_search_ms * to_ns, search_batch_ms * to_ns,
+                   os_select_ms * to_ns, select_batch_ms * to_ns);
+        }
+
+        destroy_tree(bst_tree->root);
+        free(bst_tree);
+        os_destroy_tree(os_tree->root);
+        free(os_tree);
+        free(keys);
+    }
+
+    free(found);
+    free(selected);
+    free(queries);
+}
+
+void experiment_hinted_insert() {
+    printf("\n=== Experiment 9: Sorted Stream Insert (root walk vs hint) ===\n");
+    printf("n,bst_root_ns,bst_hint_ns,os_root_ns,os_hint_ns\n");
+
+    for (int n = STREAM_MIN_SIZE; n <= STREAM_MAX_SIZE; n *= 2) {
+        int* keys = generate_sequence(n);
+
+        Tree* bst_tree = create_arena_tree();
+        double start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            tree_insert(bst_tree, tree_alloc_node(bst_tree, keys[i]));
+        }
+        double bst_root_ms = get_time_ms() - start;
+
+        reset_arena_tree(bst_tree);
+        Node* last = NULL;
+        start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            Node* z = tree_alloc_node(bst_tree, keys[i]);
+            tree_insert_hint(bst_tree, last, z);
+            last = z;
+        }
+        double bst_hint_ms = get_time_ms() - start;
+        destroy_arena_tree(bst_tree);
+
+        OSTree* os_tree = os_create_arena_tree();
+        start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            os_tree_insert(os_tree, os_tree_alloc_node(os_tree, keys[i]));
+        }
+        double os_root_ms = get_time_ms() - start;
+
+        // still O(depth) per key: every ancestor's size has to go up by one
+        os_reset_arena_tree(os_tree);
+        OSNode* prev = NULL;
+        start = get_time_ms();
+        for (int i = 0; i < n; i++) {
+            OSNode* z = os_tree_alloc_node(os_tree, keys[i]);
+            os_tree_insert_hint(os_tree, prev, z);
+            prev = z;
+        }
+        double os_hint_ms = get_time_ms() - start;
+        os_destroy_arena_tree(os_tree);
+
+        printf("%d,%.1f,%.1f,%.1f,%.1f\n", n, bst_root_ms * 1e6 / n, bst_hint_ms * 1e6 / n,
+               os_root_ms * 1e6 / n, os_hint_ms * 1e6 / n);
+        free(keys);
+    }
+}
+
+// Parallel bulk load from shuffled keys (sort + build), wall clock since
+// clock() would add up the CPU time of every thread
+void experiment_parallel_build() {
+    printf("\n=== Experiment 10: Parallel Build Scaling ===\n");
+    printf("threads,n,sort_ms,bst_build_ms,os_build_ms,bst_speedup,os_speedup\n");
+
+    int n = PARALLEL_BUILD_SIZE;
+    int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < PARALLEL_MIN_THREADS) max_threads = PARALLEL_MIN_THREADS;
+    int* shuffled = generate_sequence(n);
+    fisher_yates(shuffled, n);
+    int* keys = (int*)malloc(n * sizeof(int));
+
+    double bst_base = 0, os_base = 0;
+    for (int t = 1; ; t *= 2) {                // 1, 2, 4, .. and N itself
+        if (t > max_threads) t = max_threads;
+        memcpy(keys, shuffled, n * sizeof(int));
+        double start = get_wall_time_ms();
+        parallel_sort(keys, n, t);
+        double sort_ms = get_wall_time_ms() - start;
+
+        memcpy(keys, shuffled, n * sizeof(int));
+        start = get_wall_time_ms();
+        Tree* bst_tree = tree_build_parallel(keys, n, t);
+        double bst_ms = get_wall_time_ms() - start;
+        destroy_arena_tree(bst_tree);
+
+        memcpy(keys, shuffled, n * sizeof(int));
+        start = get_wall_time_ms();
+        OSTree* os_tree = os_tree_build_parallel(keys, n, t);
+        double os_ms = get_wall_time_ms() - start;
+        os_destroy_arena_tree(os_tree);
+
+        if (t == 1) {
+            bst_base = bst_ms;
+            os_base = os_ms;
+        }
+        printf("%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f\n", t, n, sort_ms, bst_ms, os_ms, bst_base / bst_ms, os_base / os_ms);
+        if (t == max_threads) break;
+    }
+    free(keys);
+    free(shuffled);
+}
+
+// Point-in-time snapshot for a report: copy the whole OS-Tree (walk + O(n)
+// rebuild, what callers do today) vs one retain on a persistent version.
+// Then the cost it moves to the updates: ns per insert, and nodes per
+// insert that stay alive only because the snapshot still uses them.
+void experiment_snapshot_cost() {
+    printf("\n=== Experiment 11: Snapshot Cost, Full Copy vs Path Copying ===\n");
+    printf("n,full_copy_ms,full_copy_bytes,snapshot_ns,os_insert_ns,ptree_insert_ns,kept_nodes_per_update\n");
+
+    for (int n = SNAPSHOT_MIN_SIZE; n <= SNAPSHOT_MAX_SIZE; n *= 10) {
+        int* keys = generate_sequence(n);
+        for (int i = 0; i < n; i++) keys[i] *= 2;          // odd keys stay free for the updates
+        int* upd = (int*)malloc(SNAPSHOT_UPDATES * sizeof(int));
+        for (int i = 0; i < SNAPSHOT_UPDATES; i++) upd[i] = 2 * (rand() % n) + 1;
+
+        OSTree* T = os_tree_build_from_sorted(keys, n);
+        int* walk = (int*)malloc(n * sizeof(int));
+        double start = get_time_ms();
+        OSTreeCursor c;
+        int m = 0;
+        for (OSNode* x = os_tree_cursor_begin(&c, T); x != NULL; x = os_tree_cursor_next(&c)) walk[m++] = x->key;
+        OSTree* copy = os_tree_build_from_sorted(walk, m);
+        double copy_ms = get_time_ms() - start;
+        os_destroy_arena_tree(copy);
+
+        start = get_time_ms();
+        for (int i = 0; i < SNAPSHOT_UPDATES; i++) {
+            OSNode* z = os_tree_alloc_node(T, upd[i]);
+            os_tree_insert(T, z);
+        }
+        double os_ns = (get_time_ms() - start) * 1e6 / SNAPSHOT_UPDATES;
+        os_destroy_arena_tree(T);
+
+        OSPNode* v = os_ptree_build_from_sorted(keys, n);
+        int reps = 1000000;
+        start = get_time_ms();
+        for (int i = 0; i < reps; i++) {
+            OSPNode* snap = os_ptree_retain(v);
+            os_ptree_release(snap);
+        }
+        double snap_ns = (get_time_ms() - start) * 1e6 / reps;
+
+        OSPNode* snap = os_ptree_retain(v);                 // held through the updates
+        long before = os_ptree_live_nodes();
+        start = get_time_ms();
+        for (int i = 0; i < SNAPSHOT_UPDATES; i++) {
+            OSPNode* next = os_ptree_insert(v, upd[i]);
+            os_ptree_release(v);
+            v = next;
+        }
+        double p_ns = (get_time_ms() - start) * 1e6 / SNAPSHOT_UPDATES;
+        double per_update = (double)(os_ptree_live_nodes() - before) / SNAPSHOT_UPDATES;
+        os_ptree_release(snap);
+        os_ptree_release(v);
+
+        printf("%d,%.3f,%zu,%.1f,%.1f,%.1f,%.1f\n", n, copy_ms, (size_t)n * sizeof(OSNode), snap_ns, os_ns, p_ns,
+               per_update);
+        free(walk);
+        free(upd);
+        free(keys);
+    }
+}
+
+// Service startup: rebuild through tree_insert/os_tree_insert from shuffled
+// keys (what every run does today) vs tree_image_open on an image written
+// once. Wall clock, since the image side is I/O and page faults. The image
+// was just written, so its pages are in the page cache: a cold start from
+// disk adds reading image_mb once, still sequentially.
+// The normal run uses IMAGE_SIZE; the full size is behind --startup-bench.
+void experiment_image_startup(int n) {
+    printf("\n=== Experiment 12: Startup, Rebuild vs Memory-Mapped Image ===\n");
+    printf("tree,n,rebuild_ms,image_write_ms,image_mb,open_ms,first_queries_ms,queries_ok\n");
+
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    int* probe = (int*)malloc(IMAGE_QUERIES * sizeof(int));
+    for (int i = 0; i < IMAGE_QUERIES; i++) probe[i] = 1 + rand() % n;
+
+    for (int os = 0; os <= 1; os++) {
+        double start = get_wall_time_ms();
+        Tree* T = NULL;
+        OSTree* OT = NULL;
+        if (os) {
+            OT = os_create_tree();
+            for (int i = 0; i < n; i++) os_tree_insert(OT, os_create_node(keys[i]));
+        }
+        else {
+            T = create_tree();
+            for (int i = 0; i < n; i++) tree_insert(T, create_node(keys[i]));
+        }
+        double rebuild_ms = get_wall_time_ms() - start;
+
+        start = get_wall_time_ms();
+        int rc = os ? os_tree_image_write(OT, IMAGE_PATH) : tree_image_write(T, IMAGE_PATH);
+        double write_ms = get_wall_time_ms() - start;
+        if (os) {
+            os_destroy_tree_parallel(OT->root, 1);
+            free(OT);
+        }
+        else {
+            destroy_tree_parallel(T->root, 1);
+            free(T);
+        }
+        if (rc != 0) {
+            printf("%s,%d,%.0f,failed to write %s\n", os ? "os_tree" : "bst", n, rebuild_ms, IMAGE_PATH);
+            continue;
+        }
+
+        start = get_wall_time_ms();
+        TreeImage* I = tree_image_open(IMAGE_PATH);
+        double open_ms = get_wall_time_ms() - start;
+        int ok = (I != NULL);
+        start = get_wall_time_ms();
+        for (int i = 0; i < IMAGE_QUERIES && ok; i++) {
+            if (os) {
+                uint32_t x = image_os_select(I, probe[i]);       // keys are 1..n: select(i) = i
+                ok = (x != 0 && image_key(I, x) == probe[i] && image_os_rank(I, probe[i]) == probe[i]);
+            }
+            else {
+                ok = (image_search(I, probe[i]) != 0);
+            }
+        }
+        double query_ms = get_wall_time_ms() - start;
+        printf("%s,%d,%.0f,%.0f,%.1f,%.3f,%.3f,%s\n", os ? "os_tree" : "bst", n, rebuild_ms, write_ms,
+               I ? I->bytes / 1e6 : 0.0, open_ms, query_ms, ok ? "yes" : "no");
+        fflush(stdout);
+        tree_image_close(I);
+        unlink(IMAGE_PATH);
+    }
+    free(probe);
+    free(keys);
+}
+
+// Callers holding only a key: os_tree_search + os_rank (down, then back up
+// through parents) vs one os_rank_of_key descent. Range counts: walking
+// successors from the first key vs os_count_range, ranges of n/100 keys.
+void experiment_rank_by_key() {
+    printf("\n=== Experiment 13: Rank by Key and Range Count ===\n");
+    printf("n,search_rank_ns,rank_of_key_ns,range_width,scan_count_ns,count_range_ns,counts_equal\n");
+
+    int* qk = (int*)malloc(KEYRANK_QUERIES * sizeof(int));
+    for (int n = KEYRANK_MIN_SIZE; n <= KEYRANK_MAX_SIZE; n *= 10) {
+        int* keys = generate_sequence(n);
+        fisher_yates(keys, n);
+        OSTree* T = os_create_arena_tree();
+        for (int i = 0; i < n; i++) {
+            os_tree_insert(T, os_tree_alloc_node(T, keys[i]));
+        }
+        for (int i = 0; i < KEYRANK_QUERIES; i++) qk[i] = 1 + rand() % n;
+
+        long sum = 0;
+        double start = get_time_ms();
+        for (int i = 0; i < KEYRANK_QUERIES; i++) {
+            sum += os_rank(T, os_tree_search(T->root, qk[i]));
+        }
+        double two_pass_ms = get_time_ms() - start;
+        start = get_time_ms();
+        for (int i = 0; i < KEYRANK_QUERIES; i++) {
+            sum -= os_rank_of_key(T, qk[i]);
+        }
+        double one_pass_ms = get_time_ms() - start;
+
+        int width = n / 100;
+        int ranges = KEYRANK_QUERIES / 100;
+        long scanned = 0, counted = 0;
+        start = get_time_ms();
+        for (int i = 0; i < ranges; i++) {
+            int lo = qk[i], hi = qk[i] + width - 1;
+            OSNode* x = os_tree_search(T->root, lo);   // keys are 1..n, so lo is there
+            while (x != NULL && x->key <= hi) {
+                scanned++;
+                x = os_tree_successor(x);
+            }
+        }
+        double scan_ms = get_time_ms() - start;
+        start = get_time_ms();
+        for (int i = 0; i < ranges; i++) {
+            counted += os_count_range(T, qk[i], qk[i] + width - 1);
+        }
+        double count_ms = get_time_ms() - start;
+
+        printf("%d,%.1f,%.1f,%d,%.1f,%.1f,%s\n", n, two_pass_ms * 1e6 / KEYRANK_QUERIES,
+               one_pass_ms * 1e6 / KEYRANK_QUERIES, width, scan_ms * 1e6 / ranges, count_ms * 1e6 / ranges,
+               (sum == 0 && scanned == counted) ? "yes" : "no");
+        os_destroy_arena_tree(T);
+        free(keys);
+    }
+    free(qk);
+}
+
+// Dashboard quantiles: m evenly spaced ranks (sorted, like p50/p90/p99..)
+// answered by m os_select calls, by os_select_batch, and by one
+// os_select_many descent that shares the levels above the split points.
+void experiment_multi_select() {
+    printf("\n=== Experiment 14: Multi-Select, Shared Descent vs Independent Selects ===\n");
+    printf("n,m,independent_ns,batch_ns,many_ns,speedup_vs_independent,same_nodes\n");
+
+    int n = MULTI_SIZE;
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    OSTree* T = os_create_arena_tree();
+    for (int i = 0; i < n; i++) {
+        os_rb_tree_insert(T, os_tree_alloc_node(T, keys[i]));
+    }
+    free(keys);
+
+    int* ranks = (int*)malloc(MULTI_MAX_M * sizeof(int));
+    OSNode** a = (OSNode**)malloc(MULTI_MAX_M * sizeof(OSNode*));
+    OSNode** b = (OSNode**)malloc(MULTI_MAX_M * sizeof(OSNode*));
+    OSNode** c = (OSNode**)malloc(MULTI_MAX_M * sizeof(OSNode*));
+    for (int m = 1; m <= MULTI_MAX_M; m *= 4) {
+        for (int j = 0; j < m; j++) ranks[j] = (int)((long)(j + 1) * n / (m + 1));
+        int reps = (MULTI_WORK / m > 0) ? MULTI_WORK / m : 1;
+
+        double start = get_time_ms();
+        for (int r = 0; r < reps; r++) {
+            for (int j = 0; j < m; j++) a[j] = os_select(T->root, ranks[j]);
+        }
+        double indep_ms = get_time_ms() - start;
+        start = get_time_ms();
+        for (int r = 0; r < reps; r++) os_select_batch(T, ranks, m, b);
+        double batch_ms = get_time_ms() - start;
+        start = get_time_ms();
+        for (int r = 0; r < reps; r++) os_select_many(T->root, ranks, m, c);
+        double many_ms = get_time_ms() - start;
+
+        int same = 1;
+        for (int j = 0; j < m; j++) same &= (a[j] == b[j] && a[j] == c[j]);
+        double per = 1e6 / ((double)reps * m);
+        printf("%d,%d,%.1f,%.1f,%.1f,%.2f,%s\n", n, m, indep_ms * per, batch_ms * per, many_ms * per,
+               many_ms > 0 ? indep_ms / many_ms : 0.0, same ? "yes" : "no");
+    }
+    free(ranks);
+    free(a);
+    free(b);
+    free(c);
+    os_destroy_arena_tree(T);
+}
+
+// Dense keys 1..n (what generate_sequence gives): the pointer OS-trees vs
+// the Fenwick array order_index_create picks for such a range. Same
+// shuffled inserts, random selects and ranks, then half the keys deleted.
+void experiment_fenwick() {
+    printf("\n=== Experiment 15: Fenwick Array vs Pointer OS-Tree on Dense Keys ===\n");
+    printf("engine,n,bytes_per_key,insert_ns,select_ns,rank_ns,delete_ns,answers_match\n");
+
+    int* qr = (int*)malloc(FENWICK_QUERIES * sizeof(int));
+    int* qk = (int*)malloc(FENWICK_QUERIES * sizeof(int));
+    int* ref = (int*)malloc(FENWICK_QUERIES * sizeof(int));
+    for (int n = FENWICK_MIN_SIZE; n <= FENWICK_MAX_SIZE; n *= 10) {
+        int* keys = generate_sequence(n);
+        fisher_yates(keys, n);
+        for (int i = 0; i < FENWICK_QUERIES; i++) {
+            qr[i] = 1 + rand() % n;
+            qk[i] = 1 + rand() % n;
+        }
+        int half = n / 2;
+
+        for (int e = 0; e < 3; e++) {
+            const char* name = (e == 0) ? "os_tree" : (e == 1) ? "os_rb_tree" : "fenwick";
+            OSTree* T = NULL;
+            OrderIndex* I = NULL;
+            OSNode** nodes = NULL;
+            double bytes;
+            long sum = 0;
+            int match = 1;
+
+            double start = get_time_ms();
+            if (e < 2) {
+                T = os_create_arena_tree();
+                nodes = (OSNode**)malloc(n * sizeof(OSNode*));   // delete needs the nodes
+                for (int i = 0; i < n; i++) {
+                    nodes[i] = os_tree_alloc_node(T, keys[i]);
+                    if (e == 0) os_tree_insert(T, nodes[i]);
+                    else os_rb_tree_insert(T, nodes[i]);
+                }
+                bytes = sizeof(OSNode);
+            }
+            else {
+                I = order_index_create(1, n, n);
+                for (int i = 0; i < n; i++) order_index_insert(I, keys[i]);
+                bytes = (I->kind == ORDER_INDEX_FENWICK) ? 4.0 * (n + 1) / n : sizeof(OSNode);
+            }
+            double insert_ms = get_time_ms() - start;
+
+            start = get_time_ms();
+            if (e < 2) {
+                for (int i = 0; i < FENWICK_QUERIES; i++) sum += os_select(T->root, qr[i])->key;
+            }
+            else {
+                for (int i = 0; i < FENWICK_QUERIES; i++) {
+                    int key = 0;
+                    order_index_select(I, qr[i], &key);
+                    sum += key;
+                    if (key != qr[i]) match = 0;        // keys are 1..n, so rank i is key i
+                }
+            }
+            double select_ms = get_time_ms() - start;
+
+            start = get_time_ms();
+            for (int i = 0; i < FENWICK_QUERIES; i++) {
+                ref[i] = (e < 2) ? os_rank_of_key(T, qk[i]) : order_index_rank(I, qk[i]);
+            }
+            double rank_ms = get_time_ms() - start;
+            for (int i = 0; i < FENWICK_QUERIES; i++) match &= (ref[i] == qk[i]);
+
+            start = get_time_ms();
+            if (e == 0) {
+                for (int i = 0; i < half; i++) os_tree_delete(T, nodes[i]);
+            }
+            else if (e == 1) {
+                for (int i = 0; i < half; i++) os_rb_tree_delete(T, nodes[i]);
+            }
+            else {
+                for (int i = 0; i < half; i++) order_index_delete(I, keys[i]);
+            }
+            double delete_ms = get_time_ms() - start;
+            match &= ((e < 2) ? os_get_size(T->root) : order_index_size(I)) == n - half;
+
+            printf("%s,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%s\n", name, n, bytes, insert_ms * 1e6 / n,
+                   select_ms * 1e6 / FENWICK_QUERIES, rank_ms * 1e6 / FENWICK_QUERIES, delete_ms * 1e6 / half,
+                   (match && sum > 0) ? "yes" : "no");
+            if (T != NULL) os_destroy_arena_tree(T);
+            if (I != NULL) order_index_destroy(I);
+            free(nodes);
+        }
+        free(keys);
+    }
+    free(qr);
+    free(qk);
+    free(ref);
+}
+
+// Rolling percentiles: fill a w-sample window, then time WINDOW_TICKS
+// pushes (each expires the oldest sample), half as plain pushes and half
+// with a p50 and p99 read after every push. The malloc column is the first
+// half again on a copy of the window that frees the expired node and
+// allocates a new one instead of reusing it; its median at the end has to
+// match the operator's.
+void experiment_sliding_window() {
+    printf("\n=== Experiment 16: Sliding-Window Quantiles ===\n");
+    printf("window,ticks,push_per_sec,push_p50_p99_per_sec,malloc_free_push_per_sec,p50_matches\n");
+
+    int half = WINDOW_TICKS / 2;
+    int* stream = (int*)malloc(WINDOW_TICKS * sizeof(int));
+    for (int i = 0; i < WINDOW_TICKS; i++) stream[i] = rand();
+    for (int w = WINDOW_MIN; w <= WINDOW_MAX; w *= 10) {
+        SlidingWindow* W = window_create(w);
+        for (int i = 0; i < w; i++) window_push(W, rand());
+
+        OSTree* T = os_create_tree();
+        OSNode** ring = (OSNode**)malloc(w * sizeof(OSNode*));
+        for (int i = 0; i < w; i++) {
+            ring[i] = os_create_node(W->ring[(W->head + i) % w].key);
+            os_rb_tree_insert(T, ring[i]);
+        }
+
+        double start = get_time_ms();
+        for (int i = 0; i < half; i++) window_push(W, stream[i]);
+        double push_ms = get_time_ms() - start;
+        int mid = 0;
+        window_quantile(W, 0.5, &mid);
+
+        int head = 0;
+        start = get_time_ms();
+        for (int i = 0; i < half; i++) {
+            os_rb_tree_delete(T, ring[head]);
+            free(ring[head]);
+            ring[head] = os_create_node(stream[i]);
+            os_rb_tree_insert(T, ring[head]);
+            head = (head + 1 == w) ? 0 : head + 1;
+        }
+        double malloc_ms = get_time_ms() - start;
+        int matches = (os_select(T->root, (w + 1) / 2)->key == mid);
+
+        long sink = 0;
+        start = get_time_ms();
+        for (int i = half; i < WINDOW_TICKS; i++) {
+            int p50, p99;
+            window_push(W, stream[i]);
+            window_quantile(W, 0.5, &p50);
+            window_quantile(W, 0.99, &p99);
+            sink += p50 + p99;
+        }
+        double query_ms = get_time_ms() - start;
+
+        printf("%d,%d,%.0f,%.0f,%.0f,%s\n", w, WINDOW_TICKS, half / push_ms * 1000.0, half / query_ms * 1000.0,
+               half / malloc_ms * 1000.0, (matches && sink != 0) ? "yes" : "no");
+        os_destroy_tree(T->root);
+        free(T);
+        free(ring);
+        window_destroy(W);
+    }
+    free(stream);
+}
+
+// --keys / --keys64: OS-Tree build, select and rank on a captured key file,
+// same rules as run_key_file_experiment in bst_experiments.c
+int run_key_file_experiment(const char* path, int width) {
+    KeyStream* S = key_stream_open(path, width);
+    if (S == NULL) {
+        printf("Cannot read %s as packed %d-bit keys\n", path, 8 * width);
+        return 1;
+    }
+    printf("Key file: %s (%zu keys, %d-bit)\n", path, S->count, 8 * width);
+    printf("\n=== Key File Ingestion ===\n");
+    printf("method,n,ms,height,skipped\n");
+
+    OSTree* R = os_create_arena_tree();
+    double start = get_time_ms();
+    size_t got;
+    const int* keys;
+    long n = 0;
+    while ((keys = key_stream_next(S, 0, &got)) != NULL) {
+        for (size_t i = 0; i < got; i++) os_rb_tree_insert(R, os_tree_alloc_node(R, keys[i]));
+        n += (long)got;
+    }
+    printf("os_rb_tree_insert,%ld,%.2f,%d,%zu\n", n, get_time_ms() - start, os_tree_height(R->root), S->skipped);
+    fflush(stdout);
+
+    key_stream_rewind(S);
+    OSTree* T = NULL;
+    if (key_stream_is_sorted(S) && n > MAX_SIZE) {
+        printf("os_tree_insert_stream,%ld,sorted_skipped,,\n", n);
+    }
+    else {
+        T = os_create_arena_tree();
+        start = get_time_ms();
+        os_tree_insert_stream(T, S);
+        printf("os_tree_insert_stream,%ld,%.2f,%d,%zu\n", n, get_time_ms() - start, os_tree_height(T->root), S->skipped);
+    }
+    fflush(stdout);
+
+    key_stream_rewind(S);
+    start = get_time_ms();
+    OSTree* B = os_tree_build_from_stream(S);
+    if (B != NULL) {
+        printf("os_tree_build_from_stream,%ld,%.2f,%d,%zu\n", n, get_time_ms() - start, os_tree_height(B->root), S->skipped);
+        os_destroy_arena_tree(B);
+    }
+    else {
+        printf("os_tree_build_from_stream,%ld,%s,,%zu\n", n, S->skipped ? "keys_dropped" : "unsorted", S->skipped);
+    }
+
+    // random ranks for select, then os_rank of each node found
+    printf("\n=== Key File Select/Rank ===\n");
+    printf("tree,n,select_ns,rank_ns,rank_of_select_exact\n");
+    int queries = (n < FROZEN_QUERIES) ? (int)n : FROZEN_QUERIES;
+    int* ranks = (int*)malloc((queries > 0 ? queries : 1) * sizeof(int));
+    OSNode** found = (OSNode**)malloc((queries > 0 ? queries : 1) * sizeof(OSNode*));
+    for (int i = 0; i < queries; i++) ranks[i] = 1 + rand() % (int)n;
+    OSTree* trees[2] = {R, T};
+    const char* names[2] = {"os_rb_tree", "os_tree"};
+    for (int t = 0; t < 2 && trees[t] != NULL; t++) {
+        if (queries > 0) {
+            start = get_time_ms();
+            for (int i = 0; i < queries; i++) found[i] = os_select(trees[t]->root, ranks[i]);
+            double sel_ns = (get_time_ms() - start) * 1e6 / queries;
+            int exact = 1;
+            start = get_time_ms();
+            for (int i = 0; i < queries; i++) exact &= (os_rank(trees[t], found[i]) == ranks[i]);
+            double rank_ns = (get_time_ms() - start) * 1e6 / queries;
+            printf("%s,%ld,%.1f,%.1f,%s\n", names[t], n, sel_ns, rank_ns, exact ? "yes" : "no");
+        }
+        os_destroy_arena_tree(trees[t]);
+    }
+    free(ranks);
+    free(found);
+    key_stream_close(S);
+    return 0;
+}
+
+int main(int argc, char** argv) {
     srand(time(NULL));
 
+    if (argc == 2 && strcmp(argv[1], "--startup-bench") == 0) {
+        experiment_image_startup(IMAGE_BENCH_SIZE);
+        return 0;
+    }
+
+    const char* key_path;
+    int key_width;
+    int args = key_stream_parse_args(argc, argv, &key_path, &key_width);
+    if (args < 0) {
+        printf("usage: %s [--keys FILE | --keys64 FILE | --startup-bench]\n", argv[0]);
+        return 1;
+    }
+    if (args > 0) {
+        return run_key_file_experiment(key_path, key_width);
+    }
+
     printf("Order-Statistic Tree Experiments (Part B)\n");
     printf("==========================================\n");
     printf("Comparing OS-Tree vs BST performance\n");
@@ -317,13 +1363,37 @@ int main(void) {
     experiment_delete_comparison();
     experiment_os_select();
     experiment_os_rank();
+    experiment_frozen_snapshot();
+    experiment_compact_layout();
+    experiment_bplus_tree();
+    experiment_batched_lookups();
+    experiment_hinted_insert();
+    experiment_parallel_build();
+    experiment_snapshot_cost();
+    experiment_image_startup(IMAGE_SIZE);
+    experiment_rank_by_key();
+    experiment_multi_select();
+    experiment_fenwick();
+    experiment_sliding_window();
 
     printf("\nAll OS-Tree experiments completed!\n");
     printf("Results can be plotted to show:\n");
     printf("  1. OS-Tree INSERT overhead vs BST\n");
     printf("  2. OS-Tree DELETE overhead vs BST\n");
-    printf("  3. OS-SELECT runtime (should be O(log n))\n");
-    printf("  4. OS-RANK runtime (should be O(log n))\n");
+    printf("  3. OS-SELECT runtime (should be O(log n), O(n) for a plain tree on sorted keys)\n");
+    printf("  4. OS-RANK runtime (should be O(log n), O(n) for a plain tree on sorted keys)\n");
+    printf("  5. Frozen Eytzinger snapshot vs pointer search/select (ns per lookup)\n");
+    printf("  6. Compact 32-bit index nodes vs pointer nodes (bytes per node, ns per op)\n");
+    printf("  7. Cache-line B+-tree vs BST/OS-Tree search/select/rank (ns per op, levels touched)\n");
+    printf("  8. Batched, prefetching search/select: per-key latency vs batch size\n");
+    printf("  9. Sorted-stream insert: walk from the root vs hinted insert\n");
+    printf(" 10. Parallel sort + bulk load: wall time and speedup vs thread count\n");
+    printf(" 11. Snapshot cost: full copy (ms, bytes) vs persistent retain (ns), and what updates pay for it\n");
+    printf(" 12. Startup: rebuild by inserts vs opening a memory-mapped image (ms)\n");
+    printf(" 13. Rank by key and range counts: one descent vs search + climb / successor scan (ns)\n");
+    printf(" 14. Multi-select: ns per quantile, m selects vs one shared os_select_many descent\n");
+    printf(" 15. Dense keys: Fenwick array vs pointer OS-trees (bytes per key, ns per op)\n");
+    printf(" 16. Sliding-window quantiles: samples/s for w = 1e3..1e7, recycled nodes vs malloc/free\n");
 
     return 0;
 }
@@ -0,0 +1,28 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// One chunk of memory that the arena carves nodes out of
+typedef struct ArenaSlab {
+    struct ArenaSlab* next;  // older slab (list is newest first)
+    size_t capacity;         // number of objects this slab holds
+} ArenaSlab;                 // objects follow the header directly
+
+// Fixed-size object pool: bump allocation out of slabs + free list for reuse
+typedef struct Arena {
+    size_t obj_size;      // bytes per object (at least a pointer for the free list)
+    size_t next_capacity; // objects in the next slab we allocate (doubles up to a cap)
+    ArenaSlab* slabs;     // all slabs, newest first
+    size_t used;          // objects handed out from the newest slab
+    void* free_list;      // objects given back with arena_free
+} Arena;
+
+Arena* arena_create(size_t obj_size, size_t first_capacity); // empty arena
+void* arena_alloc(Arena* A);            // O(1) object from free list or newest slab
+void* arena_alloc_block(Arena* A, size_t count); // count objects back to back in one slab
+void arena_free(Arena* A, void* obj);   // O(1) push object onto free list
+void arena_reset(Arena* A);             // drop every object at once, keep newest slab
+void arena_destroy(Arena* A);           // give all slabs back to the system
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef AUG_TREE_H
+#define AUG_TREE_H
+
+// Red-black tree of (key, value) pairs with four subtree aggregates:
+// node count, sum of value, min and max of value. Built on augment.h like
+// the OS-tree, so every rotation and delete keeps all four right.
+// Weighted select answers "the key at 95% of the cumulative byte volume";
+// values are taken to be >= 0 there.
+
+struct Arena;
+
+typedef struct AugNode {
+    int key;
+    unsigned char color;        // red/black
+    long long value;            // e.g. bytes of the event
+    struct AugNode* left;
+    struct AugNode* right;
+    struct AugNode* p;
+    int size;                   // aggregates over the subtree
+    long long sum;
+    long long vmin;
+    long long vmax;
+} AugNode;
+
+typedef struct AugTree {
+    AugNode* root;
+    struct Arena* arena;
+} AugTree;
+
+AugTree* aug_tree_create(void);
+void aug_tree_destroy(AugTree* T);
+
+AugNode* aug_tree_insert(AugTree* T, int key, long long value);   // duplicates kept
+void aug_tree_delete(AugTree* T, AugNode* z);                      // z goes back to the arena
+void aug_tree_set_value(AugTree* T, AugNode* x, long long value);  // aggregates fixed up to the root
+
+AugNode* aug_select(AugTree* T, int i);                // i-th smallest key, NULL out of range
+AugNode* aug_select_weight(AugTree* T, long long w);   // first node where the running sum of value reaches w
+long long aug_total(AugTree* T);                       // sum of every value
+
+// count, sum, min and max of value over keys in [lo, hi] into *out (key,
+// color and links left alone), O(height). 0 if the range is empty.
+int aug_tree_range(AugTree* T, int lo, int hi, AugNode* out);
+
+// Test helper: 1 if colours and all four aggregates check out
+int aug_tree_validate(AugTree* T);
+
+#endif
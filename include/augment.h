@@ -0,0 +1,409 @@
+// Augmented BST / red-black tree code, specialised at compile time.
+//
+// No include guard on purpose: define the parameters below, include this
+// file, and the including .c gets its own static inline copy of the tree
+// code for that node type. Every aggregate update is written out as plain
+// field arithmetic for that struct, so there is no callback per node and
+// a lone size field compiles to the same size++ the hand-written tree had.
+//
+//   AUG_NODE       node struct with key, color, left, right, p and the fields below
+//   AUG_TREE       tree struct with a root
+//   AUG_PREFIX     prefix of the generated names (os_aug -> os_aug_insert, ...)
+//   AUG_FIELDS(X)  one X(field, LEAF, COMBINE, UNDO) per aggregate. LEAF(n)
+//                  is the node's own contribution, COMBINE(a, b) must be
+//                  associative and commutative (AUG_SUM, AUG_MIN, AUG_MAX).
+//                  UNDO says how an ancestor gets over losing a node:
+//                  AUG_SUB takes the LEAF back out (sums), AUG_RECOUNT
+//                  rebuilds the field from the children (min/max)
+//
+// Commutative because insert folds the new node into every ancestor on the
+// way down instead of recounting them on the way back up. AUG_SUB is there
+// for the same reason on delete: a recount reads both children of every
+// ancestor, which are mostly cache misses.
+//
+// Generated: _pull, _pull_up, _add_up, _consistent, _transplant, _min,
+// _left_rotate, _right_rotate, _insert/_delete (plain BST),
+// _rb_insert/_rb_delete (CLRS 13 + 14.2) and _range (fold over [lo, hi]).
+//
+// Example (include/os_aug.h): the OS-tree is one size field,
+//   #define AUG_FIELDS(X) X(size, AUG_ONE, AUG_SUM, AUG_SUB)
+
+#ifndef AUGMENT_COMMON
+#define AUGMENT_COMMON
+
+#include <stddef.h>
+
+#define AUG_RED 0
+#define AUG_BLACK 1
+
+#define AUG_SUM(a, b) ((a) + (b))
+#define AUG_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define AUG_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define AUG_ONE(n) 1                        // LEAF of a size field
+
+// UNDO choices, applied to node dst that lost node gone from its subtree
+#define AUG_SUB(dst, f, gone, LEAF, COMB) dst->f = dst->f - LEAF(gone);
+#define AUG_RECOUNT(dst, f, gone, LEAF, COMB)                      \
+    dst->f = LEAF(dst);                                            \
+    if (dst->left != NULL) dst->f = COMB(dst->left->f, dst->f);    \
+    if (dst->right != NULL) dst->f = COMB(dst->f, dst->right->f);
+
+#define AUG_CAT_(a, b) a##_##b
+#define AUG_CAT(a, b) AUG_CAT_(a, b)
+
+// Per-field statements, expanded through AUG_FIELDS. They use fixed local
+// names: x (node being recounted), a/z (ancestor, new node), y (rotation),
+// t (recount copy), acc/n/s (range fold).
+#define AUG_PULL_FIELD(f, LEAF, COMB, UNDO) AUG_RECOUNT(x, f, x, LEAF, COMB)
+#define AUG_UNDO_FIELD(f, LEAF, COMB, UNDO) UNDO(a, f, gone, LEAF, COMB)
+#define AUG_SET_LEAF(f, LEAF, COMB, UNDO) z->f = LEAF(z);
+#define AUG_FOLD_IN(f, LEAF, COMB, UNDO) a->f = COMB(a->f, LEAF(z));
+#define AUG_TAKE_OVER(f, LEAF, COMB, UNDO) y->f = x->f;
+#define AUG_SAME(f, LEAF, COMB, UNDO) ok &= (t.f == x->f);
+#define AUG_ACC_NODE(f, LEAF, COMB, UNDO) acc->f = any ? COMB(acc->f, LEAF(n)) : LEAF(n);
+#define AUG_ACC_TREE(f, LEAF, COMB, UNDO) acc->f = any ? COMB(acc->f, s->f) : s->f;
+
+#endif
+
+#define AUG_FN(name) AUG_CAT(AUG_PREFIX, name)
+
+// x's aggregates from its own LEAF and its children's
+static inline void AUG_FN(pull)(AUG_NODE* x){
+    AUG_FIELDS(AUG_PULL_FIELD)
+}
+
+// x and every ancestor recounted, after x's subtree changed shape
+static inline void AUG_FN(pull_up)(AUG_NODE* x){
+    for (; x != NULL; x = x->p)
+        AUG_FN(pull)(x);
+}
+
+// z was just hung below a: fold its LEAF into a and everything above
+static inline void AUG_FN(add_up)(AUG_NODE* a, AUG_NODE* z){
+    (void)z;    // a constant LEAF such as AUG_ONE never reads it
+    for (; a != NULL; a = a->p){
+        AUG_FIELDS(AUG_FOLD_IN)
+    }
+}
+
+// gone left the subtrees of a, a->p, .. up to but not including stop
+static inline void AUG_FN(remove_up)(AUG_NODE* a, AUG_NODE* stop, AUG_NODE* gone){
+    (void)gone;
+    for (; a != stop; a = a->p){
+        AUG_FIELDS(AUG_UNDO_FIELD)
+    }
+}
+
+// 1 if x's fields match a recount from its children (for validators)
+static inline int AUG_FN(consistent)(AUG_NODE* x){
+    AUG_NODE t = *x;
+    int ok = 1;
+    AUG_FN(pull)(&t);
+    AUG_FIELDS(AUG_SAME)
+    return ok;
+}
+
+static inline void AUG_FN(transplant)(AUG_TREE* T, AUG_NODE* u, AUG_NODE* v){
+    if (u->p == NULL)
+        T->root = v;
+    else if (u == u->p->left)
+        u->p->left = v;
+    else
+        u->p->right = v;
+    if (v != NULL)
+        v->p = u->p;
+}
+
+static inline AUG_NODE* AUG_FN(min)(AUG_NODE* x){
+    while (x->left != NULL)
+        x = x->left;
+    return x;
+}
+
+// Rotations: y takes over what x covered, x is recounted (CLRS 14.2)
+static inline void AUG_FN(left_rotate)(AUG_TREE* T, AUG_NODE* x){
+    AUG_NODE* y = x->right;
+    x->right = y->left;
+    if (y->left != NULL)
+        y->left->p = x;
+    y->p = x->p;
+    if (x->p == NULL)
+        T->root = y;
+    else if (x == x->p->left)
+        x->p->left = y;
+    else
+        x->p->right = y;
+    y->left = x;
+    x->p = y;
+    AUG_FIELDS(AUG_TAKE_OVER)
+    AUG_FN(pull)(x);
+}
+
+static inline void AUG_FN(right_rotate)(AUG_TREE* T, AUG_NODE* x){
+    AUG_NODE* y = x->left;
+    x->left = y->right;
+    if (y->right != NULL)
+        y->right->p = x;
+    y->p = x->p;
+    if (x->p == NULL)
+        T->root = y;
+    else if (x == x->p->right)
+        x->p->right = y;
+    else
+        x->p->left = y;
+    y->right = x;
+    x->p = y;
+    AUG_FIELDS(AUG_TAKE_OVER)
+    AUG_FN(pull)(x);
+}
+
+// Plain BST insert, z a fresh leaf; every node on the path takes in z
+static inline void AUG_FN(insert)(AUG_TREE* T, AUG_NODE* z){
+    AUG_NODE* y = NULL;
+    AUG_NODE* a = T->root;
+    AUG_FIELDS(AUG_SET_LEAF)
+    while (a != NULL){
+        y = a;
+        AUG_FIELDS(AUG_FOLD_IN)
+        if (z->key < a->key)
+            a = a->left;
+        else
+            a = a->right;
+    }
+    z->p = y;
+    if (y == NULL)
+        T->root = z;
+    else if (z->key < y->key)
+        y->left = z;
+    else
+        y->right = z;
+}
+
+// CLRS delete, then the aggregates fixed from the lowest parent that
+// changed up to the root: below the successor's new spot they lost the
+// successor, from there up they lost z. *out_x / *out_xp get what moved
+// into the vacated spot and its parent (for the RB fixup). Returns the
+// node that left its spot: z, or z's successor.
+static inline AUG_NODE* AUG_FN(unlink)(AUG_TREE* T, AUG_NODE* z, AUG_NODE** out_xp, AUG_NODE** out_x){
+    AUG_NODE* y = z;
+    if (z->left == NULL){
+        *out_x = z->right;
+        *out_xp = z->p;
+        AUG_FN(transplant)(T, z, z->right);
+    }
+    else if (z->right == NULL){
+        *out_x = z->left;
+        *out_xp = z->p;
+        AUG_FN(transplant)(T, z, z->left);
+    }
+    else{
+        y = AUG_FN(min)(z->right);
+        *out_x = y->right;
+        if (y->p == z){
+            *out_xp = y;
+        }
+        else{
+            *out_xp = y->p;
+            AUG_FN(transplant)(T, y, y->right);
+            y->right = z->right;
+            y->right->p = y;
+        }
+        AUG_FN(transplant)(T, z, y);
+        y->left = z->left;
+        y->left->p = y;
+    }
+    if (y != z){
+        AUG_FN(remove_up)(*out_xp, y, y);
+        AUG_NODE* x = z;    // y takes over z's fields, then loses z like the rest
+        AUG_FIELDS(AUG_TAKE_OVER)
+        AUG_FN(remove_up)(y, NULL, z);
+    }
+    else
+        AUG_FN(remove_up)(*out_xp, NULL, z);
+    return y;
+}
+
+static inline void AUG_FN(delete)(AUG_TREE* T, AUG_NODE* z){
+    AUG_NODE* xp;
+    AUG_NODE* x;
+    AUG_FN(unlink)(T, z, &xp, &x);
+}
+
+static inline int AUG_FN(is_red)(AUG_NODE* x){
+    return x != NULL && x->color == AUG_RED;
+}
+
+static inline void AUG_FN(rb_insert_fixup)(AUG_TREE* T, AUG_NODE* z){
+    while (AUG_FN(is_red)(z->p)){
+        AUG_NODE* gp = z->p->p;
+        if (z->p == gp->left){
+            AUG_NODE* y = gp->right;
+            if (AUG_FN(is_red)(y)){
+                z->p->color = AUG_BLACK;
+                y->color = AUG_BLACK;
+                gp->color = AUG_RED;
+                z = gp;
+            }
+            else{
+                if (z == z->p->right){
+                    z = z->p;
+                    AUG_FN(left_rotate)(T, z);
+                }
+                z->p->color = AUG_BLACK;
+                z->p->p->color = AUG_RED;
+                AUG_FN(right_rotate)(T, z->p->p);
+            }
+        }
+        else{
+            AUG_NODE* y = gp->left;
+            if (AUG_FN(is_red)(y)){
+                z->p->color = AUG_BLACK;
+                y->color = AUG_BLACK;
+                gp->color = AUG_RED;
+                z = gp;
+            }
+            else{
+                if (z == z->p->left){
+                    z = z->p;
+                    AUG_FN(right_rotate)(T, z);
+                }
+                z->p->color = AUG_BLACK;
+                z->p->p->color = AUG_RED;
+                AUG_FN(left_rotate)(T, z->p->p);
+            }
+        }
+    }
+    T->root->color = AUG_BLACK;
+}
+
+static inline void AUG_FN(rb_insert)(AUG_TREE* T, AUG_NODE* z){
+    z->left = NULL;
+    z->right = NULL;
+    z->color = AUG_RED;
+    AUG_FN(insert)(T, z);
+    AUG_FN(rb_insert_fixup)(T, z);
+}
+
+// x carries the extra black, xp is its parent (x may be NULL)
+static inline void AUG_FN(rb_delete_fixup)(AUG_TREE* T, AUG_NODE* x, AUG_NODE* xp){
+    while (x != T->root && !AUG_FN(is_red)(x)){
+        if (x == xp->left){
+            AUG_NODE* w = xp->right;
+            if (AUG_FN(is_red)(w)){
+                w->color = AUG_BLACK;
+                xp->color = AUG_RED;
+                AUG_FN(left_rotate)(T, xp);
+                w = xp->right;
+            }
+            if (!AUG_FN(is_red)(w->left) && !AUG_FN(is_red)(w->right)){
+                w->color = AUG_RED;
+                x = xp;
+                xp = x->p;
+            }
+            else{
+                if (!AUG_FN(is_red)(w->right)){
+                    w->left->color = AUG_BLACK;
+                    w->color = AUG_RED;
+                    AUG_FN(right_rotate)(T, w);
+                    w = xp->right;
+                }
+                w->color = xp->color;
+                xp->color = AUG_BLACK;
+                w->right->color = AUG_BLACK;
+                AUG_FN(left_rotate)(T, xp);
+                x = T->root;
+                xp = NULL;
+            }
+        }
+        else{
+            AUG_NODE* w = xp->left;
+            if (AUG_FN(is_red)(w)){
+                w->color = AUG_BLACK;
+                xp->color = AUG_RED;
+                AUG_FN(right_rotate)(T, xp);
+                w = xp->left;
+            }
+            if (!AUG_FN(is_red)(w->left) && !AUG_FN(is_red)(w->right)){
+                w->color = AUG_RED;
+                x = xp;
+                xp = x->p;
+            }
+            else{
+                if (!AUG_FN(is_red)(w->left)){
+                    w->right->color = AUG_BLACK;
+                    w->color = AUG_RED;
+                    AUG_FN(left_rotate)(T, w);
+                    w = xp->left;
+                }
+                w->color = xp->color;
+                xp->color = AUG_BLACK;
+                w->left->color = AUG_BLACK;
+                AUG_FN(right_rotate)(T, xp);
+                x = T->root;
+                xp = NULL;
+            }
+        }
+    }
+    if (x != NULL)
+        x->color = AUG_BLACK;
+}
+
+// Aggregates are right again before the fixup starts, its rotations keep them
+static inline void AUG_FN(rb_delete)(AUG_TREE* T, AUG_NODE* z){
+    AUG_NODE* xp;
+    AUG_NODE* x;
+    unsigned char z_color = z->color;
+    AUG_NODE* y = AUG_FN(unlink)(T, z, &xp, &x);
+    unsigned char removed_color = (y == z) ? z_color : y->color;
+    if (y != z)
+        y->color = z_color;
+    if (removed_color == AUG_BLACK)
+        AUG_FN(rb_delete_fixup)(T, x, xp);
+}
+
+// Fold of every field over the keys in [lo, hi] into acc's fields, O(height):
+// down to the first node inside the range, then one walk per side taking
+// whole subtrees. Returns 0 (acc untouched) if the range is empty.
+static inline int AUG_FN(range)(AUG_NODE* root, int lo, int hi, AUG_NODE* acc){
+    if (lo > hi)
+        return 0;
+    AUG_NODE* x = root;
+    while (x != NULL && (x->key < lo || x->key > hi))
+        x = (x->key < lo) ? x->right : x->left;
+    if (x == NULL)
+        return 0;
+    int any = 0;
+    AUG_NODE* n = x;
+    AUG_NODE* s;
+    AUG_FIELDS(AUG_ACC_NODE)
+    any = 1;
+    for (n = x->left; n != NULL; ){       // keys >= lo: n and its right subtree
+        if (n->key >= lo){
+            AUG_FIELDS(AUG_ACC_NODE)
+            if ((s = n->right) != NULL){
+                AUG_FIELDS(AUG_ACC_TREE)
+            }
+            n = n->left;
+        }
+        else
+            n = n->right;
+    }
+    for (n = x->right; n != NULL; ){      // keys <= hi: n and its left subtree
+        if (n->key <= hi){
+            AUG_FIELDS(AUG_ACC_NODE)
+            if ((s = n->left) != NULL){
+                AUG_FIELDS(AUG_ACC_TREE)
+            }
+            n = n->right;
+        }
+        else
+            n = n->left;
+    }
+    return 1;
+}
+
+#undef AUG_FN
+#undef AUG_NODE
+#undef AUG_TREE
+#undef AUG_PREFIX
+#undef AUG_FIELDS
@@ -0,0 +1,72 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+// B+-tree of int keys with nodes sized to a few cache lines, so each level
+// of a lookup is one or two line fetches instead of one per key.
+// All keys live in the leaves, leaves are chained both ways for scans.
+// Duplicates are allowed (they go after equal keys, like tree_insert).
+// A "counted" tree also keeps the number of keys under each child in the
+// inner nodes -> select/rank in O(height) like os_select/os_rank.
+
+#ifndef BPT_NODE_BYTES
+#define BPT_NODE_BYTES 256   // 64..256 sensible; build with -DBPT_NODE_BYTES=128 to try others
+#endif
+
+#define BPT_LEAF_KEYS ((int)((BPT_NODE_BYTES - sizeof(int) - 2 * sizeof(void*)) / sizeof(int)))
+#define BPT_INNER_KEYS ((int)((BPT_NODE_BYTES - 2 * sizeof(int) - sizeof(void*)) / (2 * sizeof(int) + sizeof(void*))))
+#define BPT_MAX_HEIGHT 32    // fanout >= 2 at every level, so 2^31 keys fit easily
+
+typedef struct BPlusLeaf {
+    int n;                              // keys in use
+    int keys[BPT_LEAF_KEYS];            // sorted
+    struct BPlusLeaf* prev;             // leaf chain, NULL at the ends
+    struct BPlusLeaf* next;
+} BPlusLeaf;
+
+typedef struct BPlusInner {
+    int n;                              // separator keys in use, children = n + 1
+    int keys[BPT_INNER_KEYS];           // child[i] keys <= keys[i] <= child[i+1] keys
+    int counts[BPT_INNER_KEYS + 1];     // keys under child[i], only kept when counted
+    void* child[BPT_INNER_KEYS + 1];    // BPlusInner above level 1, BPlusLeaf at level 1
+} BPlusInner;
+
+typedef struct BPlusTree {
+    void* root;     // a BPlusLeaf while height == 0
+    int height;     // inner levels above the leaves
+    int counted;    // maintain counts[] (select/rank in O(height) instead of a leaf walk)
+    int n;          // keys stored
+} BPlusTree;
+
+// A key's place in the tree: leaf + index, leaf == NULL means "no key"
+typedef struct BPlusPos {
+    BPlusLeaf* leaf;
+    int i;
+} BPlusPos;
+
+#define bpt_key(pos) ((pos).leaf->keys[(pos).i])
+
+BPlusTree* bpt_create(int counted);
+void bpt_destroy(BPlusTree* T);
+
+void bpt_insert(BPlusTree* T, int key);     // split full nodes on the way back up
+int bpt_delete(BPlusTree* T, int key);      // remove one copy of key, 0 if not there
+
+BPlusPos bpt_search(BPlusTree* T, int key);
+BPlusPos bpt_lower_bound(BPlusTree* T, int key); // first key >= key
+BPlusPos bpt_min(BPlusTree* T);
+BPlusPos bpt_max(BPlusTree* T);
+BPlusPos bpt_successor(BPlusPos x);
+BPlusPos bpt_predecessor(BPlusPos x);
+
+// in-order scans along the leaf chain
+void bpt_inorder_walk(BPlusTree* T);        // prints keys like inorder_tree_walk
+int bpt_to_array(BPlusTree* T, int* out);   // copies all keys in order, returns n
+
+// order statistics (leaf walk when the tree is not counted)
+BPlusPos bpt_select(BPlusTree* T, int i);   // i-th smallest (1-based)
+int bpt_rank(BPlusTree* T, int key);        // 1 + number of keys < key (os_rank for present keys)
+
+// Test helper: height if order, fill, counts and leaf chain all check out, -1 otherwise
+int bpt_validate(BPlusTree* T);
+
+#endif
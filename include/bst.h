@@ -4,18 +4,37 @@
 // Make node structure for the BST
 typedef struct Node {
     int key;  //Actual data value in the node we are in
+    unsigned char color; // red/black bit for rb_tree.c -> sits in the padding after key, node stays 32 bytes
     struct Node* left; // Pointer to left child of node
     struct Node* right; // ptr to right child of node
     struct Node* p; //Parent pointer.
 } Node;
 
+struct Arena; // node pool (arena.h)
+struct KeyStream; // keys from a binary file (key_stream.h)
+
 //Tree structure defination
 typedef struct Tree{
     Node* root; // ptr to root node
+    struct Arena* arena; // where nodes come from, NULL means plain malloc
+    double sg_alpha; // scapegoat mode when > 0 (see tree_set_scapegoat), 0 = plain BST
+    int sg_size; // nodes in the tree, only counted in scapegoat mode
+    int sg_max_size; // most nodes since the last full rebuild
+    Node* leftmost; // min/max node for tree_insert_hint, NULL = unknown.
+    Node* rightmost; // code that links/unlinks nodes itself (rb, splay, treap...) calls tree_forget_ends
 }Tree;
 
+// Drop the cached min/max. Anything that links or unlinks nodes without
+// tree_insert/tree_insert_hint/tree_delete calls this first. Inline so the
+// OS side (splay_tree.c) can use its twin without linking os_tree.o.
+static inline void tree_forget_ends(Tree* T){
+    T->leftmost = NULL;
+    T->rightmost = NULL;
+}
+
 //Main Bst funcs:
 void tree_insert(Tree* T, Node* z); // Insert node z into tree
+void tree_insert_hint(Tree* T, Node* hint, Node* z); // insert starting from hint, a node of T (best: z's sorted neighbour, e.g. previous key of a sorted stream)
 void tree_delete(Tree* T, Node* z); //delete node z from tree
 void inorder_tree_walk(Node* x); // Gives sorted keys from tree
 void transplant(Tree* T, Node*u , Node* v); // Replace subtree at root u with v
@@ -25,12 +44,32 @@ void transplant(Tree* T, Node*u , Node* v); // Replace subtree at root u with v
 Node* tree_min(Node* x); //find min at subtree x
 Node* tree_max(Node* x); // find max at subtree x
 Node* tree_search(Node* x, int key); // search for key key in subtree x
+void tree_search_batch(Tree* T, const int* keys, int m, Node** out); // out[j] = tree_search(T->root, keys[j]), lookups interleaved
 Node* tree_successor(Node* x); // get successor of node x
+Node* tree_predecessor(Node* x); // get predecessor of node x
 
 // mem management - ewww
 Node* create_node(int key); //allocate and make new node
 Tree* create_tree(void); // allocate and make new tree
-void destroy_tree(Node* root); // free all nodes in tree -> recusrive
+void destroy_tree(Node* root); // free all nodes in tree -> iterative, any height
+long destroy_tree_parallel(Node* root, int threads); // fast path: prefetching interleaved walks, subtrees spread over threads (1 = caller only), returns nodes freed
+
+// arena backed trees -> nodes sit together in slabs, whole tree freed in one go
+Tree* create_arena_tree(void); // tree with its own node arena
+Node* tree_alloc_node(Tree* T, int key); // make node from T's arena (malloc if none)
+void tree_free_node(Tree* T, Node* z); // give back a node removed with tree_delete
+void reset_arena_tree(Tree* T); // drop all nodes but keep the memory for the next build
+void destroy_arena_tree(Tree* T); // release every node and T itself
+Tree* tree_build_from_sorted(int* keys, int n); // O(n) min-height arena tree from sorted keys (also a valid RB tree)
+Tree* tree_build_parallel(int* keys, int n, int threads); // keys in any order (sorted in place), same tree as above built by pthreads
+Tree* tree_build_from_stream(struct KeyStream* S); // same tree from the rest of a sorted key file, NULL if out of order
+long tree_insert_stream(Tree* T, struct KeyStream* S); // tree_insert every remaining key of the file, returns how many
+
+// scapegoat mode -> no per-node balance info, tree_insert rebuilds a subtree when
+// a new node lands deeper than log_{1/alpha} n, tree_delete rebuilds everything
+// once n drops below alpha * max n. Height stays O(log n) for any input order.
+void tree_set_scapegoat(Tree* T, double alpha); // 0.5 <= alpha < 1 turns it on (rebuilds once), 0 turns it off
+void tree_rebalance(Tree* T); // Day-Stout-Warren: perfectly balanced in O(n) time, O(1) extra space
 
 // Additional functions needed for experiments
 int tree_height(Node* node); // calculate height of tree
@@ -39,4 +78,15 @@ void inorder_tree_walk_silent(Node* x); // inorder walk without printing (for ti
 // Test helper function
 void inorder_tree_walk_limit(Node* x, int limit); // inorder walk with output limit
 
+// In-order cursor -> walk the tree one node at a time, both directions
+typedef struct TreeCursor {
+    Tree* T;     // tree being walked
+    Node* node;  // current node, NULL once we walk off either end
+} TreeCursor;
+
+Node* tree_cursor_begin(TreeCursor* c, Tree* T); // smallest key
+Node* tree_cursor_last(TreeCursor* c, Tree* T); // largest key
+Node* tree_cursor_next(TreeCursor* c); // move to successor
+Node* tree_cursor_prev(TreeCursor* c); // move to predecessor
+
 #endif
\ No newline at end of file
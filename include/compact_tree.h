@@ -0,0 +1,65 @@
+#ifndef COMPACT_TREE_H
+#define COMPACT_TREE_H
+
+#include <stdint.h>
+
+// Same trees as bst.h / os_tree.h, but the nodes live in one growable array
+// and link to each other with 32-bit indices instead of 64-bit pointers.
+// Index 0 is the nil node (CLRS T.nil), so a handle of 0 means "no node".
+// Handles stay valid when the array grows, unlike pointers.
+
+#define CNIL 0
+
+typedef struct CNode {      // 16 bytes (Node is 32)
+    int key;
+    uint32_t left;
+    uint32_t right;
+    uint32_t p;
+} CNode;
+
+typedef struct COSNode {    // 20 bytes (OSNode is 40)
+    int key;
+    int size;               // nil has size 0, so no NULL checks needed
+    uint32_t left;
+    uint32_t right;
+    uint32_t p;
+} COSNode;
+
+typedef struct CompactTree {
+    CNode* nodes;           // nodes[0] is nil
+    uint32_t capacity;      // slots allocated
+    uint32_t used;          // slots handed out so far (nil included)
+    uint32_t free_list;     // deleted slots, chained through left
+    uint32_t root;
+} CompactTree;
+
+typedef struct CompactOSTree {
+    COSNode* nodes;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t free_list;
+    uint32_t root;
+} CompactOSTree;
+
+// BST (Chapter 12) on the compact layout
+CompactTree* ctree_create(int capacity);            // capacity is just a starting hint
+void ctree_destroy(CompactTree* T);                 // one free for the whole tree
+uint32_t ctree_insert(CompactTree* T, int key);     // TREE-INSERT, returns the new node's handle (CNIL = full, not inserted)
+void ctree_delete(CompactTree* T, uint32_t z);      // TREE-DELETE, slot goes on the free list
+uint32_t ctree_search(CompactTree* T, int key);
+uint32_t ctree_min(CompactTree* T, uint32_t x);
+uint32_t ctree_max(CompactTree* T, uint32_t x);
+uint32_t ctree_successor(CompactTree* T, uint32_t x);
+size_t ctree_bytes(CompactTree* T);                 // memory held by the node array
+
+// OS-tree (Chapter 14) on the compact layout
+CompactOSTree* cos_tree_create(int capacity);
+void cos_tree_destroy(CompactOSTree* T);
+uint32_t cos_tree_insert(CompactOSTree* T, int key);   // CNIL = full, not inserted
+void cos_tree_delete(CompactOSTree* T, uint32_t z);
+uint32_t cos_tree_search(CompactOSTree* T, int key);
+uint32_t cos_select(CompactOSTree* T, int i);       // handle of i-th smallest, CNIL if out of range
+int cos_rank(CompactOSTree* T, uint32_t x);
+size_t cos_tree_bytes(CompactOSTree* T);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef CONCURRENT_BST_H
+#define CONCURRENT_BST_H
+
+#include <pthread.h>
+#include "bst.h"
+
+// Concurrent mode for the plain BST: any number of readers search without
+// taking a lock while writers (one at a time, behind a mutex) insert and
+// delete. Nodes a delete unlinks are retired, not freed, and only go back to
+// malloc once every reader that could still be looking at them has left its
+// read section (epoch-based reclamation, 3 epochs).
+//
+// Reader side: child pointers are loaded with acquire, so a reader always
+// sees a fully built node. Writer side: a node is filled in before it is
+// linked (release), and a delete with two children links in a *copy* of the
+// successor instead of moving it. Between that and unlinking the old
+// successor a reader can miss that key, so a miss is double-checked against
+// a sequence counter and retried if a successor move overlapped it.
+// Hits never retry.
+
+#define CONC_MAX_READERS 64
+
+typedef struct ConcurrentTree ConcurrentTree;
+
+// One per reader thread (register once, keep it), padded to its own cache line
+typedef struct ConcReader {
+    ConcurrentTree* CT;
+    unsigned long epoch;     // epoch seen on entry, 0 while outside a read section
+    char pad[64 - sizeof(ConcurrentTree*) - sizeof(unsigned long)];
+} ConcReader;
+
+struct ConcurrentTree {
+    Tree* T;                          // plain nodes from create_node
+    pthread_mutex_t write_lock;       // writers are serialized
+    unsigned long epoch;              // global epoch, starts at 1
+    unsigned long seq;                // odd while a delete is moving a successor
+    ConcReader* readers[CONC_MAX_READERS];
+    Node* limbo[3];                   // retired in epoch e -> limbo[e % 3], chained through p
+    long retired;                     // nodes waiting in limbo
+};
+
+ConcurrentTree* conc_tree_create(void);
+void conc_tree_destroy(ConcurrentTree* CT);     // no readers or writers may be left
+
+ConcReader* conc_reader_register(ConcurrentTree* CT);  // NULL if all CONC_MAX_READERS slots are taken
+void conc_reader_unregister(ConcReader* r);
+
+// readers: lock free, any number at once
+int conc_tree_search(ConcReader* r, int key);  // 1 if key is in the tree
+void conc_read_begin(ConcReader* r);           // hold nodes across several lookups:
+Node* conc_tree_search_node(ConcReader* r, int key); // node stays valid until conc_read_end
+void conc_read_end(ConcReader* r);
+
+// writers: serialized on write_lock
+void conc_tree_insert(ConcurrentTree* CT, int key);   // equal keys go right, like tree_insert
+int conc_tree_delete(ConcurrentTree* CT, int key);    // 1 if a node with key was removed
+
+#endif
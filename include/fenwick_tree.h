@@ -0,0 +1,56 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include "os_tree.h"
+
+// Order statistics for keys from a bounded range lo..hi (a multiset):
+// a Fenwick (binary indexed) tree of per-key counts. One flat int array,
+// 4 bytes per possible key, no nodes or pointers. Insert, delete and rank
+// are O(log U) prefix updates/sums (U = hi - lo + 1), select is binary
+// lifting down the implicit tree, also O(log U).
+typedef struct FenwickTree {
+    int lo, hi;         // key range
+    int universe;       // hi - lo + 1
+    int top;            // highest power of two <= universe (select's first step)
+    int count;          // keys stored, duplicates included
+    int* bit;           // bit[1..universe]
+} FenwickTree;
+
+FenwickTree* fen_create(int lo, int hi);                     // NULL if hi < lo or the range is too big
+FenwickTree* fen_build(int lo, int hi, const int* keys, int n); // O(U + n), keys in any order
+void fen_destroy(FenwickTree* F);
+
+int fen_insert(FenwickTree* F, int key);        // 0 if key is outside lo..hi
+int fen_delete(FenwickTree* F, int key);        // one copy, 0 if key is not there
+int fen_count(FenwickTree* F, int key);         // copies of key
+int fen_rank(FenwickTree* F, int key);          // os_rank_of_key: keys < key, + 1
+int fen_select(FenwickTree* F, int i, int* key); // i-th smallest into *key, 0 if i is out of range
+int fen_count_range(FenwickTree* F, int lo, int hi); // keys in [lo, hi]
+
+// One interface over both engines. The Fenwick array is picked when the
+// key range is dense enough for it to be smaller than the nodes (at most
+// FENWICK_DENSITY possible keys per expected key), the red-black OSTree
+// otherwise; callers only see keys and ranks.
+#define FENWICK_DENSITY 8              // 4 bytes per possible key vs 40 per OSNode
+#define FENWICK_MAX_UNIVERSE (1 << 28)  // 1GB array
+
+#define ORDER_INDEX_FENWICK 1
+#define ORDER_INDEX_TREE 2
+
+typedef struct OrderIndex {
+    int kind;
+    int lo, hi;
+    FenwickTree* F;     // kind == ORDER_INDEX_FENWICK
+    OSTree* T;          // kind == ORDER_INDEX_TREE
+} OrderIndex;
+
+OrderIndex* order_index_create(int lo, int hi, int expected_n);
+void order_index_destroy(OrderIndex* I);
+int order_index_insert(OrderIndex* I, int key);    // 0 if key is outside lo..hi
+int order_index_delete(OrderIndex* I, int key);    // 0 if absent
+int order_index_select(OrderIndex* I, int i, int* key);  // like fen_select
+int order_index_rank(OrderIndex* I, int key);      // like os_rank_of_key
+int order_index_count_range(OrderIndex* I, int lo, int hi);
+int order_index_size(OrderIndex* I);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef FROZEN_TREE_H
+#define FROZEN_TREE_H
+
+#include "bst.h"
+#include "os_tree.h"
+
+// Read-only snapshot of a tree flattened into Eytzinger (BFS) order:
+// the children of slot k are slots 2k and 2k+1, so a lookup is just index
+// arithmetic over one array, no pointers to chase. Subtree sizes of this
+// implicit complete tree are computed from n, which gives rank/select
+// without storing a size per key (4 bytes per key in total).
+typedef struct FrozenTree {
+    int n;      // number of keys
+    int* eyt;   // eyt[1..n] in BFS order, eyt[0] unused, 64-byte aligned
+} FrozenTree;
+
+FrozenTree* tree_freeze(Tree* T);                  // O(n) snapshot of a BST
+FrozenTree* os_tree_freeze(OSTree* T);             // O(n) snapshot of an OS-tree
+FrozenTree* frozen_from_sorted(const int* keys, int n); // snapshot straight from sorted keys
+void frozen_destroy(FrozenTree* F);
+
+// Branchless descents with prefetch of the great-great-grandchildren.
+// Slots index F->eyt, so the key found is F->eyt[slot].
+int frozen_lower_bound(FrozenTree* F, int key);  // slot of first key >= key, 0 if none
+int frozen_search(FrozenTree* F, int key);       // slot holding key, 0 if absent
+int frozen_rank(FrozenTree* F, int key);         // number of keys < key (os_rank - 1 for present keys)
+int frozen_select(FrozenTree* F, int i);         // slot of the i-th smallest key (1-based), 0 if out of range
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef KEY_STREAM_H
+#define KEY_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Keys straight from a binary file of packed 32- or 64-bit signed integers
+// (native byte order, no header), for trees built from captured key sets
+// instead of generate_sequence. The file is mmapped read-only and walked
+// front to back; 32-bit keys are handed out as pointers into the mapping,
+// so there is no int array in between. 64-bit keys are narrowed through a
+// small reusable chunk buffer, and the ones that do not fit in an int are
+// skipped and counted.
+//
+// Consumers: tree_insert_stream / tree_build_from_stream (bst.h) and the
+// os_ versions (os_tree.h).
+
+#define KEY_STREAM_CHUNK 65536      // keys per key_stream_next by default
+
+typedef struct KeyStream {
+    const char* map;        // whole file, NULL if empty
+    size_t bytes;
+    int width;              // 4 or 8 bytes per key
+    size_t count;           // keys in the file
+    size_t pos;             // next key to hand out
+    size_t skipped;         // 64-bit keys outside int range so far
+    int* chunk;             // narrowing buffer for 64-bit files
+} KeyStream;
+
+KeyStream* key_stream_open(const char* path, int width);   // NULL on error or if the size is not a multiple of width
+void key_stream_close(KeyStream* S);
+void key_stream_rewind(KeyStream* S);                      // back to the first key, skipped reset
+
+// Up to max keys (0 = KEY_STREAM_CHUNK), *got of them, NULL at the end.
+// Valid until the next call.
+const int* key_stream_next(KeyStream* S, size_t max, size_t* got);
+int key_stream_get(KeyStream* S, int* key);                // one key, 0 at the end
+int key_stream_is_sorted(KeyStream* S);                    // 1 if the rest is ascending, position left as it was
+
+// Experiment binaries: "--keys FILE" (32-bit) or "--keys64 FILE" (64-bit).
+// 1 and *path/*width set if given, 0 if there are no arguments, -1 on anything else.
+int key_stream_parse_args(int argc, char** argv, const char** path, int* width);
+
+// Writes keys in the same format (for tests and for converting key sets); 0 on success
+int key_file_write(const char* path, const int* keys, size_t n, int width);
+
+#endif
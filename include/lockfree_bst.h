@@ -0,0 +1,64 @@
+#ifndef LOCKFREE_BST_H
+#define LOCKFREE_BST_H
+
+#include <stdint.h>
+
+// Lock-free BST for many threads inserting and deleting at once
+// (Natarajan & Mittal, "Fast Concurrent Lock-Free Binary Search Trees",
+// PPoPP 2014). External tree: keys live in the leaves, internal nodes only
+// route. Every update is one CAS to add or flag an edge plus one CAS to cut
+// the flagged leaf out, and any thread that runs into a half-finished delete
+// finishes it. Searches never write.
+//
+// Same contract as tree_insert/tree_delete/tree_search in bst.h, but by key
+// and as a set: an insert of a key that is already there returns 0.
+//
+// Memory: every thread registers once and passes its handle to each call.
+// Unlinked nodes go onto that thread's limbo lists and are freed once the
+// global epoch has moved two past the one they were retired in (epoch based
+// reclamation like concurrent_bst.c, but with retirement on every thread).
+
+#define LF_MAX_THREADS 64
+
+typedef struct LFNode {
+    long long key;          // int keys, plus three sentinel keys above INT_MAX
+    uintptr_t left;         // child pointer | flag/tag bits, 0 in a leaf
+    uintptr_t right;
+    struct LFNode* next_retired;   // limbo chain (left/right stay readable)
+} LFNode;
+
+typedef struct LFTree LFTree;
+
+// One per thread, padded to two cache lines of its own
+typedef struct LFThread {
+    LFTree* T;
+    unsigned long epoch;            // announced epoch, 0 outside an operation
+    LFNode* limbo[3];               // retired nodes by epoch % 3
+    unsigned long limbo_epoch[3];   // global epoch the nodes in limbo[b] were retired in
+    long since_advance;             // retires since we last tried to move the epoch on
+    char pad[128 - sizeof(LFTree*) - sizeof(unsigned long) - 3 * sizeof(LFNode*) - 3 * sizeof(unsigned long) - sizeof(long)];
+} LFThread;
+
+struct LFTree {
+    LFNode* R;                          // sentinel root (inf2), R->left = S (inf1)
+    unsigned long epoch;                // global epoch, starts at 1
+    LFThread* threads[LF_MAX_THREADS];  // registered handles, NULL = free slot
+    LFNode* orphans;                    // limbo of threads that unregistered, freed on destroy
+};
+
+LFTree* lf_tree_create(void);
+void lf_tree_destroy(LFTree* T);                // after every thread has unregistered
+
+LFThread* lf_thread_register(LFTree* T);        // NULL if all LF_MAX_THREADS slots are taken
+void lf_thread_unregister(LFThread* h);
+
+int lf_tree_insert(LFThread* h, int key);       // 1 if added, 0 if key was already there
+int lf_tree_delete(LFThread* h, int key);       // 1 if removed, 0 if key was not there
+int lf_tree_search(LFThread* h, int key);       // 1 if present
+
+// Test helpers, only with no operation in flight: number of keys, and
+// 1 if the routing keys, leaf order and edge bits are all consistent
+int lf_tree_count(LFTree* T);
+int lf_tree_validate(LFTree* T);
+
+#endif
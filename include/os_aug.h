@@ -0,0 +1,15 @@
+#ifndef OS_AUG_H
+#define OS_AUG_H
+
+// The OS-tree instance of augment.h: size is its only aggregate. Private to
+// os_tree.c / os_rb_tree.c, everything else goes through os_tree.h.
+
+#include "os_tree.h"
+
+#define AUG_NODE OSNode
+#define AUG_TREE OSTree
+#define AUG_PREFIX os_aug
+#define AUG_FIELDS(X) X(size, AUG_ONE, AUG_SUM, AUG_SUB)
+#include "augment.h"
+
+#endif
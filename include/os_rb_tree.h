@@ -0,0 +1,24 @@
+#ifndef OS_RB_TREE_H
+#define OS_RB_TREE_H
+
+#include "os_tree.h"
+
+// Balanced order-statistic tree: CLRS 14.1 proper, i.e. a red-black tree
+// whose rotations recompute size. Uses OSNode/OSTree, so os_select, os_rank,
+// os_tree_search, walks and cursors from os_tree.h work on it directly and
+// run in O(log n) worst case whatever order the keys arrive in.
+
+#define OS_RB_RED 0
+#define OS_RB_BLACK 1
+
+void os_rb_tree_insert(OSTree* T, OSNode* z);   // size++ on the way down + RB fixup
+void os_rb_tree_delete(OSTree* T, OSNode* z);   // size-- above the spliced node + RB fixup
+
+// rotations fix parent pointers, T->root and both sizes
+void os_rb_left_rotate(OSTree* T, OSNode* x);
+void os_rb_right_rotate(OSTree* T, OSNode* x);
+
+// Test helper: black height, or -1 if a colour rule or a size field is wrong
+int os_rb_validate(OSTree* T);
+
+#endif
@@ -5,33 +5,67 @@
 typedef struct OSNode {
     int key;                //key val
     int size;               // Size of subtree
+    unsigned char color;    // red/black, only used by os_rb_tree.c
     struct OSNode* left;    // left chiled
     struct OSNode* right; // right child
     struct OSNode* p; // parent
 } OSNode;
 
+struct Arena; // node pool (arena.h)
+struct KeyStream; // keys from a binary file (key_stream.h)
+
 // Tree struct
 typedef struct OSTree{
     OSNode* root;
+    struct Arena* arena;    // node pool, NULL when nodes come from os_create_node
+    OSNode* leftmost;       // min/max for os_tree_insert_hint, NULL = unknown (os_tree_forget_ends)
+    OSNode* rightmost;
 } OSTree;
 
+// Drop the cached min/max, see tree_forget_ends in bst.h
+static inline void os_tree_forget_ends(OSTree* T){
+    T->leftmost = NULL;
+    T->rightmost = NULL;
+}
+
 //tree manaagement
 OSTree* os_create_tree(void);
 OSNode* os_create_node(int key);
 void os_destroy_tree(OSNode* root);
+long os_destroy_tree_parallel(OSNode* root, int threads); // interleaved prefetching walks over threads, see bst.h
+
+// arena backed OS-trees (see arena.h)
+OSTree* os_create_arena_tree(void);
+OSNode* os_tree_alloc_node(OSTree* T, int key);
+void os_tree_free_node(OSTree* T, OSNode* z);   // after os_tree_delete
+void os_reset_arena_tree(OSTree* T);           // empty tree, memory kept
+void os_destroy_arena_tree(OSTree* T);
+OSTree* os_tree_build_from_sorted(int* keys, int n); // O(n) balanced arena tree, sizes filled in
+OSTree* os_tree_build_parallel(int* keys, int n, int threads); // any order, keys sorted in place, spine + subtrees on threads
+OSTree* os_tree_build_from_stream(struct KeyStream* S); // from the rest of a sorted key file, NULL if out of order (see bst.h)
+long os_tree_insert_stream(OSTree* T, struct KeyStream* S); // os_tree_insert every remaining key, returns how many
 
 // OSTree operations 
 void os_tree_insert(OSTree* T, OSNode* z);
+void os_tree_insert_hint(OSTree* T, OSNode* hint, OSNode* z); // hint = a node of T (best: z's sorted neighbour), sizes fixed on the way up
 void os_tree_delete(OSTree* T, OSNode* z);
 void os_transplant(OSTree* T, OSNode* u, OSNode* v);
 
 // Order-stats operations
 OSNode* os_select(OSNode* x, int i);     
+void os_select_batch(OSTree* T, const int* ranks, int m, OSNode** out); // out[j] = os_select(T->root, ranks[j]), interleaved
+void os_select_many(OSNode* root, const int* ranks, int m, OSNode** out); // same, ranks ascending, one shared descent
 int os_rank(OSTree* T, OSNode* x);      
+int os_rank_of_key(OSTree* T, int key);         // lower bound: rank of the first node >= key (n+1 if none)
+int os_rank_of_key_upper(OSTree* T, int key);   // upper bound: number of keys <= key
+int os_count_range(OSTree* T, int lo, int hi);  // keys in [lo, hi], one descent, no scan
 
 //Helpers
 OSNode* os_tree_search(OSNode* x, int k);
 OSNode* os_tree_min(OSNode* x);
+OSNode* os_tree_max(OSNode* x);
+OSNode* os_tree_successor(OSNode* x);
+OSNode* os_tree_predecessor(OSNode* x);
 int os_get_size(OSNode* x);              // Helper to get size (0 if nil)
 int os_tree_height(OSNode* node);        // For testing
 
@@ -39,4 +73,15 @@ int os_tree_height(OSNode* node);        // For testing
 void os_inorder_tree_walk(OSNode* x);
 void os_inorder_tree_walk_silent(OSNode* x);
 
+// In-order cursor (begin/last + next/prev through successor/predecessor)
+typedef struct OSTreeCursor {
+    OSTree* T;
+    OSNode* node;   // NULL after walking off either end
+} OSTreeCursor;
+
+OSNode* os_tree_cursor_begin(OSTreeCursor* c, OSTree* T);
+OSNode* os_tree_cursor_last(OSTreeCursor* c, OSTree* T);
+OSNode* os_tree_cursor_next(OSTreeCursor* c);
+OSNode* os_tree_cursor_prev(OSTreeCursor* c);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef PERSISTENT_TREE_H
+#define PERSISTENT_TREE_H
+
+// Persistent (path-copying) BST and OS-Tree for point-in-time reads.
+// A version is just a root pointer. Nodes are never changed once built: an
+// insert or delete copies the root-to-leaf path it touches and returns a
+// new root that shares every other subtree with the old one, so each update
+// costs O(depth) new nodes and the old version stays readable as it was.
+//
+// Every node counts the parents and version handles pointing at it. The
+// caller owns one reference per root it gets back from an update or from
+// *_retain, and gives it back with *_release; a node is freed when its last
+// reference goes. Taking a snapshot is one *_retain: O(1), no copying.
+//
+// Updates are plain functions of (version, key) -> new version and never
+// touch the version passed in. Reading a version (search/select/rank) and
+// releasing it is safe from any thread at the same time as updates build
+// newer versions; handing out the current root is up to the caller.
+// No parent pointers (subtrees are shared), equal keys go right.
+
+typedef struct PNode {
+    int key;
+    int refs;               // parents + version handles
+    struct PNode* left;
+    struct PNode* right;
+} PNode;
+
+typedef struct OSPNode {
+    int key;
+    int size;               // size of subtree
+    int refs;
+    struct OSPNode* left;
+    struct OSPNode* right;
+} OSPNode;
+
+// ---------- BST ----------
+PNode* ptree_insert(PNode* root, int key);     // new version with key added
+PNode* ptree_delete(PNode* root, int key);     // new version with one key removed (a new reference to root if absent)
+PNode* ptree_search(PNode* root, int key);
+PNode* ptree_retain(PNode* root);              // snapshot: one more reference to the same version
+void ptree_release(PNode* root);               // drop a version, frees what only it was using
+PNode* ptree_build_from_sorted(const int* keys, int n);   // balanced version 0 in O(n)
+long ptree_live_nodes(void);                   // test helper: nodes currently allocated
+
+// ---------- OS-Tree ----------
+OSPNode* os_ptree_insert(OSPNode* root, int key);
+OSPNode* os_ptree_delete(OSPNode* root, int key);
+OSPNode* os_ptree_search(OSPNode* root, int key);
+OSPNode* os_ptree_select(OSPNode* root, int i);     // i-th smallest, 1-based
+int os_ptree_rank(OSPNode* root, int key);          // rank of the first node with key, 0 if absent
+int os_ptree_size(OSPNode* root);
+OSPNode* os_ptree_retain(OSPNode* root);
+void os_ptree_release(OSPNode* root);
+OSPNode* os_ptree_build_from_sorted(const int* keys, int n);
+long os_ptree_live_nodes(void);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef RB_TREE_H
+#define RB_TREE_H
+
+#include "bst.h"
+
+// Red-black tree (CLRS Chapter 13) on the same Node/Tree structs as bst.h,
+// so search/min/max/successor/walks/height/destroy all work unchanged.
+// NULL children play the role of T.nil (always black).
+
+#define RB_RED 0
+#define RB_BLACK 1
+
+void rb_tree_insert(Tree* T, Node* z); // BST insert + recolour/rotate, height <= 2 lg(n+1)
+void rb_tree_delete(Tree* T, Node* z); // BST delete + fixup
+
+// rotations keep parent pointers and T->root right
+void rb_left_rotate(Tree* T, Node* x);
+void rb_right_rotate(Tree* T, Node* x);
+
+// Test helper: black height of the tree, or -1 if a red-black property is broken
+int rb_validate(Tree* T);
+
+#endif
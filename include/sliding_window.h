@@ -0,0 +1,31 @@
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include "os_tree.h"
+
+// Rolling quantiles over the last w samples. Each push inserts the newest
+// sample and, once the window is full, deletes the one that expired, all
+// on an OSTree so any quantile is one os_select. The w nodes are allocated
+// once and used as the ring buffer itself: slot k holds the node of the
+// sample pushed k, k+w, k+2w.. ago, so the expired node is simply unlinked,
+// given the new key and linked back in (no free/malloc per sample).
+// Red-black insert/delete, so O(log w) per push and per query whatever the
+// data looks like (a monotone series would turn a plain tree into a list).
+typedef struct SlidingWindow {
+    OSTree* T;
+    OSNode* ring;       // capacity nodes, ring[head] is the oldest sample
+    int capacity;       // window size w
+    int count;          // samples in the window, < capacity while filling
+    int head;
+} SlidingWindow;
+
+SlidingWindow* window_create(int w);    // NULL if w < 1
+void window_destroy(SlidingWindow* W);
+void window_push(SlidingWindow* W, int sample);
+
+// i-th smallest sample in the window into *value, 0 if i is out of range
+int window_select(SlidingWindow* W, int i, int* value);
+// nearest-rank quantile, q in [0, 1] (rank ceil(q * count), at least 1); 0 if empty
+int window_quantile(SlidingWindow* W, double q, int* value);
+
+#endif
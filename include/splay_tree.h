@@ -0,0 +1,32 @@
+#ifndef SPLAY_TREE_H
+#define SPLAY_TREE_H
+
+#include "bst.h"
+#include "os_tree.h"
+
+// Splay tree (Sleator-Tarjan, bottom-up) on the same structs as bst.h and
+// os_tree.h. Every access rotates the node it touched up to the root, so a
+// small hot set of keys ends up near the top: O(log n) amortized per access,
+// and much less than that when lookups are skewed (Zipf) or repeat soon.
+// successor/predecessor/walks/height/destroy from bst.h and os_tree.h work
+// unchanged (they just don't splay). Searches change the shape, so a splay
+// tree is not safe to read from two threads at once.
+
+// ---------- BST (Node/Tree) ----------
+void splay(Tree* T, Node* x);                  // rotate x up to the root
+void splay_tree_insert(Tree* T, Node* z);      // BST insert, then splay z (equal keys go right)
+void splay_tree_delete(Tree* T, Node* z);      // splay z, join its subtrees under their max
+Node* splay_tree_search(Tree* T, int key);     // splays the hit, or the last node visited on a miss
+Node* splay_tree_min(Tree* T);                 // splays the min
+Node* splay_tree_max(Tree* T);                 // splays the max
+
+// ---------- OS-tree (OSNode/OSTree) ----------
+// rotations recompute size, so os_select/os_rank work at any point
+void os_splay(OSTree* T, OSNode* x);
+void os_splay_tree_insert(OSTree* T, OSNode* z);   // size++ on the way down, then splay z
+void os_splay_tree_delete(OSTree* T, OSNode* z);
+OSNode* os_splay_tree_search(OSTree* T, int key);
+OSNode* os_splay_select(OSTree* T, int i);         // i-th smallest, splayed to the root
+int os_splay_rank(OSTree* T, OSNode* x);           // splay x, rank = left size + 1
+
+#endif
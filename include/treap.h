@@ -0,0 +1,37 @@
+#ifndef TREAP_H
+#define TREAP_H
+
+#include "bst.h"
+
+// Treap on the same Node/Tree structs as bst.h: BST order on keys plus
+// max-heap order on a priority. The priority is a seeded hash of the key
+// (equal keys told apart by a hash of the node address) instead of a stored
+// random number, so Node does not grow, and the shape
+// is the one a random insertion order would give -> expected height
+// O(log n) for any arrival order, sorted input included, with no shuffle.
+// search/min/max/successor/walks/height/destroy from bst.h work unchanged.
+//
+// split/join/set operations move nodes between trees, so the trees
+// involved should share an allocator (plain create_node, or one arena).
+// Nodes that drop out of a set operation are given back with tree_free_node.
+
+void treap_set_seed(unsigned int seed);    // pick the hash (only before building)
+
+void treap_insert(Tree* T, Node* z);       // expected O(log n), equal keys go right
+void treap_delete(Tree* T, Node* z);       // z replaced by join of its children
+
+// Split T into keys < key (L) and keys >= key (R). T is left empty.
+void treap_split(Tree* T, int key, Tree* L, Tree* R);
+// T = L followed by R, every key in L <= every key in R. L and R are left empty.
+void treap_join(Tree* T, Tree* L, Tree* R);
+
+// Set operations for treaps without duplicate keys: the result goes in A and
+// B is left empty. O(m log(n/m + 1)) expected for sizes m <= n.
+void treap_union(Tree* A, Tree* B);        // A = A u B
+void treap_intersection(Tree* A, Tree* B); // A = A n B
+void treap_difference(Tree* A, Tree* B);   // A = A \ B
+
+// Test helper: 1 if keys, priorities and parent pointers are all consistent
+int treap_validate(Tree* T);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef TREE_IMAGE_H
+#define TREE_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bst.h"
+#include "os_tree.h"
+
+// On-disk image of a Tree or OSTree that is used in place after mmap: no
+// parsing, no allocation per node, the queries below walk the mapped file.
+// Nodes link by 32-bit index into the node array instead of by pointer, so
+// the image means the same wherever it is mapped. Index 0 is a nil record
+// (like CNIL in compact_tree.h), the root is index 1, and the nodes are in
+// BFS order, so the top levels of the tree share the first few pages.
+//
+// File: ImageHeader, then n + 1 node records. Native byte order and int
+// size; the header records the node size so a mismatched build refuses it.
+
+#define IMAGE_BST 1
+#define IMAGE_OS  2
+
+typedef struct ImageHeader {    // 32 bytes
+    char magic[8];              // "TREEIMG1"
+    uint32_t kind;              // IMAGE_BST or IMAGE_OS
+    uint32_t node_bytes;        // sizeof(ImgNode) or sizeof(ImgOSNode)
+    uint64_t n;                 // nodes, nil not counted
+    uint32_t root;              // 1, or 0 for an empty tree
+    uint32_t pad;
+} ImageHeader;
+
+typedef struct ImgNode {        // 12 bytes (Node is 32)
+    int key;
+    uint32_t left;
+    uint32_t right;
+} ImgNode;
+
+typedef struct ImgOSNode {      // 16 bytes (OSNode is 40)
+    int key;
+    int size;                   // nil has size 0
+    uint32_t left;
+    uint32_t right;
+} ImgOSNode;
+
+typedef struct TreeImage {
+    void* base;                 // mapping of the whole file
+    size_t bytes;
+    int kind;
+    uint32_t n;
+    uint32_t root;
+    const ImgNode* nodes;       // BST images, NULL otherwise
+    const ImgOSNode* os_nodes;  // OS images, NULL otherwise
+} TreeImage;
+
+// Writing: one pass over the tree, streamed out sequentially (the header is
+// patched with n at the end). 0 on success, -1 if the file could not be
+// written or the tree has more than UINT32_MAX - 1 nodes.
+int tree_image_write(Tree* T, const char* path);
+int os_tree_image_write(OSTree* T, const char* path);
+
+// Reading: mmap + header check. NULL if the file is missing, truncated or
+// was written by a build with a different node layout.
+TreeImage* tree_image_open(const char* path);
+void tree_image_close(TreeImage* I);
+
+// Queries on the mapping. Handles are node indices, 0 = not found.
+uint32_t image_search(const TreeImage* I, int key);     // any image, like tree_search
+int image_key(const TreeImage* I, uint32_t x);
+uint32_t image_os_select(const TreeImage* I, int i);    // OS images, like os_select from the root
+int image_os_rank(const TreeImage* I, int key);         // OS images: rank of the first node with key, 0 if absent
+
+#endif
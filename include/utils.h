@@ -13,9 +13,14 @@ void permute_by_sorting(int* A, int n);   // PERMUTE-BY-SORTING from lecture
 int* generate_sequence(int n);
 
 // Timing functions
-double get_time_ms();
+double get_time_ms();       // CPU time of the whole process
+double get_wall_time_ms();  // wall clock, for anything with threads in it
 
 // Random number generator
 int random_range(int min, int max);
 
+// Threads: run fn(ctx, 0..ntasks-1) spread over up to `threads` pthreads, returns when all are done
+void parallel_for(int threads, int ntasks, void (*fn)(void* ctx, int task), void* ctx);
+void parallel_sort(int* keys, int n, int threads);   // ascending, in place (radix sort per chunk + parallel merges)
+
 #endif
\ No newline at end of file
@@ -18,10 +18,10 @@ echo -e "  • Trees per run: 100-300 for small sizes, 15-30 for large sizes"
 echo -e "${BLUE}========================================${NC}"
 
 # Clean and compile
-echo -e "\n${YELLOW}[1/8] Cleaning previous builds...${NC}"
+echo -e "\n${YELLOW}[1/9] Cleaning previous builds...${NC}"
 make clean
 
-echo -e "\n${YELLOW}[2/8] Compiling all implementations...${NC}"
+echo -e "\n${YELLOW}[2/9] Compiling all implementations...${NC}"
 make all
 
 if [ $? -ne 0 ]; then
@@ -33,7 +33,7 @@ echo -e "${GREEN}✓ Compilation successful!${NC}"
 
 # Run Part A tests
 echo -e "\n${BLUE}=== PART A: Binary Search Trees ===${NC}"
-echo -e "\n${YELLOW}[3/8] Running BST basic tests...${NC}"
+echo -e "\n${YELLOW}[3/9] Running BST basic tests...${NC}"
 ./bin/bst_test > /dev/null 2>&1
 
 if [ $? -ne 0 ]; then
@@ -44,7 +44,7 @@ fi
 echo -e "${GREEN}✓ BST tests passed!${NC}"
 
 # Run Part A experiments
-echo -e "\n${YELLOW}[4/8] Running BST experiments...${NC}"
+echo -e "\n${YELLOW}[4/9] Running BST experiments...${NC}"
 ./bin/bst_experiments > data/bst_results.csv
 
 if [ $? -ne 0 ]; then
@@ -57,7 +57,7 @@ echo -e "${GREEN}  Data saved to data/bst_results.csv${NC}"
 
 # Run Part B tests
 echo -e "\n${BLUE}=== PART B: Order-Statistic Trees ===${NC}"
-echo -e "\n${YELLOW}[5/8] Running OS-Tree basic tests...${NC}"
+echo -e "\n${YELLOW}[5/9] Running OS-Tree basic tests...${NC}"
 ./bin/os_test > /dev/null 2>&1
 
 if [ $? -ne 0 ]; then
@@ -68,7 +68,7 @@ fi
 echo -e "${GREEN}✓ OS-Tree tests passed!${NC}"
 
 # Run Part B experiments
-echo -e "\n${YELLOW}[6/8] Running OS-Tree experiments...${NC}"
+echo -e "\n${YELLOW}[6/9] Running OS-Tree experiments...${NC}"
 ./bin/os_experiments > data/os_results.csv
 
 if [ $? -ne 0 ]; then
@@ -79,8 +79,20 @@ fi
 echo -e "${GREEN}✓ OS-Tree experiments completed!${NC}"
 echo -e "${GREEN}  Data saved to data/os_results.csv${NC}"
 
+# Run the multi-threaded experiments
+echo -e "\n${YELLOW}[7/9] Running concurrent experiments...${NC}"
+./bin/concurrent_experiments > data/concurrent_results.csv
+
+if [ $? -ne 0 ]; then
+    echo -e "${RED}❌ Concurrent experiments failed!${NC}"
+    exit 1
+fi
+
+echo -e "${GREEN}✓ Concurrent experiments completed!${NC}"
+echo -e "${GREEN}  Data saved to data/concurrent_results.csv${NC}"
+
 # Generate plots
-echo -e "\n${YELLOW}[7/8] Generating plots for Part A...${NC}"
+echo -e "\n${YELLOW}[8/9] Generating plots for Part A...${NC}"
 if [ -f "scripts/plot_bst.py" ]; then
     python scripts/plot_bst.py > /dev/null 2>&1
     if [ $? -ne 0 ]; then
@@ -93,7 +105,7 @@ else
     echo -e "${YELLOW}⚠ scripts/plot_bst.py not found, skipping Part A plots${NC}"
 fi
 
-echo -e "\n${YELLOW}[8/8] Generating plots for Part B...${NC}"
+echo -e "\n${YELLOW}[9/9] Generating plots for Part B...${NC}"
 if [ -f "scripts/plot_os.py" ]; then
     python scripts/plot_os.py > /dev/null 2>&1
     if [ $? -ne 0 ]; then
@@ -113,5 +125,6 @@ echo -e "\n📊 Results:"
 echo -e "  ${YELLOW}Raw Data:${NC}"
 echo -e "    - data/bst_results.csv (Part A)"
 echo -e "    - data/os_results.csv (Part B)"
+echo -e "    - data/concurrent_results.csv (multi-threaded lookups)"
 echo -e "\n  ${YELLOW}Graphs:${NC}"
 echo -e "    - Check the graphs/ directory for all plots"
\ No newline at end of file
@@ -65,6 +65,8 @@ def parse_experiments(filename):
             elif 'Inorder Walk Comparison' in line and '===' in line:
                 current_experiment = 'inorder_comp'
                 experiments['comparison'][current_experiment] = []
+            elif '===' in line:
+                current_experiment = None  # extra sections (arena etc.) are not plotted here
         
         # Parse data lines
         if ',' in line and current_method and current_experiment:
@@ -191,17 +193,17 @@ def plot_all_comparisons(experiments):
     fig = plt.figure(figsize=(18, 12))
     
     # Colors and markers for each method
-    colors = ['red', 'blue', 'green', 'orange']
-    markers = ['s', 'o', '^', 'D']
-    methods = ['No Shuffle', 'Fisher-Yates', 'RANDOMIZE-IN-PLACE', 'PERMUTE-BY-SORTING']
-    linestyles = ['-', '-', '--', '-.']
+    colors = ['red', 'blue', 'green', 'orange', 'purple', 'black', 'brown']
+    markers = ['s', 'o', '^', 'D', 'v', 'x', '*']
+    methods = ['No Shuffle', 'Fisher-Yates', 'RANDOMIZE-IN-PLACE', 'PERMUTE-BY-SORTING', 'Red-Black (sorted)', 'Bulk load (sorted)', 'Hinted insert (sorted)']
+    linestyles = ['-', '-', '--', '-.', ':', '--', '-.']
     
     # Height comparison
     ax1 = plt.subplot(2, 3, 1)
     if 'height_comp' in experiments['comparison'] and len(experiments['comparison']['height_comp']) > 0:
         data = np.array(experiments['comparison']['height_comp'])
         n_values = data[:, 0]
-        for i in range(4):
+        for i in range(len(methods)):
             if i+1 < data.shape[1]:  # Check if column exists
                 ax1.plot(n_values, data[:, i+1], marker=markers[i], color=colors[i], 
                         markersize=5, label=methods[i], alpha=0.8, linewidth=2, linestyle=linestyles[i])
@@ -228,7 +230,7 @@ def plot_all_comparisons(experiments):
     if 'build_comp' in experiments['comparison'] and len(experiments['comparison']['build_comp']) > 0:
         data = np.array(experiments['comparison']['build_comp'])
         n_values = data[:, 0]
-        for i in range(4):
+        for i in range(len(methods)):
             if i+1 < data.shape[1]:  # Check if column exists
                 times = data[:, i+1]
                 # Filter out NaN values
@@ -409,10 +411,10 @@ def plot_individual_comparisons(experiments):
         return
 
     comp = experiments['comparison']
-    colors = ['red', 'blue', 'green', 'orange']
-    markers = ['s', 'o', '^', 'D']
-    methods = ['No Shuffle', 'Fisher-Yates', 'RANDOMIZE-IN-PLACE', 'PERMUTE-BY-SORTING']
-    linestyles = ['-', '-', '--', '-.']
+    colors = ['red', 'blue', 'green', 'orange', 'purple', 'black', 'brown']
+    markers = ['s', 'o', '^', 'D', 'v', 'x', '*']
+    methods = ['No Shuffle', 'Fisher-Yates', 'RANDOMIZE-IN-PLACE', 'PERMUTE-BY-SORTING', 'Red-Black (sorted)', 'Bulk load (sorted)', 'Hinted insert (sorted)']
+    linestyles = ['-', '-', '--', '-.', ':', '--', '-.']
 
     # 1. Height Comparison
     if 'height_comp' in comp and len(comp['height_comp']) > 0:
@@ -420,7 +422,7 @@ def plot_individual_comparisons(experiments):
         data = np.array(comp['height_comp'])
         n_values = data[:, 0]
 
-        for i in range(4):
+        for i in range(len(methods)):
             if i+1 < data.shape[1]:
                 plt.plot(n_values, data[:, i+1], marker=markers[i], color=colors[i],
                         markersize=5, label=methods[i], alpha=0.8, linewidth=2, linestyle=linestyles[i])
@@ -449,7 +451,7 @@ def plot_individual_comparisons(experiments):
         data = np.array(comp['build_comp'])
         n_values = data[:, 0]
 
-        for i in range(4):
+        for i in range(len(methods)):
             if i+1 < data.shape[1]:
                 times = data[:, i+1]
                 mask = ~np.isnan(times)
@@ -148,6 +148,9 @@ if select_data:
 
     fig, ax = plt.subplots(figsize=(10, 6))
     ax.plot(n_values, per_op_times, 'bo-', label='OS-Select (measured)', linewidth=2, markersize=6)
+    if len(select_data[n_values[0]]) >= 4:
+        ax.plot(n_values, [select_data[n][2] for n in n_values], 'gs--', label='Plain OS-Tree, sorted keys', linewidth=1.5, markersize=4)
+        ax.plot(n_values, [select_data[n][3] for n in n_values], 'k^-', label='Red-black OS-Tree, sorted keys', linewidth=1.5, markersize=4)
     ax.plot(n_values, theoretical_scaled, 'r--', label='O(log n) theoretical', linewidth=2)
     ax.set_xlabel('Tree Size (n)', fontsize=12)
     ax.set_ylabel('Time per Operation (μs)', fontsize=12)
@@ -178,6 +181,9 @@ if rank_data:
 
     fig, ax = plt.subplots(figsize=(10, 6))
     ax.plot(n_values, per_op_times, 'mo-', label='OS-Rank (measured)', linewidth=2, markersize=6)
+    if len(rank_data[n_values[0]]) >= 4:
+        ax.plot(n_values, [rank_data[n][2] for n in n_values], 'gs--', label='Plain OS-Tree, sorted keys', linewidth=1.5, markersize=4)
+        ax.plot(n_values, [rank_data[n][3] for n in n_values], 'k^-', label='Red-black OS-Tree, sorted keys', linewidth=1.5, markersize=4)
     ax.plot(n_values, theoretical_scaled, 'r--', label='O(log n) theoretical', linewidth=2)
     ax.set_xlabel('Tree Size (n)', fontsize=12)
     ax.set_ylabel('Time per Operation (μs)', fontsize=12)
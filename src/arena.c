@@ -0,0 +1,116 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/arena.h"
+
+#define ARENA_MIN_CAPACITY 64
+#define ARENA_MAX_CAPACITY (1 << 20) // cap slab growth at ~1M objects
+
+// first object in a slab sits right after the header
+static char* slab_data(ArenaSlab* s){
+    return (char*)(s + 1);
+}
+
+// new slab for the arena, becomes the head of the slab list
+static ArenaSlab* arena_add_slab(Arena* A){
+    size_t cap = A->next_capacity;
+    ArenaSlab* s = (ArenaSlab*)malloc(sizeof(ArenaSlab) + cap * A->obj_size);
+    if (s == NULL){
+        return NULL;
+    }
+    s->capacity = cap;
+    s->next = A->slabs;
+    A->slabs = s;
+    A->used = 0;
+
+    // grow geometrically so big trees only need a handful of slabs
+    if (A->next_capacity < ARENA_MAX_CAPACITY){
+        A->next_capacity *= 2;
+    }
+    return s;
+}
+
+Arena* arena_create(size_t obj_size, size_t first_capacity){
+    Arena* A = (Arena*)malloc(sizeof(Arena));
+
+    // free list links live inside free objects, keep them pointer aligned
+    if (obj_size < sizeof(void*)){
+        obj_size = sizeof(void*);
+    }
+    obj_size = (obj_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+    A->obj_size = obj_size;
+    A->next_capacity = first_capacity < ARENA_MIN_CAPACITY ? ARENA_MIN_CAPACITY : first_capacity;
+    A->slabs = NULL;
+    A->used = 0;
+    A->free_list = NULL;
+    return A;
+}
+
+void* arena_alloc(Arena* A){
+    // reuse something that was deleted first
+    if (A->free_list != NULL){
+        void* obj = A->free_list;
+        A->free_list = *(void**)obj;
+        return obj;
+    }
+
+    if (A->slabs == NULL || A->used == A->slabs->capacity){
+        if (arena_add_slab(A) == NULL){
+            return NULL;
+        }
+    }
+    return slab_data(A->slabs) + (A->used++) * A->obj_size;
+}
+
+// Contiguous run of objects (bulk loads): comes out of the newest slab if it
+// still fits, otherwise a fresh slab of at least count objects. An oversized
+// slab does not count as growth, later allocs go back to the normal sizes.
+void* arena_alloc_block(Arena* A, size_t count){
+    if (A->slabs == NULL || A->slabs->capacity - A->used < count){
+        size_t saved = A->next_capacity;
+        if (saved < count){
+            A->next_capacity = count;
+        }
+        ArenaSlab* s = arena_add_slab(A);
+        if (saved < count){
+            A->next_capacity = saved < ARENA_MAX_CAPACITY ? saved : ARENA_MAX_CAPACITY;
+        }
+        if (s == NULL){
+            return NULL;
+        }
+    }
+    void* block = slab_data(A->slabs) + A->used * A->obj_size;
+    A->used += count;
+    return block;
+}
+
+void arena_free(Arena* A, void* obj){
+    *(void**)obj = A->free_list;
+    A->free_list = obj;
+}
+
+// Forget all objects: only one free() per slab, not one per node
+void arena_reset(Arena* A){
+    if (A->slabs == NULL){
+        return;
+    }
+    ArenaSlab* s = A->slabs->next;
+    while (s != NULL){
+        ArenaSlab* next = s->next;
+        free(s);
+        s = next;
+    }
+    A->slabs->next = NULL;  // keep newest (biggest) slab for the next tree
+    A->used = 0;
+    A->free_list = NULL;
+}
+
+void arena_destroy(Arena* A){
+    ArenaSlab* s = A->slabs;
+    while (s != NULL){
+        ArenaSlab* next = s->next;
+        free(s);
+        s = next;
+    }
+    free(A);
+}
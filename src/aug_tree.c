@@ -0,0 +1,121 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/aug_tree.h"
+#include "../include/arena.h"
+
+#define AUG_VALUE(n) ((n)->value)
+
+#define AUG_NODE AugNode
+#define AUG_TREE AugTree
+#define AUG_PREFIX aug
+#define AUG_FIELDS(X)                               \
+    X(size, AUG_ONE, AUG_SUM, AUG_SUB)              \
+    X(sum, AUG_VALUE, AUG_SUM, AUG_SUB)             \
+    X(vmin, AUG_VALUE, AUG_MIN, AUG_RECOUNT)        \
+    X(vmax, AUG_VALUE, AUG_MAX, AUG_RECOUNT)
+#include "../include/augment.h"
+
+#define AUG_NODES_PER_FIRST_SLAB 1024
+
+AugTree* aug_tree_create(void){
+    AugTree* T = (AugTree*)malloc(sizeof(AugTree));
+    T->root = NULL;
+    T->arena = arena_create(sizeof(AugNode), AUG_NODES_PER_FIRST_SLAB);
+    return T;
+}
+
+void aug_tree_destroy(AugTree* T){
+    arena_destroy(T->arena);
+    free(T);
+}
+
+AugNode* aug_tree_insert(AugTree* T, int key, long long value){
+    AugNode* z = (AugNode*)arena_alloc(T->arena);
+    z->key = key;
+    z->value = value;
+    z->p = NULL;
+    aug_rb_insert(T, z);
+    return z;
+}
+
+void aug_tree_delete(AugTree* T, AugNode* z){
+    aug_rb_delete(T, z);
+    arena_free(T->arena, z);
+}
+
+// Shape unchanged, so a recount of x and its ancestors is all it takes
+void aug_tree_set_value(AugTree* T, AugNode* x, long long value){
+    (void)T;
+    x->value = value;
+    aug_pull_up(x);
+}
+
+AugNode* aug_select(AugTree* T, int i){
+    AugNode* x = T->root;
+    while (x != NULL){
+        int r = (x->left ? x->left->size : 0) + 1;
+        if (i == r)
+            return x;
+        if (i < r)
+            x = x->left;
+        else{
+            i -= r;
+            x = x->right;
+        }
+    }
+    return NULL;
+}
+
+// os_select with sum in place of size: w counts down as whole left
+// subtrees and nodes are passed over. NULL if w <= 0 or w > aug_total
+AugNode* aug_select_weight(AugTree* T, long long w){
+    if (w <= 0)
+        return NULL;
+    AugNode* x = T->root;
+    while (x != NULL){
+        long long left = x->left ? x->left->sum : 0;
+        if (w <= left)
+            x = x->left;
+        else if (w <= left + x->value)
+            return x;
+        else{
+            w -= left + x->value;
+            x = x->right;
+        }
+    }
+    return NULL;
+}
+
+long long aug_total(AugTree* T){
+    return T->root ? T->root->sum : 0;
+}
+
+int aug_tree_range(AugTree* T, int lo, int hi, AugNode* out){
+    return aug_range(T->root, lo, hi, out);
+}
+
+static int aug_black_height(AugNode* x, int* ok){
+    if (x == NULL)
+        return 1;
+    if (!aug_consistent(x))
+        *ok = 0;
+    if (aug_is_red(x) && (aug_is_red(x->left) || aug_is_red(x->right)))
+        *ok = 0;
+    if ((x->left && (x->left->p != x || x->left->key > x->key)) ||
+        (x->right && (x->right->p != x || x->right->key < x->key)))
+        *ok = 0;
+    int l = aug_black_height(x->left, ok);
+    int r = aug_black_height(x->right, ok);
+    if (l != r)
+        *ok = 0;
+    return l + (x->color == AUG_BLACK);
+}
+
+// recursion is fine here, red-black height is O(log n)
+int aug_tree_validate(AugTree* T){
+    int ok = 1;
+    if (aug_is_red(T->root))
+        ok = 0;
+    aug_black_height(T->root, &ok);
+    return ok;
+}
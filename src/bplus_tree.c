@@ -0,0 +1,563 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "../include/bplus_tree.h"
+
+#define CACHE_LINE 64
+#define LEAF_MIN (BPT_LEAF_KEYS / 2)
+#define INNER_MIN (BPT_INNER_KEYS / 2)
+
+_Static_assert(sizeof(BPlusLeaf) <= BPT_NODE_BYTES, "leaf bigger than BPT_NODE_BYTES");
+_Static_assert(sizeof(BPlusInner) <= BPT_NODE_BYTES, "inner node bigger than BPT_NODE_BYTES");
+_Static_assert(BPT_INNER_KEYS >= 3, "BPT_NODE_BYTES too small for a useful fanout");
+
+// Nodes start on a cache line so a node never straddles one line more than it has to
+static void* node_alloc(void){
+    return aligned_alloc(CACHE_LINE, (BPT_NODE_BYTES + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+}
+
+static BPlusLeaf* leaf_create(void){
+    BPlusLeaf* L = (BPlusLeaf*)node_alloc();
+    L->n = 0;
+    L->prev = NULL;
+    L->next = NULL;
+    return L;
+}
+
+static BPlusInner* inner_create(void){
+    BPlusInner* I = (BPlusInner*)node_alloc();
+    I->n = 0;
+    return I;
+}
+
+// first i with keys[i] >= key (binary search, the keys are sorted)
+static int lower_index(const int* keys, int n, int key){
+    int lo = 0, hi = n;
+    while (lo < hi){
+        int mid = (lo + hi) >> 1;
+        if (keys[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// first i with keys[i] > key
+static int upper_index(const int* keys, int n, int key){
+    int lo = 0, hi = n;
+    while (lo < hi){
+        int mid = (lo + hi) >> 1;
+        if (keys[mid] <= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// keys under node x sitting `level` levels above the leaves
+static int subtree_count(void* x, int level){
+    if (level == 0)
+        return ((BPlusLeaf*)x)->n;
+    BPlusInner* I = (BPlusInner*)x;
+    int c = 0;
+    for (int j = 0; j <= I->n; j++)
+        c += I->counts[j];
+    return c;
+}
+
+BPlusTree* bpt_create(int counted){
+    BPlusTree* T = (BPlusTree*)malloc(sizeof(BPlusTree));
+    T->root = leaf_create();
+    T->height = 0;
+    T->counted = counted;
+    T->n = 0;
+    return T;
+}
+
+// Height is small (log_16 n), so plain recursion is fine here
+static void destroy_subtree(void* x, int level){
+    if (level > 0){
+        BPlusInner* I = (BPlusInner*)x;
+        for (int j = 0; j <= I->n; j++)
+            destroy_subtree(I->child[j], level - 1);
+    }
+    free(x);
+}
+
+void bpt_destroy(BPlusTree* T){
+    destroy_subtree(T->root, T->height);
+    free(T);
+}
+
+// Insert: go down by upper bound (so duplicates land after equal keys),
+// remembering the path, then split full nodes on the way back up
+void bpt_insert(BPlusTree* T, int key){
+    BPlusInner* path[BPT_MAX_HEIGHT];
+    int idx[BPT_MAX_HEIGHT];
+    int depth = 0;
+    void* x = T->root;
+
+    for (int h = T->height; h > 0; h--){
+        BPlusInner* I = (BPlusInner*)x;
+        int c = upper_index(I->keys, I->n, key);
+        if (T->counted)
+            I->counts[c]++;
+        path[depth] = I;
+        idx[depth] = c;
+        depth++;
+        x = I->child[c];
+    }
+
+    BPlusLeaf* L = (BPlusLeaf*)x;
+    int pos = upper_index(L->keys, L->n, key);
+    T->n++;
+
+    if (L->n < BPT_LEAF_KEYS){
+        memmove(L->keys + pos + 1, L->keys + pos, (L->n - pos) * sizeof(int));
+        L->keys[pos] = key;
+        L->n++;
+        return;
+    }
+
+    // full leaf -> move the upper half into a new right sibling, then insert
+    BPlusLeaf* R = leaf_create();
+    int mid = (BPT_LEAF_KEYS + 1) / 2;
+    R->n = BPT_LEAF_KEYS - mid;
+    memcpy(R->keys, L->keys + mid, R->n * sizeof(int));
+    L->n = mid;
+    R->next = L->next;
+    R->prev = L;
+    if (L->next)
+        L->next->prev = R;
+    L->next = R;
+
+    BPlusLeaf* target = (pos <= mid) ? L : R;
+    if (target == R)
+        pos -= mid;
+    memmove(target->keys + pos + 1, target->keys + pos, (target->n - pos) * sizeof(int));
+    target->keys[pos] = key;
+    target->n++;
+
+    // hand (separator, new right node) to the parent until someone has room
+    int sep = R->keys[0];
+    void* right = R;
+    int left_count = L->n;
+    int right_count = R->n;
+
+    while (depth > 0){
+        depth--;
+        BPlusInner* P = path[depth];
+        int c = idx[depth];
+
+        if (P->n < BPT_INNER_KEYS){
+            memmove(P->keys + c + 1, P->keys + c, (P->n - c) * sizeof(int));
+            memmove(P->child + c + 2, P->child + c + 1, (P->n - c) * sizeof(void*));
+            memmove(P->counts + c + 2, P->counts + c + 1, (P->n - c) * sizeof(int));
+            P->keys[c] = sep;
+            P->child[c + 1] = right;
+            P->counts[c] = left_count;
+            P->counts[c + 1] = right_count;
+            P->n++;
+            return;
+        }
+
+        // full inner node: lay out all K+1 keys / K+2 children, then cut in two
+        int keys[BPT_INNER_KEYS + 1];
+        int counts[BPT_INNER_KEYS + 2];
+        void* child[BPT_INNER_KEYS + 2];
+        memcpy(keys, P->keys, c * sizeof(int));
+        keys[c] = sep;
+        memcpy(keys + c + 1, P->keys + c, (P->n - c) * sizeof(int));
+        memcpy(child, P->child, (c + 1) * sizeof(void*));
+        child[c + 1] = right;
+        memcpy(child + c + 2, P->child + c + 1, (P->n - c) * sizeof(void*));
+        memcpy(counts, P->counts, c * sizeof(int));
+        counts[c] = left_count;
+        counts[c + 1] = right_count;
+        memcpy(counts + c + 2, P->counts + c + 1, (P->n - c) * sizeof(int));
+
+        int m = (BPT_INNER_KEYS + 1) / 2;     // keys[m] moves up
+        BPlusInner* Q = inner_create();
+        P->n = m;
+        memcpy(P->keys, keys, m * sizeof(int));
+        memcpy(P->child, child, (m + 1) * sizeof(void*));
+        memcpy(P->counts, counts, (m + 1) * sizeof(int));
+        Q->n = BPT_INNER_KEYS - m;
+        memcpy(Q->keys, keys + m + 1, Q->n * sizeof(int));
+        memcpy(Q->child, child + m + 1, (Q->n + 1) * sizeof(void*));
+        memcpy(Q->counts, counts + m + 1, (Q->n + 1) * sizeof(int));
+
+        sep = keys[m];
+        right = Q;
+        if (T->counted){
+            left_count = subtree_count(P, 1);
+            right_count = subtree_count(Q, 1);
+        }
+    }
+
+    // root split -> tree grows one level
+    BPlusInner* root = inner_create();
+    root->n = 1;
+    root->keys[0] = sep;
+    root->child[0] = T->root;
+    root->child[1] = right;
+    root->counts[0] = left_count;
+    root->counts[1] = right_count;
+    T->root = root;
+    T->height++;
+}
+
+// Drop keys[k] and child[k+1] from an inner node
+static void inner_remove(BPlusInner* P, int k){
+    memmove(P->keys + k, P->keys + k + 1, (P->n - k - 1) * sizeof(int));
+    memmove(P->child + k + 1, P->child + k + 2, (P->n - k - 1) * sizeof(void*));
+    memmove(P->counts + k + 1, P->counts + k + 2, (P->n - k - 1) * sizeof(int));
+    P->n--;
+}
+
+// Leaf below P->child[c] is short a key: borrow from a sibling or merge with one
+static void fix_leaf(BPlusTree* T, BPlusInner* P, int c){
+    BPlusLeaf* L = (BPlusLeaf*)P->child[c];
+    BPlusLeaf* S;
+
+    if (c > 0 && (S = (BPlusLeaf*)P->child[c - 1])->n > LEAF_MIN){
+        memmove(L->keys + 1, L->keys, L->n * sizeof(int));
+        L->keys[0] = S->keys[--S->n];
+        L->n++;
+        P->keys[c - 1] = L->keys[0];
+        if (T->counted){
+            P->counts[c - 1]--;
+            P->counts[c]++;
+        }
+        return;
+    }
+    if (c < P->n && (S = (BPlusLeaf*)P->child[c + 1])->n > LEAF_MIN){
+        L->keys[L->n++] = S->keys[0];
+        memmove(S->keys, S->keys + 1, (--S->n) * sizeof(int));
+        P->keys[c] = S->keys[0];
+        if (T->counted){
+            P->counts[c + 1]--;
+            P->counts[c]++;
+        }
+        return;
+    }
+
+    // both siblings at the minimum -> merge the right one of the pair into the left
+    if (c == P->n)
+        c--;
+    BPlusLeaf* A = (BPlusLeaf*)P->child[c];
+    BPlusLeaf* B = (BPlusLeaf*)P->child[c + 1];
+    memcpy(A->keys + A->n, B->keys, B->n * sizeof(int));
+    A->n += B->n;
+    A->next = B->next;
+    if (B->next)
+        B->next->prev = A;
+    if (T->counted)
+        P->counts[c] += P->counts[c + 1];
+    inner_remove(P, c);
+    free(B);
+}
+
+// Same for an inner node: rotate a child through the parent, or merge around the separator
+static void fix_inner(BPlusTree* T, BPlusInner* P, int c){
+    BPlusInner* X = (BPlusInner*)P->child[c];
+    BPlusInner* S;
+
+    if (c > 0 && (S = (BPlusInner*)P->child[c - 1])->n > INNER_MIN){
+        memmove(X->keys + 1, X->keys, X->n * sizeof(int));
+        memmove(X->child + 1, X->child, (X->n + 1) * sizeof(void*));
+        memmove(X->counts + 1, X->counts, (X->n + 1) * sizeof(int));
+        X->keys[0] = P->keys[c - 1];
+        X->child[0] = S->child[S->n];
+        X->counts[0] = S->counts[S->n];
+        X->n++;
+        P->keys[c - 1] = S->keys[S->n - 1];
+        S->n--;
+        if (T->counted){
+            P->counts[c - 1] -= X->counts[0];
+            P->counts[c] += X->counts[0];
+        }
+        return;
+    }
+    if (c < P->n && (S = (BPlusInner*)P->child[c + 1])->n > INNER_MIN){
+        X->keys[X->n] = P->keys[c];
+        X->child[X->n + 1] = S->child[0];
+        X->counts[X->n + 1] = S->counts[0];
+        X->n++;
+        P->keys[c] = S->keys[0];
+        int moved = S->counts[0];
+        memmove(S->keys, S->keys + 1, (S->n - 1) * sizeof(int));
+        memmove(S->child, S->child + 1, S->n * sizeof(void*));
+        memmove(S->counts, S->counts + 1, S->n * sizeof(int));
+        S->n--;
+        if (T->counted){
+            P->counts[c + 1] -= moved;
+            P->counts[c] += moved;
+        }
+        return;
+    }
+
+    if (c == P->n)
+        c--;
+    BPlusInner* A = (BPlusInner*)P->child[c];
+    BPlusInner* B = (BPlusInner*)P->child[c + 1];
+    A->keys[A->n] = P->keys[c];
+    memcpy(A->keys + A->n + 1, B->keys, B->n * sizeof(int));
+    memcpy(A->child + A->n + 1, B->child, (B->n + 1) * sizeof(void*));
+    memcpy(A->counts + A->n + 1, B->counts, (B->n + 1) * sizeof(int));
+    A->n += B->n + 1;
+    if (T->counted)
+        P->counts[c] += P->counts[c + 1];
+    inner_remove(P, c);
+    free(B);
+}
+
+// Delete: go down by lower bound. If the leaf we land in ends before key,
+// the first copy can only be at the start of the next leaf (separator == key),
+// so step the path over to it before removing.
+int bpt_delete(BPlusTree* T, int key){
+    BPlusInner* path[BPT_MAX_HEIGHT];
+    int idx[BPT_MAX_HEIGHT];
+    int depth = 0;
+    void* x = T->root;
+
+    for (int h = T->height; h > 0; h--){
+        BPlusInner* I = (BPlusInner*)x;
+        int c = lower_index(I->keys, I->n, key);
+        path[depth] = I;
+        idx[depth] = c;
+        depth++;
+        x = I->child[c];
+    }
+
+    BPlusLeaf* L = (BPlusLeaf*)x;
+    int pos = lower_index(L->keys, L->n, key);
+    if (pos == L->n){
+        int d = depth - 1;
+        while (d >= 0 && idx[d] == path[d]->n)
+            d--;
+        if (d < 0)
+            return 0;
+        idx[d]++;
+        x = path[d]->child[idx[d]];
+        for (d = d + 1; d < depth; d++){
+            path[d] = (BPlusInner*)x;
+            idx[d] = 0;
+            x = path[d]->child[0];
+        }
+        L = (BPlusLeaf*)x;
+        pos = 0;
+    }
+    if (pos == L->n || L->keys[pos] != key)
+        return 0;
+
+    memmove(L->keys + pos, L->keys + pos + 1, (L->n - pos - 1) * sizeof(int));
+    L->n--;
+    T->n--;
+    if (T->counted)
+        for (int d = 0; d < depth; d++)
+            path[d]->counts[idx[d]]--;
+
+    // fix underfull nodes bottom-up; the root is allowed to be small
+    if (depth > 0 && L->n < LEAF_MIN){
+        depth--;
+        fix_leaf(T, path[depth], idx[depth]);
+        while (depth > 0 && path[depth]->n < INNER_MIN){
+            depth--;
+            fix_inner(T, path[depth], idx[depth]);
+        }
+    }
+
+    // root with a single child -> tree shrinks one level
+    if (T->height > 0 && ((BPlusInner*)T->root)->n == 0){
+        BPlusInner* old = (BPlusInner*)T->root;
+        T->root = old->child[0];
+        T->height--;
+        free(old);
+    }
+    return 1;
+}
+
+BPlusPos bpt_lower_bound(BPlusTree* T, int key){
+    void* x = T->root;
+    for (int h = T->height; h > 0; h--){
+        BPlusInner* I = (BPlusInner*)x;
+        x = I->child[lower_index(I->keys, I->n, key)];
+    }
+    BPlusPos r;
+    r.leaf = (BPlusLeaf*)x;
+    r.i = lower_index(r.leaf->keys, r.leaf->n, key);
+    if (r.i == r.leaf->n){      // answer (if any) starts the next leaf
+        r.leaf = r.leaf->next;
+        r.i = 0;
+    }
+    return r;
+}
+
+BPlusPos bpt_search(BPlusTree* T, int key){
+    BPlusPos r = bpt_lower_bound(T, key);
+    if (r.leaf && bpt_key(r) != key)
+        r.leaf = NULL;
+    return r;
+}
+
+BPlusPos bpt_min(BPlusTree* T){
+    void* x = T->root;
+    for (int h = T->height; h > 0; h--)
+        x = ((BPlusInner*)x)->child[0];
+    BPlusPos r = { (BPlusLeaf*)x, 0 };
+    if (r.leaf->n == 0)
+        r.leaf = NULL;
+    return r;
+}
+
+BPlusPos bpt_max(BPlusTree* T){
+    void* x = T->root;
+    for (int h = T->height; h > 0; h--)
+        x = ((BPlusInner*)x)->child[((BPlusInner*)x)->n];
+    BPlusPos r = { (BPlusLeaf*)x, ((BPlusLeaf*)x)->n - 1 };
+    if (r.leaf->n == 0)
+        r.leaf = NULL;
+    return r;
+}
+
+BPlusPos bpt_successor(BPlusPos x){
+    if (++x.i == x.leaf->n){
+        x.leaf = x.leaf->next;
+        x.i = 0;
+    }
+    return x;
+}
+
+BPlusPos bpt_predecessor(BPlusPos x){
+    if (--x.i < 0){
+        x.leaf = x.leaf->prev;
+        x.i = x.leaf ? x.leaf->n - 1 : 0;
+    }
+    return x;
+}
+
+void bpt_inorder_walk(BPlusTree* T){
+    for (BPlusLeaf* L = bpt_min(T).leaf; L != NULL; L = L->next)
+        for (int j = 0; j < L->n; j++)
+            printf("%d ", L->keys[j]);
+}
+
+int bpt_to_array(BPlusTree* T, int* out){
+    int k = 0;
+    for (BPlusLeaf* L = bpt_min(T).leaf; L != NULL; L = L->next){
+        memcpy(out + k, L->keys, L->n * sizeof(int));
+        k += L->n;
+    }
+    return k;
+}
+
+// OS-SELECT: skip whole children by their counts, then index into the leaf
+BPlusPos bpt_select(BPlusTree* T, int i){
+    BPlusPos r = { NULL, 0 };
+    if (i < 1 || i > T->n)
+        return r;
+
+    if (!T->counted){
+        BPlusLeaf* L = bpt_min(T).leaf;
+        while (i > L->n){
+            i -= L->n;
+            L = L->next;
+        }
+        r.leaf = L;
+        r.i = i - 1;
+        return r;
+    }
+
+    void* x = T->root;
+    for (int h = T->height; h > 0; h--){
+        BPlusInner* I = (BPlusInner*)x;
+        int c = 0;
+        while (i > I->counts[c]){
+            i -= I->counts[c];
+            c++;
+        }
+        x = I->child[c];
+    }
+    r.leaf = (BPlusLeaf*)x;
+    r.i = i - 1;
+    return r;
+}
+
+// OS-RANK by key: add the counts of every child we pass on the left
+int bpt_rank(BPlusTree* T, int key){
+    int r = 1;
+
+    if (!T->counted){
+        BPlusLeaf* L = bpt_min(T).leaf;
+        for (; L != NULL && L->n > 0 && L->keys[L->n - 1] < key; L = L->next)
+            r += L->n;
+        if (L != NULL)
+            r += lower_index(L->keys, L->n, key);
+        return r;
+    }
+
+    void* x = T->root;
+    for (int h = T->height; h > 0; h--){
+        BPlusInner* I = (BPlusInner*)x;
+        int c = lower_index(I->keys, I->n, key);
+        for (int j = 0; j < c; j++)
+            r += I->counts[j];
+        x = I->child[c];
+    }
+    BPlusLeaf* L = (BPlusLeaf*)x;
+    return r + lower_index(L->keys, L->n, key);
+}
+
+// Checks node x (level levels up) and returns its key count, -1 on any problem.
+// lo/hi bound the keys allowed under x, has_lo/has_hi say if the bound exists.
+static int validate_subtree(BPlusTree* T, void* x, int level, int is_root,
+                            int has_lo, int lo, int has_hi, int hi){
+    if (level == 0){
+        BPlusLeaf* L = (BPlusLeaf*)x;
+        if (!is_root && (L->n < LEAF_MIN || L->n > BPT_LEAF_KEYS))
+            return -1;
+        for (int j = 0; j < L->n; j++){
+            if (j > 0 && L->keys[j - 1] > L->keys[j]) return -1;
+            if (has_lo && L->keys[j] < lo) return -1;
+            if (has_hi && L->keys[j] > hi) return -1;
+        }
+        return L->n;
+    }
+
+    BPlusInner* I = (BPlusInner*)x;
+    if (I->n > BPT_INNER_KEYS || I->n < (is_root ? 1 : INNER_MIN))
+        return -1;
+    int total = 0;
+    for (int j = 0; j <= I->n; j++){
+        if (j > 0 && j < I->n && I->keys[j - 1] > I->keys[j])
+            return -1;
+        int c = validate_subtree(T, I->child[j], level - 1, 0,
+                                 j > 0 ? 1 : has_lo, j > 0 ? I->keys[j - 1] : lo,
+                                 j < I->n ? 1 : has_hi, j < I->n ? I->keys[j] : hi);
+        if (c < 0 || (T->counted && c != I->counts[j]))
+            return -1;
+        total += c;
+    }
+    return total;
+}
+
+int bpt_validate(BPlusTree* T){
+    if (validate_subtree(T, T->root, T->height, 1, 0, 0, 0, 0) != T->n)
+        return -1;
+
+    // leaf chain has to visit exactly n keys in order, with prev mirroring next
+    int seen = 0;
+    BPlusLeaf* prev = NULL;
+    for (BPlusLeaf* L = bpt_min(T).leaf; L != NULL; L = L->next){
+        if (L->prev != prev)
+            return -1;
+        if (prev && prev->keys[prev->n - 1] > L->keys[0])
+            return -1;
+        seen += L->n;
+        prev = L;
+    }
+    return (seen == T->n) ? T->height : -1;
+}
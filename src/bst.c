@@ -1,11 +1,21 @@
 #include "stdio.h"
 #include "stdlib.h"
+#include "assert.h"
+#include "math.h"
+#include "limits.h"
 #include "../include/bst.h"
+#include "../include/arena.h"
+#include "../include/utils.h"
+#include "../include/key_stream.h"
+
+#define NODES_PER_FIRST_SLAB 1024
+#define BATCH_IN_FLIGHT 16    // lookups kept in flight by tree_search_batch
 
 //Create node with given key val
 Node* create_node(int key){
     Node* z = (Node*)malloc(sizeof(Node)); //mem alloc for new code
     z->key = key; // set key val for node
+    z->color = 0; // red, only rb_tree.c looks at it
     z->left = NULL; // left child null
     z->right = NULL; // right child null
     z->p = NULL; // parent null
@@ -16,15 +26,254 @@ Node* create_node(int key){
 Tree* create_tree(void){
     Tree* T = (Tree*)malloc(sizeof(Tree)); //mem aloc for new tree
     T->root = NULL; // root is null
+    T->arena = NULL; // nodes are malloc'd one by one
+    T->sg_alpha = 0; // plain BST until tree_set_scapegoat
+    T->sg_size = 0;
+    T->sg_max_size = 0;
+    tree_forget_ends(T); // ends unknown until an insert or hinted insert finds them
+    return T;
+}
+
+//Tree that owns a node arena -> nodes end up next to each other in memory
+Tree* create_arena_tree(void){
+    Tree* T = create_tree();
+    T->arena = arena_create(sizeof(Node), NODES_PER_FIRST_SLAB);
+    return T;
+}
+
+//Same as create_node but takes the memory from T's arena
+Node* tree_alloc_node(Tree* T, int key){
+    if (T->arena == NULL){
+        return create_node(key);
+    }
+    Node* z = (Node*)arena_alloc(T->arena);
+    z->key = key;
+    z->color = 0;
+    z->left = NULL;
+    z->right = NULL;
+    z->p = NULL;
+    return z;
+}
+
+// Middle key of keys[lo..hi] becomes the root of that range, so sibling
+// subtrees differ in size by at most one -> minimum height. Recursion depth
+// is only lg n. Nodes on the deepest level are coloured red, everything else
+// black, which makes the result a valid red-black tree as well.
+static Node* build_range(Node* nodes, int* keys, int lo, int hi, Node* parent, int depth, int red_depth){
+    if (lo > hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    Node* x = &nodes[mid];   // node i holds keys[i] -> memory order == key order
+    x->key = keys[mid];
+    x->color = (depth == red_depth) ? 0 : 1;
+    x->p = parent;
+    x->left = build_range(nodes, keys, lo, mid - 1, x, depth + 1, red_depth);
+    x->right = build_range(nodes, keys, mid + 1, hi, x, depth + 1, red_depth);
+    return x;
+}
+
+//O(n) bulk load of sorted keys into a perfectly balanced arena tree,
+//all n nodes come from one block (free it with destroy_arena_tree)
+Tree* tree_build_from_sorted(int* keys, int n){
+    Tree* T = create_tree();
+    T->arena = arena_create(sizeof(Node), NODES_PER_FIRST_SLAB); // the block below gets its own slab
+    if (n <= 0)
+        return T;
+
+    int height = 0;              // floor(lg n) + 1 levels
+    while ((1 << height) <= n && height < 31)
+        height++;
+    Node* nodes = (Node*)arena_alloc_block(T->arena, n);
+    T->root = build_range(nodes, keys, 0, n - 1, NULL, 0, height > 1 ? height - 1 : -1);
+    return T;
+}
+
+// Same layout as build_range, but the keys are pulled from a key file in
+// order while the nodes are laid out: in-order position mid gets the mid-th key
+typedef struct StreamBuild {
+    KeyStream* S;
+    int last;
+    int bad;          // ran out of keys or they were not ascending
+} StreamBuild;
+
+static Node* stream_range(StreamBuild* b, Node* nodes, int lo, int hi, Node* parent, int depth, int red_depth){
+    if (lo > hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    Node* x = &nodes[mid];
+    x->color = (depth == red_depth) ? 0 : 1;
+    x->p = parent;
+    x->left = stream_range(b, nodes, lo, mid - 1, x, depth + 1, red_depth);
+    int key = 0;
+    if (!key_stream_get(b->S, &key) || (mid > 0 && key < b->last))
+        b->bad = 1;
+    x->key = key;
+    b->last = key;
+    x->right = stream_range(b, nodes, mid + 1, hi, x, depth + 1, red_depth);
+    return x;
+}
+
+// Bulk load from the rest of a sorted key file, no key array in between.
+// NULL if a key is out of order or was skipped (64-bit key outside int).
+Tree* tree_build_from_stream(KeyStream* S){
+    size_t left = S->count - S->pos;
+    if (left > INT_MAX)
+        return NULL;
+    int n = (int)left;
+    Tree* T = create_tree();
+    T->arena = arena_create(sizeof(Node), NODES_PER_FIRST_SLAB); // the block below gets its own slab
+    if (n == 0)
+        return T;
+
+    int height = 0;
+    while ((1 << height) <= n && height < 31)
+        height++;
+    Node* nodes = (Node*)arena_alloc_block(T->arena, n);
+    StreamBuild b = {S, 0, 0};
+    T->root = stream_range(&b, nodes, 0, n - 1, NULL, 0, height > 1 ? height - 1 : -1);
+    if (b.bad){
+        destroy_arena_tree(T);
+        return NULL;
+    }
+    return T;
+}
+
+// Rest of the key file into T in file order, chunk by chunk straight off the
+// mapping. Nodes from T's arena when it has one. Returns keys inserted.
+long tree_insert_stream(Tree* T, KeyStream* S){
+    long inserted = 0;
+    size_t got;
+    const int* keys;
+    while ((keys = key_stream_next(S, 0, &got)) != NULL){
+        for (size_t i = 0; i < got; i++)
+            tree_insert(T, tree_alloc_node(T, keys[i]));
+        inserted += (long)got;
+    }
+    return inserted;
+}
+
+// Parallel bulk load: the top levels of build_range are laid out here and every
+// range hanging below them becomes a task. The ranges are disjoint slices of
+// the one node block, so each thread writes its own part of memory and no
+// locking is needed. The result is the same tree tree_build_from_sorted gives.
+typedef struct BuildTask {
+    int lo, hi;       // key range of the subtree
+    Node* parent;
+    Node** link;      // parent's child pointer (or &T->root)
+    int depth;
+} BuildTask;
+
+typedef struct BuildCtx {
+    Node* nodes;
+    int* keys;
+    int red_depth;
+    BuildTask* tasks;
+} BuildCtx;
+
+static void build_spine(BuildCtx* c, int lo, int hi, Node* parent, Node** link, int depth, int cut, int* ntasks){
+    if (lo > hi){
+        *link = NULL;
+        return;
+    }
+    if (depth == cut){
+        BuildTask* t = &c->tasks[(*ntasks)++];
+        t->lo = lo;
+        t->hi = hi;
+        t->parent = parent;
+        t->link = link;
+        t->depth = depth;
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    Node* x = &c->nodes[mid];
+    x->key = c->keys[mid];
+    x->color = (depth == c->red_depth) ? 0 : 1;
+    x->p = parent;
+    *link = x;
+    build_spine(c, lo, mid - 1, x, &x->left, depth + 1, cut, ntasks);
+    build_spine(c, mid + 1, hi, x, &x->right, depth + 1, cut, ntasks);
+}
+
+static void build_task(void* arg, int task){
+    BuildCtx* c = (BuildCtx*)arg;
+    BuildTask* t = &c->tasks[task];
+    *t->link = build_range(c->nodes, c->keys, t->lo, t->hi, t->parent, t->depth, c->red_depth);
+}
+
+Tree* tree_build_parallel(int* keys, int n, int threads){
+    if (threads < 1)
+        threads = 1;
+    parallel_sort(keys, n, threads);
+
+    Tree* T = create_tree();
+    T->arena = arena_create(sizeof(Node), NODES_PER_FIRST_SLAB); // the block below gets its own slab
+    if (n <= 0)
+        return T;
+
+    int height = 0;
+    while ((1 << height) <= n && height < 31)
+        height++;
+    int cut = 0;                 // 2^cut >= 4 * threads subtrees -> even split, a few spare for stragglers
+    while ((1 << cut) < 4 * threads && cut < height - 1)
+        cut++;
+
+    BuildCtx c;
+    c.nodes = (Node*)arena_alloc_block(T->arena, n);
+    c.keys = keys;
+    c.red_depth = height > 1 ? height - 1 : -1;
+    c.tasks = (BuildTask*)malloc(((size_t)1 << cut) * sizeof(BuildTask));
+    int ntasks = 0;
+    build_spine(&c, 0, n - 1, NULL, &T->root, 0, cut, &ntasks);
+    parallel_for(threads, ntasks, build_task, &c);
+    free(c.tasks);
     return T;
 }
 
+//Node already unlinked with tree_delete -> back onto the free list
+void tree_free_node(Tree* T, Node* z){
+    if (T->arena == NULL){
+        free(z);
+    }
+    else{
+        arena_free(T->arena, z);
+    }
+}
+
+//Empty the tree with one arena reset so the slabs get reused
+void reset_arena_tree(Tree* T){
+    if (T->arena != NULL){
+        arena_reset(T->arena);
+    }
+    else{
+        destroy_tree(T->root);
+    }
+    T->root = NULL;
+    tree_forget_ends(T);
+    T->sg_size = 0;
+    T->sg_max_size = 0;
+}
+
+//One arena teardown instead of a free() per node
+void destroy_arena_tree(Tree* T){
+    if (T->arena != NULL){
+        arena_destroy(T->arena);
+    }
+    else{
+        destroy_tree(T->root);
+    }
+    free(T);
+}
+
+static void scapegoat_check(Tree* T, Node* z, int depth); // below, with the rebuild code
+
 void tree_insert(Tree* T, Node* z){
     Node* y = NULL;
     Node* x = T->root;
+    int depth = 0; // edges from the root down to z, for scapegoat mode
 
     while(x != NULL){
         y=x;
+        depth++;
         if(z->key < x->key){
             x = x->left;
         }
@@ -36,12 +285,95 @@ void tree_insert(Tree* T, Node* z){
     z->p = y;
     if (y == NULL){
         T->root = z;
+        T->leftmost = T->rightmost = z;
     }
     else if (z->key < y->key){
         y->left = z;
+        if (y == T->leftmost)
+            T->leftmost = z;
     }
     else{
         y->right = z;
+        if (y == T->rightmost)
+            T->rightmost = z;
+    }
+
+    if (T->sg_alpha > 0)
+        scapegoat_check(T, z, depth);
+}
+
+// Lowest node on hint's path to the root whose key range holds key; z's spot
+// is below it. A node's upper bound is the nearest ancestor that has it in its
+// left subtree (lower bound: right subtree), so climb run by run until the key
+// fits. A neighbour hint stops at once, a far one costs the climb it takes.
+// The cached ends cover the sorted append: hint == max has no bound to look for.
+static Node* hint_start(Tree* T, Node* hint, int key){
+    Node* a = hint;
+    if (key >= hint->key){
+        if (T->rightmost == NULL)
+            T->rightmost = tree_max(T->root);
+        assert(T->rightmost->right == NULL);    // a stale cache: some linker forgot tree_forget_ends
+        if (hint == T->rightmost)
+            return hint;
+        for (;;){
+            Node* c = a;
+            Node* p = a->p;
+            while (p != NULL && c == p->right){
+                c = p;
+                p = p->p;
+            }
+            if (p == NULL || key < p->key)
+                return a;
+            a = p;
+        }
+    }
+    if (T->leftmost == NULL)
+        T->leftmost = tree_min(T->root);
+    assert(T->leftmost->left == NULL);
+    if (hint == T->leftmost)
+        return hint;
+    for (;;){
+        Node* c = a;
+        Node* p = a->p;
+        while (p != NULL && c == p->left){
+            c = p;
+            p = p->p;
+        }
+        if (p == NULL || key >= p->key)
+            return a;
+        a = p;
+    }
+}
+
+// Hinted insert (std::map::emplace_hint): start at the finger instead of the root.
+// For a sorted stream with the previous insert as hint this is O(1) per key.
+// hint has to be a node of T; a hint far from z's spot only costs time.
+void tree_insert_hint(Tree* T, Node* hint, Node* z){
+    if (hint == NULL){
+        tree_insert(T, z);      // no hint -> normal walk from the root
+        return;
+    }
+    Node* y = NULL;
+    Node* x = hint_start(T, hint, z->key);
+    while (x != NULL){
+        y = x;
+        x = (z->key < x->key) ? x->left : x->right;
+    }
+    z->p = y;
+    if (z->key < y->key)
+        y->left = z;
+    else
+        y->right = z;
+    if (y == T->rightmost && z == y->right)
+        T->rightmost = z;
+    else if (y == T->leftmost && z == y->left)
+        T->leftmost = z;
+
+    if (T->sg_alpha > 0){
+        int depth = 0;      // no descent from the root to count on, so climb (O(log n) in this mode)
+        for (Node* a = z; a->p != NULL; a = a->p)
+            depth++;
+        scapegoat_check(T, z, depth);
     }
 }
 
@@ -58,6 +390,10 @@ void transplant(Tree* T, Node* u, Node* v) {
 }
 
 void tree_delete(Tree* T, Node* z) {
+    if (z == T->leftmost)                   // ends looked up again by the next hinted insert
+        T->leftmost = NULL;
+    if (z == T->rightmost)
+        T->rightmost = NULL;
     if (z->left == NULL)                    
         transplant(T, z, z->right);         
     else if (z->right == NULL)              
@@ -73,17 +409,152 @@ void tree_delete(Tree* T, Node* z) {
         y->left = z->left;                  
         y->left->p = y;                    
     }
+
+    // scapegoat mode: too many deletes since the last rebuild -> rebuild it all
+    if (T->sg_alpha > 0 && --T->sg_size < T->sg_alpha * T->sg_max_size)
+        tree_rebalance(T);
 }
 
 
-void inorder_tree_walk(Node* x) {
-    if (x != NULL) {                    
-        inorder_tree_walk(x->left);   
-        printf("%d ", x->key);         
-        inorder_tree_walk(x->right);   
+// Successor that never leaves the subtree rooted at top (NULL when done).
+// Uses parent pointers so the walks below need no stack at all.
+static Node* subtree_successor(Node* x, Node* top) {
+    if (x->right != NULL)
+        return tree_min(x->right);
+    while (x != top && x == x->p->right)  // climb while we come from the right
+        x = x->p;
+    return (x == top) ? NULL : x->p;
+}
+
+// Nodes in the subtree at x, counted with the stackless successor walk
+static int subtree_size(Node* x) {
+    int count = 0;
+    if (x == NULL)
+        return 0;
+    for (Node* y = tree_min(x); y != NULL; y = subtree_successor(y, x))
+        count++;
+    return count;
+}
+
+// DSW step 2: count left rotations down the right spine, every other node
+// becomes the left child of the one after it. Parent pointers kept as we go.
+static void dsw_compress(Node* root, int count) {
+    Node* scanner = root;
+    for (int i = 0; i < count; i++) {
+        Node* child = scanner->right;
+        scanner->right = child->right;
+        scanner->right->p = scanner;
+        scanner = scanner->right;
+        child->right = scanner->left;
+        if (child->right != NULL)
+            child->right->p = child;
+        scanner->left = child;
+        child->p = scanner;
+    }
+}
+
+// Day-Stout-Warren on the subtree at top. A dummy node on the stack sits
+// above it, so the only extra space is O(1). Returns the new subtree root
+// (its parent still has to be set by the caller) and the node count in *n.
+static Node* dsw_balance(Node* top, int* n) {
+    Node pseudo;
+    pseudo.left = NULL;
+    pseudo.right = top;
+
+    // 1) right rotations until the subtree is one sorted right chain (the vine)
+    int count = 0;
+    Node* tail = &pseudo;
+    Node* rest = top;
+    while (rest != NULL) {
+        if (rest->left == NULL) {
+            rest->p = tail;
+            tail = rest;
+            rest = rest->right;
+            count++;
+        }
+        else {
+            Node* t = rest->left;
+            rest->left = t->right;
+            t->right = rest;
+            rest = t;
+            tail->right = t;
+        }
+    }
+
+    // 2) fold the vine: first the nodes of the bottom, partial level, then halve
+    int full = 1;                     // 2^k - 1 = nodes in the complete levels
+    while (2 * full + 1 <= count)
+        full = 2 * full + 1;
+    dsw_compress(&pseudo, count - full);
+    for (int m = full / 2; m > 0; m /= 2)
+        dsw_compress(&pseudo, m);
+
+    *n = count;
+    return pseudo.right;
+}
+
+// Rebuild the subtree at x in place and hang it back under x's old parent
+static void rebuild_subtree(Tree* T, Node* x) {
+    Node* parent = x->p;
+    int is_left = (parent != NULL && parent->left == x);
+    int n;
+    Node* r = dsw_balance(x, &n);
+    r->p = parent;
+    if (parent == NULL)
+        T->root = r;
+    else if (is_left)
+        parent->left = r;
+    else
+        parent->right = r;
+}
+
+void tree_rebalance(Tree* T) {
+    int n = 0;
+    if (T->root != NULL) {
+        T->root = dsw_balance(T->root, &n);
+        T->root->p = NULL;
+    }
+    T->sg_size = n;
+    T->sg_max_size = n;
+}
+
+void tree_set_scapegoat(Tree* T, double alpha) {
+    T->sg_alpha = (alpha >= 0.5 && alpha < 1) ? alpha : 0;
+    if (T->sg_alpha > 0)
+        tree_rebalance(T);  // start from a balanced tree with the right count
+}
+
+// z just went in at this depth. Too deep -> climb, adding up subtree sizes,
+// to the first ancestor with a child holding more than alpha of its nodes
+// (one always exists on a path this long) and rebuild that one.
+static void scapegoat_check(Tree* T, Node* z, int depth) {
+    T->sg_size++;
+    if (T->sg_size > T->sg_max_size)
+        T->sg_max_size = T->sg_size;
+    if (depth <= (int)(log(T->sg_size) / log(1.0 / T->sg_alpha)))
+        return;
+
+    int child_size = 1;
+    for (Node* x = z; x->p != NULL; x = x->p) {
+        Node* p = x->p;
+        Node* sibling = (x == p->left) ? p->right : p->left;
+        int size = child_size + 1 + subtree_size(sibling);
+        if (child_size > T->sg_alpha * size) {
+            rebuild_subtree(T, p);
+            return;
+        }
+        child_size = size;
     }
 }
 
+// Iterative: min then successor, so a 10^6 deep chain is fine
+void inorder_tree_walk(Node* x) {
+    if (x == NULL)
+        return;
+    for (Node* y = tree_min(x); y != NULL; y = subtree_successor(y, x))
+        printf("%d ", y->key);
+}
+
 
 Node* tree_min(Node* x) {
     while (x->left != NULL)    // Keep going left
@@ -100,14 +571,56 @@ Node* tree_max(Node* x) {
 
 
 Node* tree_search(Node* x, int k) {
-    if (x == NULL || k == x->key)  
-        return x;                    
-    if (k < x->key)                 
-        return tree_search(x->left, k);  
-    else                             
-        return tree_search(x->right, k);
+    while (x != NULL && k != x->key) {  // same as the CLRS recursion, as a loop
+        if (k < x->key)
+            x = x->left;
+        else
+            x = x->right;
+    }
+    return x;
 }
 
+// Batched TREE-SEARCH: up to BATCH_IN_FLIGHT searches take one step each per
+// round, and each step prefetches the child it moves to. By the time a search
+// gets its next turn the node is (hopefully) in cache, so the misses of the
+// different searches overlap instead of being paid one after the other.
+// A finished search hands its slot to the next key straight away.
+void tree_search_batch(Tree* T, const int* keys, int m, Node** out) {
+    Node* node[BATCH_IN_FLIGHT];
+    int query[BATCH_IN_FLIGHT];   // which key each slot is working on, -1 = idle
+    int slots = (m < BATCH_IN_FLIGHT) ? m : BATCH_IN_FLIGHT;
+    int next = slots;
+    int active = slots;
+
+    for (int s = 0; s < slots; s++) {
+        query[s] = s;
+        node[s] = T->root;
+    }
+
+    while (active > 0) {
+        for (int s = 0; s < slots; s++) {
+            if (query[s] < 0)
+                continue;
+            Node* x = node[s];
+            int k = keys[query[s]];
+            if (x == NULL || k == x->key) {
+                out[query[s]] = x;
+                if (next < m) {
+                    query[s] = next++;
+                    node[s] = T->root;
+                }
+                else {
+                    query[s] = -1;
+                    active--;
+                }
+                continue;
+            }
+            x = (k < x->key) ? x->left : x->right;
+            __builtin_prefetch(x);
+            node[s] = x;
+        }
+    }
+}
 
 Node* tree_successor(Node* x) {
     if (x->right != NULL)                 
@@ -120,45 +633,226 @@ Node* tree_successor(Node* x) {
     return y;                              
 }
 
-// Recursively free all nodes
+// Mirror image of tree_successor
+Node* tree_predecessor(Node* x) {
+    if (x->left != NULL)
+        return tree_max(x->left);
+    Node* y = x->p;
+    while (y != NULL && x == y->left) {
+        x = y;
+        y = y->p;
+    }
+    return y;
+}
+
+// Free all nodes without recursion: go down to a leaf, free it, unhook it
+// from its parent and carry on from the parent. Every edge is walked twice.
 void destroy_tree(Node* root) {
-    if (root != NULL) {              
-        destroy_tree(root->left);    
-        destroy_tree(root->right);   
-        free(root);                  
+    Node* x = root;
+    while (x != NULL) {
+        if (x->left != NULL) {
+            x = x->left;
+        }
+        else if (x->right != NULL) {
+            x = x->right;
+        }
+        else {
+            Node* parent = x->p;
+            if (x == root) {   // do not touch whatever is above the subtree
+                free(x);
+                break;
+            }
+            if (parent->left == x)
+                parent->left = NULL;
+            else
+                parent->right = NULL;
+            free(x);
+            x = parent;
+        }
     }
 }
 
-// Calculate height of tree
+// Fast teardown. Freeing a big malloc'd tree is mostly cache misses on the
+// walk, so: free the top levels until there are enough subtrees, hand them
+// out to the threads in groups, and inside a group keep BATCH_IN_FLIGHT
+// stackless walks going round robin with the next node prefetched (like
+// tree_search_batch). threads = 1 already gets the interleaving. More threads
+// add more misses in flight, but every free() goes back to the one malloc
+// arena the nodes came from, so that is where scaling stops. A chain never
+// fans out and ends up as one plain walk.
+#define DESTROY_TASKS_PER_THREAD 4
+
+// free the disjoint subtrees roots[0..m), slots refilled as walks finish.
+// Returns how many nodes went.
+static long destroy_walks(Node** roots, int m){
+    long freed = 0;
+    Node* sub[BATCH_IN_FLIGHT];
+    Node* cur[BATCH_IN_FLIGHT];
+    int slots = m < BATCH_IN_FLIGHT ? m : BATCH_IN_FLIGHT;
+    int next_root = 0;
+    for (int i = 0; i < slots; i++)
+        sub[i] = cur[i] = roots[next_root++];
+    int active = slots;
+
+    while (active > 0){
+        for (int i = 0; i < slots; i++){
+            Node* x = cur[i];
+            if (x == NULL)
+                continue;
+            Node* nx;
+            if (x->left != NULL){
+                nx = x->left;
+            }
+            else if (x->right != NULL){
+                nx = x->right;
+            }
+            else{
+                nx = x->p;
+                if (x == sub[i]){              // subtree done, start the next one
+                    nx = NULL;
+                    if (next_root < m)
+                        nx = sub[i] = roots[next_root++];
+                    else
+                        active--;
+                }
+                else if (nx->left == x){
+                    nx->left = NULL;
+                }
+                else{
+                    nx->right = NULL;
+                }
+                free(x);
+                freed++;
+            }
+            if (nx != NULL)
+                __builtin_prefetch(nx);
+            cur[i] = nx;
+        }
+    }
+    return freed;
+}
+
+typedef struct DestroyCtx {
+    Node** roots;
+    int nroots;
+    int ntasks;
+    long freed;     // summed over the tasks
+} DestroyCtx;
+
+static void destroy_task(void* arg, int task){
+    DestroyCtx* c = (DestroyCtx*)arg;
+    int lo = (int)((long long)c->nroots * task / c->ntasks);
+    int hi = (int)((long long)c->nroots * (task + 1) / c->ntasks);
+    __atomic_add_fetch(&c->freed, destroy_walks(c->roots + lo, hi - lo), __ATOMIC_RELAXED);
+}
+
+long destroy_tree_parallel(Node* root, int threads){
+    if (root == NULL)
+        return 0;
+    if (threads < 1)
+        threads = 1;
+    int ntasks = threads > 1 ? DESTROY_TASKS_PER_THREAD * threads : 1;
+    int want = ntasks * BATCH_IN_FLIGHT;
+    Node** level = (Node**)malloc(2 * want * sizeof(Node*));
+    Node** next = (Node**)malloc(2 * want * sizeof(Node*));
+    int nlevel = 1;
+    level[0] = root;
+    long freed = 0;
+
+    // children are read before a node is freed and the walks below never
+    // look at a subtree root's parent, so the top levels can go right away
+    while (nlevel > 0 && nlevel < want){
+        int nnext = 0;
+        for (int i = 0; i < nlevel; i++){
+            Node* x = level[i];
+            if (x->left != NULL)
+                next[nnext++] = x->left;
+            if (x->right != NULL)
+                next[nnext++] = x->right;
+            free(x);
+            freed++;
+        }
+        Node** t = level; level = next; next = t;
+        nlevel = nnext;
+    }
+
+    // subtrees never touch the spine above them, so no locking
+    DestroyCtx c = {level, nlevel, ntasks < nlevel ? ntasks : (nlevel > 0 ? nlevel : 1), 0};
+    parallel_for(threads, c.ntasks, destroy_task, &c);
+    free(level);
+    free(next);
+    return freed + c.freed;
+}
+
+// Calculate height of tree -> stackless walk with parent pointers,
+// prev tells us whether we arrived from the parent, left or right child
 int tree_height(Node* node) {
     if (node == NULL)
         return 0;
 
-    int left_height = tree_height(node->left);
-    int right_height = tree_height(node->right);
-
-    return 1 + (left_height > right_height ? left_height : right_height);
+    int depth = 1, height = 1;
+    Node* x = node;
+    Node* prev = node->p;
+    while (x != NULL) {
+        if (prev == x->p && x->left != NULL) {                 // first visit, go left
+            prev = x; x = x->left; depth++;
+        }
+        else if ((prev == x->p || prev == x->left) && x->right != NULL) { // left done, go right
+            prev = x; x = x->right; depth++;
+        }
+        else {                                                 // both done, go back up
+            if (depth > height)
+                height = depth;
+            if (x == node)
+                break;
+            prev = x; x = x->p; depth--;
+        }
+    }
+    return height;
 }
 
 // Silent inorder traversal for timing experiments
 void inorder_tree_walk_silent(Node* x) {
-    if (x != NULL) {
-        inorder_tree_walk_silent(x->left);
-        volatile int temp __attribute__((unused)) = x->key;  // Access key without printing -> got this from the internet 
-        inorder_tree_walk_silent(x->right);
+    if (x == NULL)
+        return;
+    for (Node* y = tree_min(x); y != NULL; y = subtree_successor(y, x)) {
+        volatile int temp __attribute__((unused)) = y->key;  // Access key without printing -> got this from the internet 
     }
 }
 
 
 void inorder_tree_walk_limit(Node* x, int limit) {
-    static int count = 0;
-    if (x != NULL && count < limit) {
-        inorder_tree_walk_limit(x->left, limit);
-        if (count < limit) {
-            printf("%d ", x->key);
-            count++;
-        }
-        inorder_tree_walk_limit(x->right, limit);
+    if (x == NULL)
+        return;
+    int count = 0;
+    for (Node* y = tree_min(x); y != NULL && count < limit; y = subtree_successor(y, x)) {
+        printf("%d ", y->key);
+        count++;
     }
-    if (x == NULL) count = 0; 
+}
+
+// In-order cursor: begin/last position it, next/prev step with
+// tree_successor/tree_predecessor (amortised O(1) per step, no stack)
+Node* tree_cursor_begin(TreeCursor* c, Tree* T) {
+    c->T = T;
+    c->node = (T->root == NULL) ? NULL : tree_min(T->root);
+    return c->node;
+}
+
+Node* tree_cursor_last(TreeCursor* c, Tree* T) {
+    c->T = T;
+    c->node = (T->root == NULL) ? NULL : tree_max(T->root);
+    return c->node;
+}
+
+Node* tree_cursor_next(TreeCursor* c) {
+    if (c->node != NULL)
+        c->node = tree_successor(c->node);
+    return c->node;
+}
+
+Node* tree_cursor_prev(TreeCursor* c) {
+    if (c->node != NULL)
+        c->node = tree_predecessor(c->node);
+    return c->node;
 }
\ No newline at end of file
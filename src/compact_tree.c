@@ -0,0 +1,301 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/compact_tree.h"
+
+#define COMPACT_MIN_CAPACITY 64
+
+// Next array size: doubled, but handles are 32 bits, so it stops at
+// UINT32_MAX slots. 0 = full.
+static uint32_t grow_capacity(uint32_t cap){
+    if (cap == UINT32_MAX)
+        return 0;
+    return cap > UINT32_MAX / 2 ? UINT32_MAX : 2 * cap;
+}
+
+// ---------- BST ----------
+
+CompactTree* ctree_create(int capacity){
+    CompactTree* T = (CompactTree*)malloc(sizeof(CompactTree));
+    T->capacity = capacity < COMPACT_MIN_CAPACITY ? COMPACT_MIN_CAPACITY : (uint32_t)capacity + 1;
+    T->nodes = (CNode*)malloc(T->capacity * sizeof(CNode));
+    T->nodes[CNIL].key = 0;
+    T->nodes[CNIL].left = T->nodes[CNIL].right = T->nodes[CNIL].p = CNIL;
+    T->used = 1;              // slot 0 is nil
+    T->free_list = CNIL;
+    T->root = CNIL;
+    return T;
+}
+
+void ctree_destroy(CompactTree* T){
+    free(T->nodes);
+    free(T);
+}
+
+// Free slot: reuse a deleted one or take the next, doubling the array if full.
+// CNIL when the array cannot grow (2^32 slots or no memory).
+static uint32_t ctree_new_slot(CompactTree* T){
+    if (T->free_list != CNIL){
+        uint32_t z = T->free_list;
+        T->free_list = T->nodes[z].left;
+        return z;
+    }
+    if (T->used == T->capacity){
+        uint32_t cap = grow_capacity(T->capacity);
+        CNode* grown = cap ? (CNode*)realloc(T->nodes, (size_t)cap * sizeof(CNode)) : NULL;
+        if (grown == NULL)
+            return CNIL;
+        T->nodes = grown;
+        T->capacity = cap;
+    }
+    return T->used++;
+}
+
+uint32_t ctree_insert(CompactTree* T, int key){
+    uint32_t z = ctree_new_slot(T);
+    if (z == CNIL)
+        return CNIL;            // tree unchanged
+    CNode* N = T->nodes;       // after new_slot, the array may have moved
+    uint32_t y = CNIL;
+    uint32_t x = T->root;
+
+    while (x != CNIL){
+        y = x;
+        x = (key < N[x].key) ? N[x].left : N[x].right;
+    }
+
+    N[z].key = key;
+    N[z].left = CNIL;
+    N[z].right = CNIL;
+    N[z].p = y;
+    if (y == CNIL)
+        T->root = z;
+    else if (key < N[y].key)
+        N[y].left = z;
+    else
+        N[y].right = z;
+    return z;
+}
+
+static void ctree_transplant(CompactTree* T, uint32_t u, uint32_t v){
+    CNode* N = T->nodes;
+    if (N[u].p == CNIL)
+        T->root = v;
+    else if (u == N[N[u].p].left)
+        N[N[u].p].left = v;
+    else
+        N[N[u].p].right = v;
+    if (v != CNIL)
+        N[v].p = N[u].p;
+}
+
+void ctree_delete(CompactTree* T, uint32_t z){
+    CNode* N = T->nodes;
+    if (N[z].left == CNIL)
+        ctree_transplant(T, z, N[z].right);
+    else if (N[z].right == CNIL)
+        ctree_transplant(T, z, N[z].left);
+    else {
+        uint32_t y = ctree_min(T, N[z].right);
+        if (N[y].p != z){
+            ctree_transplant(T, y, N[y].right);
+            N[y].right = N[z].right;
+            N[N[y].right].p = y;
+        }
+        ctree_transplant(T, z, y);
+        N[y].left = N[z].left;
+        N[N[y].left].p = y;
+    }
+    N[z].left = T->free_list;
+    T->free_list = z;
+}
+
+uint32_t ctree_search(CompactTree* T, int key){
+    CNode* N = T->nodes;
+    uint32_t x = T->root;
+    while (x != CNIL && key != N[x].key)
+        x = (key < N[x].key) ? N[x].left : N[x].right;
+    return x;
+}
+
+uint32_t ctree_min(CompactTree* T, uint32_t x){
+    while (T->nodes[x].left != CNIL)
+        x = T->nodes[x].left;
+    return x;
+}
+
+uint32_t ctree_max(CompactTree* T, uint32_t x){
+    while (T->nodes[x].right != CNIL)
+        x = T->nodes[x].right;
+    return x;
+}
+
+uint32_t ctree_successor(CompactTree* T, uint32_t x){
+    CNode* N = T->nodes;
+    if (N[x].right != CNIL)
+        return ctree_min(T, N[x].right);
+    uint32_t y = N[x].p;
+    while (y != CNIL && x == N[y].right){
+        x = y;
+        y = N[y].p;
+    }
+    return y;
+}
+
+size_t ctree_bytes(CompactTree* T){
+    return (size_t)T->capacity * sizeof(CNode);
+}
+
+// ---------- OS-tree ----------
+
+CompactOSTree* cos_tree_create(int capacity){
+    CompactOSTree* T = (CompactOSTree*)malloc(sizeof(CompactOSTree));
+    T->capacity = capacity < COMPACT_MIN_CAPACITY ? COMPACT_MIN_CAPACITY : (uint32_t)capacity + 1;
+    T->nodes = (COSNode*)malloc(T->capacity * sizeof(COSNode));
+    T->nodes[CNIL].key = 0;
+    T->nodes[CNIL].size = 0;
+    T->nodes[CNIL].left = T->nodes[CNIL].right = T->nodes[CNIL].p = CNIL;
+    T->used = 1;
+    T->free_list = CNIL;
+    T->root = CNIL;
+    return T;
+}
+
+void cos_tree_destroy(CompactOSTree* T){
+    free(T->nodes);
+    free(T);
+}
+
+static uint32_t cos_new_slot(CompactOSTree* T){
+    if (T->free_list != CNIL){
+        uint32_t z = T->free_list;
+        T->free_list = T->nodes[z].left;
+        return z;
+    }
+    if (T->used == T->capacity){
+        uint32_t cap = grow_capacity(T->capacity);
+        COSNode* grown = cap ? (COSNode*)realloc(T->nodes, (size_t)cap * sizeof(COSNode)) : NULL;
+        if (grown == NULL)
+            return CNIL;
+        T->nodes = grown;
+        T->capacity = cap;
+    }
+    return T->used++;
+}
+
+// OS-TREE-INSERT: size++ on the way down
+uint32_t cos_tree_insert(CompactOSTree* T, int key){
+    uint32_t z = cos_new_slot(T);
+    if (z == CNIL)
+        return CNIL;
+    COSNode* N = T->nodes;
+    uint32_t y = CNIL;
+    uint32_t x = T->root;
+
+    while (x != CNIL){
+        y = x;
+        N[x].size++;
+        x = (key < N[x].key) ? N[x].left : N[x].right;
+    }
+
+    N[z].key = key;
+    N[z].size = 1;
+    N[z].left = CNIL;
+    N[z].right = CNIL;
+    N[z].p = y;
+    if (y == CNIL)
+        T->root = z;
+    else if (key < N[y].key)
+        N[y].left = z;
+    else
+        N[y].right = z;
+    return z;
+}
+
+static void cos_transplant(CompactOSTree* T, uint32_t u, uint32_t v){
+    COSNode* N = T->nodes;
+    if (N[u].p == CNIL)
+        T->root = v;
+    else if (u == N[N[u].p].left)
+        N[N[u].p].left = v;
+    else
+        N[N[u].p].right = v;
+    if (v != CNIL)
+        N[v].p = N[u].p;
+}
+
+// OS-TREE-DELETE: everything above the spot that is spliced out loses one,
+// walked up through parents so duplicate keys are handled too
+void cos_tree_delete(CompactOSTree* T, uint32_t z){
+    COSNode* N = T->nodes;
+    uint32_t y = z;
+    if (N[z].left != CNIL && N[z].right != CNIL){
+        y = N[z].right;
+        while (N[y].left != CNIL)
+            y = N[y].left;
+    }
+    for (uint32_t a = N[y].p; a != CNIL; a = N[a].p)
+        N[a].size--;
+
+    if (N[z].left == CNIL)
+        cos_transplant(T, z, N[z].right);
+    else if (N[z].right == CNIL)
+        cos_transplant(T, z, N[z].left);
+    else {
+        if (N[y].p != z){
+            cos_transplant(T, y, N[y].right);
+            N[y].right = N[z].right;
+            N[N[y].right].p = y;
+        }
+        cos_transplant(T, z, y);
+        N[y].left = N[z].left;
+        N[N[y].left].p = y;
+        N[y].size = N[z].size;
+    }
+    N[z].left = T->free_list;
+    T->free_list = z;
+}
+
+uint32_t cos_tree_search(CompactOSTree* T, int key){
+    COSNode* N = T->nodes;
+    uint32_t x = T->root;
+    while (x != CNIL && key != N[x].key)
+        x = (key < N[x].key) ? N[x].left : N[x].right;
+    return x;
+}
+
+// OS-SELECT, nil's size of 0 replaces os_get_size
+uint32_t cos_select(CompactOSTree* T, int i){
+    COSNode* N = T->nodes;
+    uint32_t x = T->root;
+    while (x != CNIL){
+        int r = N[N[x].left].size + 1;
+        if (i == r)
+            return x;
+        if (i < r){
+            x = N[x].left;
+        }
+        else{
+            i -= r;
+            x = N[x].right;
+        }
+    }
+    return CNIL;
+}
+
+// OS-RANK
+int cos_rank(CompactOSTree* T, uint32_t x){
+    COSNode* N = T->nodes;
+    int r = N[N[x].left].size + 1;
+    uint32_t y = x;
+    while (y != T->root){
+        uint32_t p = N[y].p;
+        if (y == N[p].right)
+            r += N[N[p].left].size + 1;
+        y = p;
+    }
+    return r;
+}
+
+size_t cos_tree_bytes(CompactOSTree* T){
+    return (size_t)T->capacity * sizeof(COSNode);
+}
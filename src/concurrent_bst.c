@@ -0,0 +1,226 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/concurrent_bst.h"
+
+// Readers only ever load left/right/root and key, writers never race each
+// other, so only the child links a reader can be walking need atomic stores.
+// p is writer-only (and chains retired nodes in limbo).
+
+static Node* load_link(Node** link){
+    return __atomic_load_n(link, __ATOMIC_ACQUIRE);
+}
+
+// node behind v is completely filled in before anyone can reach it
+static void publish(Node** link, Node* v){
+    __atomic_store_n(link, v, __ATOMIC_RELEASE);
+}
+
+ConcurrentTree* conc_tree_create(void){
+    ConcurrentTree* CT = (ConcurrentTree*)malloc(sizeof(ConcurrentTree));
+    CT->T = create_tree();
+    pthread_mutex_init(&CT->write_lock, NULL);
+    CT->epoch = 1;
+    CT->seq = 0;
+    for (int i = 0; i < CONC_MAX_READERS; i++)
+        CT->readers[i] = NULL;
+    CT->limbo[0] = CT->limbo[1] = CT->limbo[2] = NULL;
+    CT->retired = 0;
+    return CT;
+}
+
+static void free_limbo(ConcurrentTree* CT, int bucket){
+    Node* x = CT->limbo[bucket];
+    while (x != NULL){
+        Node* next = x->p;
+        free(x);
+        CT->retired--;
+        x = next;
+    }
+    CT->limbo[bucket] = NULL;
+}
+
+void conc_tree_destroy(ConcurrentTree* CT){
+    for (int b = 0; b < 3; b++)
+        free_limbo(CT, b);
+    for (int i = 0; i < CONC_MAX_READERS; i++)
+        free(CT->readers[i]);
+    destroy_tree(CT->T->root);
+    free(CT->T);
+    pthread_mutex_destroy(&CT->write_lock);
+    free(CT);
+}
+
+ConcReader* conc_reader_register(ConcurrentTree* CT){
+    ConcReader* r = NULL;
+    pthread_mutex_lock(&CT->write_lock);
+    for (int i = 0; i < CONC_MAX_READERS; i++){
+        if (CT->readers[i] == NULL){
+            r = (ConcReader*)aligned_alloc(64, sizeof(ConcReader));
+            r->CT = CT;
+            r->epoch = 0;
+            CT->readers[i] = r;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&CT->write_lock);
+    return r;
+}
+
+void conc_reader_unregister(ConcReader* r){
+    ConcurrentTree* CT = r->CT;
+    pthread_mutex_lock(&CT->write_lock);
+    for (int i = 0; i < CONC_MAX_READERS; i++){
+        if (CT->readers[i] == r)
+            CT->readers[i] = NULL;
+    }
+    pthread_mutex_unlock(&CT->write_lock);
+    free(r);
+}
+
+// ---------- readers ----------
+
+// Announce the current epoch, and check it is still current afterwards: a
+// writer that scanned before our store became visible may have moved on.
+void conc_read_begin(ConcReader* r){
+    ConcurrentTree* CT = r->CT;
+    unsigned long e = __atomic_load_n(&CT->epoch, __ATOMIC_ACQUIRE);
+    for (;;){
+        __atomic_store_n(&r->epoch, e, __ATOMIC_SEQ_CST);
+        unsigned long now = __atomic_load_n(&CT->epoch, __ATOMIC_SEQ_CST);
+        if (now == e)
+            break;
+        e = now;
+    }
+}
+
+void conc_read_end(ConcReader* r){
+    __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+}
+
+// A hit is always right. A miss is only trusted if no successor move was in
+// progress when we started and none has happened since.
+Node* conc_tree_search_node(ConcReader* r, int key){
+    ConcurrentTree* CT = r->CT;
+    for (;;){
+        unsigned long s0 = __atomic_load_n(&CT->seq, __ATOMIC_ACQUIRE);
+        Node* x = load_link(&CT->T->root);
+        while (x != NULL && key != x->key)
+            x = load_link(key < x->key ? &x->left : &x->right);
+        if (x != NULL)
+            return x;
+        if ((s0 & 1) == 0 && __atomic_load_n(&CT->seq, __ATOMIC_ACQUIRE) == s0)
+            return NULL;
+    }
+}
+
+int conc_tree_search(ConcReader* r, int key){
+    conc_read_begin(r);
+    Node* x = conc_tree_search_node(r, key);
+    conc_read_end(r);
+    return x != NULL;
+}
+
+// ---------- writers (write_lock held) ----------
+
+// the pointer that leads to u: its parent's child slot or the root
+static Node** link_of(ConcurrentTree* CT, Node* u){
+    if (u->p == NULL)
+        return &CT->T->root;
+    return (u == u->p->left) ? &u->p->left : &u->p->right;
+}
+
+static void retire(ConcurrentTree* CT, Node* x){
+    int b = (int)(CT->epoch % 3);
+    x->p = CT->limbo[b];
+    CT->limbo[b] = x;
+    CT->retired++;
+}
+
+// Every active reader has seen epoch e -> nobody can still hold a node
+// retired in e - 2 (those readers all left before e - 1 ended), free that
+// bucket and go to e + 1, whose bucket is the one just emptied.
+static void try_advance(ConcurrentTree* CT){
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);     // unlinks visible before we look at readers
+    unsigned long e = CT->epoch;
+    for (int i = 0; i < CONC_MAX_READERS; i++){
+        ConcReader* r = CT->readers[i];
+        if (r != NULL){
+            unsigned long re = __atomic_load_n(&r->epoch, __ATOMIC_SEQ_CST);
+            if (re != 0 && re != e)
+                return;
+        }
+    }
+    free_limbo(CT, (int)((e + 1) % 3));
+    __atomic_store_n(&CT->epoch, e + 1, __ATOMIC_SEQ_CST);
+}
+
+void conc_tree_insert(ConcurrentTree* CT, int key){
+    Node* z = create_node(key);
+    pthread_mutex_lock(&CT->write_lock);
+    Node* y = NULL;
+    tree_forget_ends(CT->T);
+    Node* x = CT->T->root;
+    while (x != NULL){
+        y = x;
+        x = (key < x->key) ? x->left : x->right;
+    }
+    z->p = y;
+    if (y == NULL)
+        publish(&CT->T->root, z);
+    else if (key < y->key)
+        publish(&y->left, z);
+    else
+        publish(&y->right, z);
+    pthread_mutex_unlock(&CT->write_lock);
+}
+
+// One child or none: z's link is swung to that child, readers that are
+// already at z still get to everything below it.
+// Two children: a copy c of the successor y takes z's place (the key is then
+// in the tree twice), then y is cut out of z's right subtree. seq is odd for
+// the whole move so readers can tell their miss might be a false one.
+int conc_tree_delete(ConcurrentTree* CT, int key){
+    pthread_mutex_lock(&CT->write_lock);
+    Node* z = CT->T->root;
+    tree_forget_ends(CT->T);
+    while (z != NULL && key != z->key)
+        z = (key < z->key) ? z->left : z->right;
+    if (z == NULL){
+        pthread_mutex_unlock(&CT->write_lock);
+        return 0;
+    }
+
+    if (z->left == NULL || z->right == NULL){
+        Node* child = (z->left != NULL) ? z->left : z->right;
+        if (child != NULL)
+            child->p = z->p;
+        publish(link_of(CT, z), child);
+    }
+    else{
+        Node* y = z->right;
+        while (y->left != NULL)
+            y = y->left;
+        Node* c = create_node(y->key);
+        c->p = z->p;
+        c->left = z->left;
+        c->right = (y == z->right) ? y->right : z->right;
+        c->left->p = c;
+        if (c->right != NULL)
+            c->right->p = c;
+
+        __atomic_store_n(&CT->seq, CT->seq + 1, __ATOMIC_RELAXED);   // odd, ordered by the release below
+        publish(link_of(CT, z), c);
+        if (y != z->right){
+            Node* yp = y->p;          // inside z's old right subtree, now under c
+            if (y->right != NULL)
+                y->right->p = yp;
+            publish(&yp->left, y->right);
+        }
+        __atomic_store_n(&CT->seq, CT->seq + 1, __ATOMIC_RELEASE);   // even again
+        retire(CT, y);
+    }
+    retire(CT, z);
+    try_advance(CT);
+    pthread_mutex_unlock(&CT->write_lock);
+    return 1;
+}
@@ -0,0 +1,198 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/fenwick_tree.h"
+#include "../include/os_rb_tree.h"
+
+FenwickTree* fen_create(int lo, int hi){
+    if (hi < lo || (long long)hi - lo + 1 > FENWICK_MAX_UNIVERSE)
+        return NULL;
+    FenwickTree* F = (FenwickTree*)malloc(sizeof(FenwickTree));
+    F->lo = lo;
+    F->hi = hi;
+    F->universe = hi - lo + 1;
+    F->top = 1;
+    while (F->top * 2 <= F->universe)
+        F->top *= 2;
+    F->count = 0;
+    F->bit = (int*)calloc((size_t)F->universe + 1, sizeof(int));
+    return F;
+}
+
+// Counts first, then each slot pushes its total to the one slot that covers it
+FenwickTree* fen_build(int lo, int hi, const int* keys, int n){
+    FenwickTree* F = fen_create(lo, hi);
+    if (F == NULL)
+        return NULL;
+    for (int i = 0; i < n; i++){
+        if (keys[i] >= lo && keys[i] <= hi){
+            F->bit[keys[i] - lo + 1]++;
+            F->count++;
+        }
+    }
+    for (int j = 1; j <= F->universe; j++){
+        int up = j + (j & -j);
+        if (up <= F->universe)
+            F->bit[up] += F->bit[j];
+    }
+    return F;
+}
+
+void fen_destroy(FenwickTree* F){
+    if (F == NULL)
+        return;
+    free(F->bit);
+    free(F);
+}
+
+static void fen_add(FenwickTree* F, int j, int d){
+    for (; j <= F->universe; j += j & -j)
+        F->bit[j] += d;
+}
+
+// keys in slots 1..j
+static int fen_prefix(FenwickTree* F, int j){
+    int s = 0;
+    for (; j > 0; j -= j & -j)
+        s += F->bit[j];
+    return s;
+}
+
+int fen_insert(FenwickTree* F, int key){
+    if (key < F->lo || key > F->hi)
+        return 0;
+    fen_add(F, key - F->lo + 1, 1);
+    F->count++;
+    return 1;
+}
+
+int fen_delete(FenwickTree* F, int key){
+    if (fen_count(F, key) == 0)
+        return 0;
+    fen_add(F, key - F->lo + 1, -1);
+    F->count--;
+    return 1;
+}
+
+// bit[j] minus the slots below j it covers that are not in prefix(j-1)'s
+// walk: a point query without a second full prefix sum
+int fen_count(FenwickTree* F, int key){
+    if (key < F->lo || key > F->hi)
+        return 0;
+    int j = key - F->lo + 1;
+    int c = F->bit[j];
+    int stop = j - (j & -j);
+    for (int y = j - 1; y > stop; y -= y & -y)
+        c -= F->bit[y];
+    return c;
+}
+
+int fen_rank(FenwickTree* F, int key){
+    if (key <= F->lo)
+        return 1;
+    if (key > F->hi)
+        return F->count + 1;
+    return fen_prefix(F, key - F->lo) + 1;
+}
+
+// Binary lifting: largest pos with prefix(pos) < i, taking the steps from
+// the biggest power of two down, then the key is slot pos + 1
+int fen_select(FenwickTree* F, int i, int* key){
+    if (i < 1 || i > F->count)
+        return 0;
+    int pos = 0;
+    for (int step = F->top; step > 0; step >>= 1){
+        int next = pos + step;
+        if (next <= F->universe && F->bit[next] < i){
+            pos = next;
+            i -= F->bit[next];
+        }
+    }
+    *key = F->lo + pos;
+    return 1;
+}
+
+int fen_count_range(FenwickTree* F, int lo, int hi){
+    if (lo < F->lo)
+        lo = F->lo;
+    if (hi > F->hi)
+        hi = F->hi;
+    if (lo > hi)
+        return 0;
+    return fen_prefix(F, hi - F->lo + 1) - fen_prefix(F, lo - F->lo);
+}
+
+OrderIndex* order_index_create(int lo, int hi, int expected_n){
+    OrderIndex* I = (OrderIndex*)malloc(sizeof(OrderIndex));
+    I->lo = lo;
+    I->hi = hi;
+    I->F = NULL;
+    I->T = NULL;
+    long long universe = (long long)hi - lo + 1;
+    long long n = (expected_n > 0) ? expected_n : 1;
+    if (universe >= 1 && universe <= FENWICK_DENSITY * n)
+        I->F = fen_create(lo, hi);
+    if (I->F != NULL){
+        I->kind = ORDER_INDEX_FENWICK;
+    }
+    else{
+        I->kind = ORDER_INDEX_TREE;
+        I->T = os_create_arena_tree();
+    }
+    return I;
+}
+
+void order_index_destroy(OrderIndex* I){
+    if (I->kind == ORDER_INDEX_FENWICK)
+        fen_destroy(I->F);
+    else
+        os_destroy_arena_tree(I->T);
+    free(I);
+}
+
+int order_index_insert(OrderIndex* I, int key){
+    if (I->kind == ORDER_INDEX_FENWICK)
+        return fen_insert(I->F, key);
+    if (key < I->lo || key > I->hi)
+        return 0;
+    os_rb_tree_insert(I->T, os_tree_alloc_node(I->T, key));
+    return 1;
+}
+
+int order_index_delete(OrderIndex* I, int key){
+    if (I->kind == ORDER_INDEX_FENWICK)
+        return fen_delete(I->F, key);
+    OSNode* z = os_tree_search(I->T->root, key);
+    if (z == NULL)
+        return 0;
+    os_rb_tree_delete(I->T, z);
+    os_tree_free_node(I->T, z);
+    return 1;
+}
+
+int order_index_select(OrderIndex* I, int i, int* key){
+    if (I->kind == ORDER_INDEX_FENWICK)
+        return fen_select(I->F, i, key);
+    OSNode* x = os_select(I->T->root, i);
+    if (x == NULL)
+        return 0;
+    *key = x->key;
+    return 1;
+}
+
+int order_index_rank(OrderIndex* I, int key){
+    if (I->kind == ORDER_INDEX_FENWICK)
+        return fen_rank(I->F, key);
+    return os_rank_of_key(I->T, key);
+}
+
+int order_index_count_range(OrderIndex* I, int lo, int hi){
+    if (I->kind == ORDER_INDEX_FENWICK)
+        return fen_count_range(I->F, lo, hi);
+    return os_count_range(I->T, lo, hi);
+}
+
+int order_index_size(OrderIndex* I){
+    if (I->kind == ORDER_INDEX_FENWICK)
+        return I->F->count;
+    return os_get_size(I->T->root);
+}
@@ -0,0 +1,162 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/frozen_tree.h"
+
+#define CACHE_LINE 64
+#define KEYS_PER_LINE (CACHE_LINE / (int)sizeof(int)) // 16 -> 4 levels per cache line
+
+// Number of levels of the implicit complete tree: floor(lg n) + 1
+static int levels_for(int n){
+    int levels = 0;
+    while (n > 0){
+        levels++;
+        n >>= 1;
+    }
+    return levels;
+}
+
+// Size of the subtree at slot k (depth d) of a complete tree with n keys:
+// every level above the last is full, the last one is cut off at n
+static int implicit_size(long k, int depth, int levels, int n){
+    if (k > n)
+        return 0;
+    int below = levels - 1 - depth;          // levels under k
+    long first_last = k << below;            // leftmost slot on the last level
+    long last = n - first_last + 1;          // how many of those exist
+    if (last < 0) last = 0;
+    if (last > (1L << below)) last = 1L << below;
+    return (int)((1L << below) - 1 + last);
+}
+
+// Slots in in-order (= sorted) order: leftmost slot first, then climb/descend
+static long implicit_first(int n){
+    long k = 1;
+    while (2 * k <= n)
+        k = 2 * k;
+    return k;
+}
+
+static long implicit_next(long k, int n){
+    if (2 * k + 1 <= n){             // has right child -> leftmost of it
+        k = 2 * k + 1;
+        while (2 * k <= n)
+            k = 2 * k;
+        return k;
+    }
+    while (k & 1)                    // climb while we are a right child
+        k >>= 1;
+    return k >> 1;                   // 0 once we pass the root
+}
+
+// Empty snapshot with eyt[0] on a cache line so eyt[16k..16k+15] share a line
+static FrozenTree* frozen_alloc(int n){
+    FrozenTree* F = (FrozenTree*)malloc(sizeof(FrozenTree));
+    size_t bytes = ((size_t)(n + 1) * sizeof(int) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    F->n = n;
+    F->eyt = (int*)aligned_alloc(CACHE_LINE, bytes);
+    return F;
+}
+
+FrozenTree* frozen_from_sorted(const int* keys, int n){
+    FrozenTree* F = frozen_alloc(n);
+    int i = 0;
+    for (long k = (n > 0) ? implicit_first(n) : 0; k != 0; k = implicit_next(k, n))
+        F->eyt[k] = keys[i++];
+    return F;
+}
+
+// Walk the tree in order (successor, no recursion) and drop keys into slots in order
+FrozenTree* tree_freeze(Tree* T){
+    int n = 0;
+    for (Node* x = (T->root ? tree_min(T->root) : NULL); x != NULL; x = tree_successor(x))
+        n++;
+
+    FrozenTree* F = frozen_alloc(n);
+    Node* x = (n > 0) ? tree_min(T->root) : NULL;
+    for (long k = (n > 0) ? implicit_first(n) : 0; k != 0; k = implicit_next(k, n)){
+        F->eyt[k] = x->key;
+        x = tree_successor(x);
+    }
+    return F;
+}
+
+// Same thing, but the OS-tree already knows n
+FrozenTree* os_tree_freeze(OSTree* T){
+    int n = os_get_size(T->root);
+
+    FrozenTree* F = frozen_alloc(n);
+    OSNode* x = (n > 0) ? os_tree_min(T->root) : NULL;
+    for (long k = (n > 0) ? implicit_first(n) : 0; k != 0; k = implicit_next(k, n)){
+        F->eyt[k] = x->key;
+        x = os_tree_successor(x);
+    }
+    return F;
+}
+
+void frozen_destroy(FrozenTree* F){
+    free(F->eyt);
+    free(F);
+}
+
+// k = 2k + (eyt[k] < key) compiles to a compare + add, no branch to mispredict.
+// The 16 slots 16k..16k+15 are k's descendants four levels down and share one
+// cache line, so fetching it now hides most of the memory latency.
+int frozen_lower_bound(FrozenTree* F, int key){
+    const int* eyt = F->eyt;
+    long n = F->n;
+    long k = 1;
+    while (k <= n){
+        __builtin_prefetch(eyt + k * KEYS_PER_LINE);
+        k = 2 * k + (eyt[k] < key);
+    }
+    // we went right every time after the answer: strip those turns plus the last left turn
+    k >>= __builtin_ffsl(~k);
+    return (int)k;
+}
+
+int frozen_search(FrozenTree* F, int key){
+    int k = frozen_lower_bound(F, key);
+    return (k != 0 && F->eyt[k] == key) ? k : 0;
+}
+
+// Same descent, adding left-subtree size + 1 whenever we step right
+int frozen_rank(FrozenTree* F, int key){
+    const int* eyt = F->eyt;
+    int n = F->n;
+    int levels = levels_for(n);
+    int r = 0;
+    int depth = 0;
+    long k = 1;
+    while (k <= n){
+        __builtin_prefetch(eyt + k * KEYS_PER_LINE);
+        int right = eyt[k] < key;
+        r += right * (implicit_size(2 * k, depth + 1, levels, n) + 1);
+        k = 2 * k + right;
+        depth++;
+    }
+    return r;
+}
+
+// OS-SELECT over the implicit tree
+int frozen_select(FrozenTree* F, int i){
+    int n = F->n;
+    int levels = levels_for(n);
+    int depth = 0;
+    long k = 1;
+    if (i < 1 || i > n)
+        return 0;
+    while (k <= n){
+        int r = implicit_size(2 * k, depth + 1, levels, n) + 1;   // rank of k in its subtree
+        if (i == r)
+            return (int)k;
+        if (i < r){
+            k = 2 * k;
+        }
+        else{
+            i -= r;
+            k = 2 * k + 1;
+        }
+        depth++;
+    }
+    return 0;
+}
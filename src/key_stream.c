@@ -0,0 +1,160 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "limits.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/key_stream.h"
+
+KeyStream* key_stream_open(const char* path, int width){
+    if (width != 4 && width != 8)
+        return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size % width != 0){
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    const char* map = NULL;
+    if (bytes > 0){
+        void* m = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED){
+            close(fd);
+            return NULL;
+        }
+        madvise(m, bytes, MADV_SEQUENTIAL);    // read ahead, drop pages behind us
+        map = (const char*)m;
+    }
+    close(fd);
+
+    KeyStream* S = (KeyStream*)malloc(sizeof(KeyStream));
+    S->map = map;
+    S->bytes = bytes;
+    S->width = width;
+    S->count = bytes / width;
+    S->pos = 0;
+    S->skipped = 0;
+    S->chunk = (width == 8) ? (int*)malloc(KEY_STREAM_CHUNK * sizeof(int)) : NULL;
+    return S;
+}
+
+void key_stream_close(KeyStream* S){
+    if (S == NULL)
+        return;
+    if (S->map != NULL)
+        munmap((void*)S->map, S->bytes);
+    free(S->chunk);
+    free(S);
+}
+
+void key_stream_rewind(KeyStream* S){
+    S->pos = 0;
+    S->skipped = 0;
+}
+
+static int fits_int(int64_t v){
+    return v >= INT_MIN && v <= INT_MAX;
+}
+
+const int* key_stream_next(KeyStream* S, size_t max, size_t* got){
+    if (max == 0 || (S->width == 8 && max > KEY_STREAM_CHUNK))
+        max = KEY_STREAM_CHUNK;
+    *got = 0;
+    if (S->width == 4){
+        if (S->pos >= S->count)
+            return NULL;
+        size_t k = S->count - S->pos;
+        if (k > max)
+            k = max;
+        const int* keys = (const int*)S->map + S->pos;
+        S->pos += k;
+        *got = k;
+        return keys;
+    }
+    // a chunk can come out short (or empty) when keys are skipped, keep
+    // going until something is in it or the file is done
+    const int64_t* src = (const int64_t*)S->map;
+    size_t k = 0;
+    while (k < max && S->pos < S->count){
+        int64_t v = src[S->pos++];
+        if (fits_int(v))
+            S->chunk[k++] = (int)v;
+        else
+            S->skipped++;
+    }
+    *got = k;
+    return k > 0 ? S->chunk : NULL;
+}
+
+int key_stream_get(KeyStream* S, int* key){
+    while (S->pos < S->count){
+        if (S->width == 4){
+            *key = ((const int*)S->map)[S->pos++];
+            return 1;
+        }
+        int64_t v = ((const int64_t*)S->map)[S->pos++];
+        if (fits_int(v)){
+            *key = (int)v;
+            return 1;
+        }
+        S->skipped++;
+    }
+    return 0;
+}
+
+int key_stream_is_sorted(KeyStream* S){
+    size_t pos = S->pos, skipped = S->skipped;
+    int sorted = 1, first = 1, last = 0, key;
+    while (sorted && key_stream_get(S, &key)){
+        if (!first && key < last)
+            sorted = 0;
+        last = key;
+        first = 0;
+    }
+    S->pos = pos;
+    S->skipped = skipped;
+    return sorted;
+}
+
+int key_stream_parse_args(int argc, char** argv, const char** path, int* width){
+    if (argc == 1)
+        return 0;
+    if (argc == 3 && (strcmp(argv[1], "--keys") == 0 || strcmp(argv[1], "--keys64") == 0)){
+        *path = argv[2];
+        *width = (argv[1][6] == '6') ? 8 : 4;
+        return 1;
+    }
+    return -1;
+}
+
+int key_file_write(const char* path, const int* keys, size_t n, int width){
+    if (width != 4 && width != 8)
+        return -1;
+    FILE* f = fopen(path, "wb");
+    if (f == NULL)
+        return -1;
+    size_t written = 0;
+    if (width == 4){
+        written = fwrite(keys, sizeof(int), n, f);
+    }
+    else{
+        int64_t buf[4096];
+        while (written < n){
+            size_t k = (n - written < 4096) ? n - written : 4096;
+            for (size_t i = 0; i < k; i++)
+                buf[i] = keys[written + i];
+            if (fwrite(buf, sizeof(int64_t), k, f) != k)
+                break;
+            written += k;
+        }
+    }
+    int ok = (written == n);
+    if (fclose(f) != 0)
+        ok = 0;
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,426 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "limits.h"
+#include "../include/lockfree_bst.h"
+
+// Edge bits in the low two bits of a child pointer. flag: the leaf below is
+// being deleted. tag: the node above is being deleted and this edge must not
+// change any more. Both are only ever set, and a flagged or tagged edge is
+// never CASed again, so they freeze everything a cleanup is about to move.
+#define LF_FLAG ((uintptr_t)1)
+#define LF_TAG  ((uintptr_t)2)
+
+#define INF0 ((long long)INT_MAX + 1)
+#define INF1 ((long long)INT_MAX + 2)
+#define INF2 ((long long)INT_MAX + 3)
+
+#define LF_ADVANCE_EVERY 64      // retires between attempts to move the epoch on
+
+static LFNode* addr(uintptr_t v){
+    return (LFNode*)(v & ~(LF_FLAG | LF_TAG));
+}
+
+static uintptr_t load_edge(uintptr_t* e){
+    return __atomic_load_n(e, __ATOMIC_ACQUIRE);
+}
+
+static int cas_edge(uintptr_t* e, uintptr_t expected, uintptr_t desired){
+    return __atomic_compare_exchange_n(e, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static uintptr_t* child_slot(LFNode* x, long long key){
+    return key < x->key ? &x->left : &x->right;
+}
+
+static LFNode* new_node(long long key, LFNode* left, LFNode* right){
+    LFNode* x = (LFNode*)malloc(sizeof(LFNode));
+    x->key = key;
+    x->left = (uintptr_t)left;
+    x->right = (uintptr_t)right;
+    x->next_retired = NULL;
+    return x;
+}
+
+// R (inf2) has S (inf1) on the left and a leaf inf2 on the right, S has
+// leaves inf0 and inf1. Every real key is < inf0, so it always lands in S's
+// left subtree and a seek always has an ancestor, a successor and a parent.
+LFTree* lf_tree_create(void){
+    LFTree* T = (LFTree*)malloc(sizeof(LFTree));
+    LFNode* S = new_node(INF1, new_node(INF0, NULL, NULL), new_node(INF1, NULL, NULL));
+    T->R = new_node(INF2, S, new_node(INF2, NULL, NULL));
+    T->epoch = 1;
+    for (int i = 0; i < LF_MAX_THREADS; i++)
+        T->threads[i] = NULL;
+    T->orphans = NULL;
+    return T;
+}
+
+static void free_chain(LFNode* x){
+    while (x != NULL){
+        LFNode* next = x->next_retired;
+        free(x);
+        x = next;
+    }
+}
+
+// next_retired is unused in a live node, so it doubles as the walk stack
+void lf_tree_destroy(LFTree* T){
+    LFNode* stack = T->R;
+    while (stack != NULL){
+        LFNode* x = stack;
+        stack = x->next_retired;
+        if (x->left != 0){
+            LFNode* l = addr(x->left);
+            LFNode* r = addr(x->right);
+            l->next_retired = stack;
+            r->next_retired = l;
+            stack = r;
+        }
+        free(x);
+    }
+    for (int i = 0; i < LF_MAX_THREADS; i++){
+        LFThread* h = T->threads[i];
+        if (h != NULL){
+            for (int b = 0; b < 3; b++)
+                free_chain(h->limbo[b]);
+            free(h);
+        }
+    }
+    free_chain(T->orphans);
+    free(T);
+}
+
+// ---------- threads and epochs ----------
+
+LFThread* lf_thread_register(LFTree* T){
+    LFThread* h = (LFThread*)aligned_alloc(64, sizeof(LFThread));
+    h->T = T;
+    h->epoch = 0;
+    for (int b = 0; b < 3; b++){
+        h->limbo[b] = NULL;
+        h->limbo_epoch[b] = 0;
+    }
+    h->since_advance = 0;
+    for (int i = 0; i < LF_MAX_THREADS; i++){
+        LFThread* empty = NULL;
+        if (__atomic_compare_exchange_n(&T->threads[i], &empty, h, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            return h;
+    }
+    free(h);
+    return NULL;
+}
+
+// Our limbo may still be in use by others, hand it to the tree
+void lf_thread_unregister(LFThread* h){
+    LFTree* T = h->T;
+    for (int b = 0; b < 3; b++){
+        LFNode* first = h->limbo[b];
+        if (first == NULL)
+            continue;
+        LFNode* last = first;
+        while (last->next_retired != NULL)
+            last = last->next_retired;
+        LFNode* old = __atomic_load_n(&T->orphans, __ATOMIC_RELAXED);
+        do {
+            last->next_retired = old;
+        } while (!__atomic_compare_exchange_n(&T->orphans, &old, first, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+    for (int i = 0; i < LF_MAX_THREADS; i++){
+        if (__atomic_load_n(&T->threads[i], __ATOMIC_RELAXED) == h)
+            __atomic_store_n(&T->threads[i], NULL, __ATOMIC_SEQ_CST);
+    }
+    free(h);
+}
+
+// Same announce-and-recheck as conc_read_begin. Anything we retired in an
+// epoch at least two behind the current one is out of everybody's reach.
+static void enter(LFThread* h){
+    LFTree* T = h->T;
+    unsigned long e = __atomic_load_n(&T->epoch, __ATOMIC_ACQUIRE);
+    for (;;){
+        __atomic_store_n(&h->epoch, e, __ATOMIC_SEQ_CST);
+        unsigned long now = __atomic_load_n(&T->epoch, __ATOMIC_SEQ_CST);
+        if (now == e)
+            break;
+        e = now;
+    }
+    for (int b = 0; b < 3; b++){
+        if (h->limbo[b] != NULL && h->limbo_epoch[b] + 2 <= e){
+            free_chain(h->limbo[b]);
+            h->limbo[b] = NULL;
+        }
+    }
+}
+
+static void leave(LFThread* h){
+    __atomic_store_n(&h->epoch, 0, __ATOMIC_RELEASE);
+}
+
+// Move the global epoch on if every thread inside an operation has seen it.
+// Any of them may try, a lost CAS means someone else just did it.
+static void try_advance(LFTree* T){
+    unsigned long g = __atomic_load_n(&T->epoch, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < LF_MAX_THREADS; i++){
+        LFThread* o = __atomic_load_n(&T->threads[i], __ATOMIC_SEQ_CST);
+        if (o != NULL){
+            unsigned long oe = __atomic_load_n(&o->epoch, __ATOMIC_SEQ_CST);
+            if (oe != 0 && oe != g)
+                return;
+        }
+    }
+    __atomic_compare_exchange_n(&T->epoch, &g, g + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+// x is already unlinked. Stamp it with the global epoch read *after* the
+// unlink: nobody who got in later can reach it, and everybody who got in
+// earlier announced at most that epoch, so it is safe two epochs on.
+// A bucket holding an older epoch of the same residue is three behind: free.
+static void retire(LFThread* h, LFNode* x){
+    unsigned long s = __atomic_load_n(&h->T->epoch, __ATOMIC_SEQ_CST);
+    int b = (int)(s % 3);
+    if (h->limbo_epoch[b] != s){
+        free_chain(h->limbo[b]);
+        h->limbo[b] = NULL;
+        h->limbo_epoch[b] = s;
+    }
+    x->next_retired = h->limbo[b];
+    h->limbo[b] = x;
+    if (++h->since_advance >= LF_ADVANCE_EVERY){
+        h->since_advance = 0;
+        try_advance(h->T);
+    }
+}
+
+// ---------- the tree ----------
+
+typedef struct {
+    LFNode* ancestor;     // last node above an untagged edge
+    LFNode* successor;    // its child on the path: where a cleanup splices to
+    LFNode* parent;
+    LFNode* leaf;
+} SeekRecord;
+
+// Walk to the leaf for key. Nodes from successor down to parent hang off
+// tagged edges: they are all on their way out, and one CAS on the
+// ancestor's edge removes the lot.
+static void seek(LFTree* T, long long key, SeekRecord* sr){
+    LFNode* S = addr(T->R->left);
+    sr->ancestor = T->R;
+    sr->successor = S;
+    sr->parent = S;
+    uintptr_t parent_field = load_edge(&S->left);
+    sr->leaf = addr(parent_field);
+    uintptr_t current_field = load_edge(&sr->leaf->left);
+    LFNode* current = addr(current_field);
+    while (current != NULL){
+        if ((parent_field & LF_TAG) == 0){
+            sr->ancestor = sr->parent;
+            sr->successor = sr->leaf;
+        }
+        sr->parent = sr->leaf;
+        sr->leaf = current;
+        parent_field = current_field;
+        current_field = load_edge(child_slot(current, key));
+        current = addr(current_field);
+    }
+}
+
+// Finish the delete of whichever of parent's leaves is flagged: tag the
+// edge to the other child, then swing the ancestor's edge from successor
+// straight to that child (its flag travels with it). 1 if our CAS did it,
+// and then we are the one retiring what got cut out.
+static int cleanup(LFThread* h, long long key, SeekRecord* sr){
+    LFNode* ancestor = sr->ancestor;
+    LFNode* successor = sr->successor;
+    LFNode* parent = sr->parent;
+    uintptr_t* successor_addr = child_slot(ancestor, key);
+    uintptr_t* child_addr;
+    uintptr_t* sibling_addr;
+    if (key < parent->key){
+        child_addr = &parent->left;
+        sibling_addr = &parent->right;
+    }
+    else{
+        child_addr = &parent->right;
+        sibling_addr = &parent->left;
+    }
+    if ((load_edge(child_addr) & LF_FLAG) == 0)
+        sibling_addr = child_addr;          // the flagged leaf is on the other side
+    __atomic_fetch_or(sibling_addr, LF_TAG, __ATOMIC_SEQ_CST);
+    uintptr_t sibling = load_edge(sibling_addr) & ~LF_TAG;
+    if (!cas_edge(successor_addr, (uintptr_t)successor, sibling))
+        return 0;
+
+    // successor..parent hang off frozen edges, each with a flagged leaf on
+    // the side the path does not take
+    LFNode* x = successor;
+    while (x != parent){
+        uintptr_t* next = child_slot(x, key);
+        uintptr_t* other = (next == &x->left) ? &x->right : &x->left;
+        retire(h, addr(load_edge(other)));
+        LFNode* down = addr(load_edge(next));
+        retire(h, x);
+        x = down;
+    }
+    LFNode* moved = addr(sibling);
+    LFNode* gone = (addr(load_edge(&parent->left)) == moved) ? addr(load_edge(&parent->right))
+                                                            : addr(load_edge(&parent->left));
+    retire(h, gone);
+    retire(h, parent);
+    return 1;
+}
+
+int lf_tree_search(LFThread* h, int key){
+    enter(h);
+    LFNode* x = addr(load_edge(&h->T->R->left));
+    for (;;){
+        LFNode* next = addr(load_edge(child_slot(x, key)));
+        if (next == NULL)
+            break;
+        x = next;
+    }
+    int found = (x->key == key);
+    leave(h);
+    return found;
+}
+
+// Replace the leaf we land on by a new internal node over it and the new
+// leaf. The CAS only goes through on a clean edge: if the leaf is being
+// deleted, help that delete along and try again.
+int lf_tree_insert(LFThread* h, int key){
+    LFTree* T = h->T;
+    LFNode* new_leaf = NULL;
+    LFNode* new_internal = NULL;
+    SeekRecord sr;
+    enter(h);
+    for (;;){
+        seek(T, key, &sr);
+        LFNode* leaf = sr.leaf;
+        if (leaf->key == key)
+            break;
+        if (new_leaf == NULL){
+            new_leaf = new_node(key, NULL, NULL);
+            new_internal = new_node(0, NULL, NULL);
+        }
+        if (key < leaf->key){
+            new_internal->key = leaf->key;
+            new_internal->left = (uintptr_t)new_leaf;
+            new_internal->right = (uintptr_t)leaf;
+        }
+        else{
+            new_internal->key = key;
+            new_internal->left = (uintptr_t)leaf;
+            new_internal->right = (uintptr_t)new_leaf;
+        }
+        uintptr_t* slot = child_slot(sr.parent, key);
+        if (cas_edge(slot, (uintptr_t)leaf, (uintptr_t)new_internal)){
+            leave(h);
+            return 1;
+        }
+        uintptr_t now = load_edge(slot);
+        if (addr(now) == leaf && (now & (LF_FLAG | LF_TAG)) != 0)
+            cleanup(h, key, &sr);
+    }
+    leave(h);
+    free(new_leaf);            // never published
+    free(new_internal);
+    return 0;
+}
+
+// Injection: flag the edge to the leaf, which is the linearization point and
+// makes this thread the one that reports the delete. Cleanup: keep trying
+// (or let a helper do it) until that leaf is no longer in the tree.
+int lf_tree_delete(LFThread* h, int key){
+    LFTree* T = h->T;
+    LFNode* leaf = NULL;
+    SeekRecord sr;
+    enter(h);
+    for (;;){
+        seek(T, key, &sr);
+        uintptr_t* slot = child_slot(sr.parent, key);
+        if (leaf == NULL){
+            if (sr.leaf->key != key){
+                leave(h);
+                return 0;
+            }
+            if (cas_edge(slot, (uintptr_t)sr.leaf, (uintptr_t)sr.leaf | LF_FLAG)){
+                leaf = sr.leaf;
+                if (cleanup(h, key, &sr))
+                    break;
+            }
+            else{
+                uintptr_t now = load_edge(slot);
+                if (addr(now) == sr.leaf && (now & (LF_FLAG | LF_TAG)) != 0)
+                    cleanup(h, key, &sr);
+            }
+        }
+        else{
+            if (sr.leaf != leaf)    // a helper finished it
+                break;
+            if (cleanup(h, key, &sr))
+                break;
+        }
+    }
+    leave(h);
+    return 1;
+}
+
+// ---------- quiescent checks ----------
+
+// next_retired as the walk stack again, fine while nothing is in flight
+int lf_tree_count(LFTree* T){
+    int count = 0;
+    LFNode* stack = T->R;
+    T->R->next_retired = NULL;
+    while (stack != NULL){
+        LFNode* x = stack;
+        stack = x->next_retired;
+        if (x->left == 0){
+            if (x->key < INF0)
+                count++;
+            continue;
+        }
+        LFNode* l = addr(x->left);
+        LFNode* r = addr(x->right);
+        l->next_retired = stack;
+        r->next_retired = l;
+        stack = r;
+    }
+    return count;
+}
+
+typedef struct {
+    LFNode* x;
+    long long lo, hi;      // every key below x is in [lo, hi)
+} CheckItem;
+
+int lf_tree_validate(LFTree* T){
+    LFNode* S = addr(T->R->left);
+    if (T->R->key != INF2 || S->key != INF1 || addr(T->R->right)->key != INF2)
+        return 0;
+    int ok = 1;
+    int cap = 64, top = 0;
+    CheckItem* stack = (CheckItem*)malloc(cap * sizeof(CheckItem));
+    stack[top++] = (CheckItem){T->R, LLONG_MIN, LLONG_MAX};
+    while (top > 0 && ok){
+        CheckItem it = stack[--top];
+        LFNode* x = it.x;
+        if (x->key < it.lo || x->key >= it.hi)
+            ok = 0;
+        if (x->left == 0 && x->right == 0)
+            continue;
+        // internal: two children, no delete left half done
+        if (x->left == 0 || x->right == 0 || ((x->left | x->right) & (LF_FLAG | LF_TAG)) != 0){
+            ok = 0;
+            break;
+        }
+        if (top + 2 > cap){
+            cap *= 2;
+            stack = (CheckItem*)realloc(stack, cap * sizeof(CheckItem));
+        }
+        stack[top++] = (CheckItem){addr(x->left), it.lo, x->key};
+        stack[top++] = (CheckItem){addr(x->right), x->key, it.hi};
+    }
+    free(stack);
+    return ok;
+}
@@ -1,7 +1,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
 #include "../include/bst.h"
+#include "../include/arena.h"
+#include "../include/rb_tree.h"
+#include "../include/compact_tree.h"
+#include "../include/bplus_tree.h"
+#include "../include/treap.h"
+#include "../include/splay_tree.h"
+#include "../include/concurrent_bst.h"
+#include "../include/lockfree_bst.h"
+#include "../include/persistent_tree.h"
+#include "../include/tree_image.h"
+#include "../include/key_stream.h"
+#include <unistd.h>
+#include <pthread.h>
 #include "../include/utils.h"
 
 void test_basic_operations() {
@@ -157,11 +171,1115 @@ void test_shuffle_methods() {
     printf("\n=== Shuffle tests completed ===\n");
 }
 
+void test_arena_tree() {
+    printf("=== Testing Arena-Backed Tree ===\n");
+
+    Tree* T = create_arena_tree();
+    int keys[] = {15, 6, 18, 3, 7, 17, 20, 2, 4, 13, 9};
+    int n = sizeof(keys) / sizeof(keys[0]);
+
+    for (int i = 0; i < n; i++) {
+        tree_insert(T, tree_alloc_node(T, keys[i]));
+    }
+    printf("Inorder traversal: ");
+    inorder_tree_walk(T->root);
+    printf("\n");
+
+    // Deleted node goes on the free list and the next alloc reuses it
+    Node* to_delete = tree_search(T->root, 6);
+    tree_delete(T, to_delete);
+    tree_free_node(T, to_delete);
+    Node* reused = tree_alloc_node(T, 5);
+    tree_insert(T, reused);
+    printf("Reused freed node for key 5: %s\n", reused == to_delete ? "yes" : "no");
+
+    printf("Inorder after delete 6 / insert 5: ");
+    inorder_tree_walk(T->root);
+    printf("\n");
+
+    // Reset keeps the memory, tree can be rebuilt straight away
+    reset_arena_tree(T);
+    for (int i = 1; i <= 1000; i++) {
+        tree_insert(T, tree_alloc_node(T, i));
+    }
+    printf("Rebuilt after reset: min=%d max=%d\n", tree_min(T->root)->key, tree_max(T->root)->key);
+
+    destroy_arena_tree(T);
+
+    // a bulk load gets one big slab, the node allocs after it do not
+    int big = 200000;
+    int* sorted = generate_sequence(big);
+    T = tree_build_from_sorted(sorted, big);
+    for (int i = 0; i < 1000; i++) {
+        tree_insert(T, tree_alloc_node(T, big + 1 + i));
+    }
+    printf("Bulk load of %d + 1000 inserts: newest slab holds %zu nodes (< %d: %s)\n", big,
+           T->arena->slabs->capacity, big, T->arena->slabs->capacity < (size_t)big ? "yes" : "no");
+    destroy_arena_tree(T);
+    free(sorted);
+
+    printf("\n=== Arena tests completed ===\n\n");
+}
+
+void test_deep_chain_and_cursor() {
+    printf("=== Testing Degenerate Chain + Cursor ===\n");
+
+    // 10^6 deep right chain (what NoShuffle produces), linked directly
+    // since inserting sorted keys one by one would take O(n^2)
+    int n = 1000000;
+    Tree* T = create_tree();
+    Node* last = NULL;
+    for (int i = 1; i <= n; i++) {
+        Node* z = create_node(i);
+        if (last == NULL) {
+            T->root = z;
+        } else {
+            last->right = z;
+            z->p = last;
+        }
+        last = z;
+    }
+
+    printf("Chain height: %d (expected %d)\n", tree_height(T->root), n);
+    Node* found = tree_search(T->root, n);
+    printf("Search for %d: %s\n", n, found ? "Found" : "Not found");
+    inorder_tree_walk_silent(T->root);
+    printf("First 5 of chain: ");
+    inorder_tree_walk_limit(T->root, 5);
+    printf("\n");
+
+    TreeCursor c;
+    int count = 0;
+    for (Node* x = tree_cursor_begin(&c, T); x != NULL; x = tree_cursor_next(&c))
+        count++;
+    printf("Cursor visited %d nodes\n", count);
+    destroy_tree(T->root);
+    free(T);
+
+    // Cursor in both directions on a small tree
+    T = create_tree();
+    int keys[] = {15, 6, 18, 3, 7, 17, 20, 2, 4, 13, 9};
+    for (int i = 0; i < 11; i++) {
+        tree_insert(T, create_node(keys[i]));
+    }
+    printf("Cursor forward: ");
+    for (Node* x = tree_cursor_begin(&c, T); x != NULL; x = tree_cursor_next(&c))
+        printf("%d ", x->key);
+    printf("\nCursor backward: ");
+    for (Node* x = tree_cursor_last(&c, T); x != NULL; x = tree_cursor_prev(&c))
+        printf("%d ", x->key);
+    printf("\n");
+    destroy_tree(T->root);
+    free(T);
+
+    printf("\n=== Chain/cursor tests completed ===\n\n");
+}
+
+void test_red_black_tree() {
+    printf("=== Testing Red-Black Tree ===\n");
+
+    // Sorted input -> a plain BST would be a chain of height n
+    int n = 100000;
+    Tree* T = create_tree();
+    for (int i = 1; i <= n; i++) {
+        rb_tree_insert(T, create_node(i));
+    }
+    int height = tree_height(T->root);
+    printf("Sorted insert of %d keys: height=%d (bound 2*lg(n+1)=%.1f), black height=%d\n",
+           n, height, 2.0 * log2(n + 1), rb_validate(T));
+
+    // Delete every other key plus a random handful, checking properties after
+    for (int i = 2; i <= n; i += 2) {
+        Node* z = tree_search(T->root, i);
+        rb_tree_delete(T, z);
+        free(z);
+    }
+    for (int i = 0; i < 1000; i++) {
+        Node* z = tree_search(T->root, 2 * random_range(0, n / 2 - 1) + 1);
+        if (z) {
+            rb_tree_delete(T, z);
+            free(z);
+        }
+    }
+    int sorted = 1;
+    for (Node* x = tree_min(T->root); tree_successor(x) != NULL; x = tree_successor(x)) {
+        if (x->key >= tree_successor(x)->key) sorted = 0;
+    }
+    printf("After deletions: valid=%s, in order=%s, height=%d\n",
+           rb_validate(T) > 0 ? "yes" : "no", sorted ? "yes" : "no", tree_height(T->root));
+
+    destroy_tree(T->root);
+    free(T);
+
+    printf("\n=== Red-black tests completed ===\n\n");
+}
+
+void test_bulk_load() {
+    printf("=== Testing Bulk Load From Sorted Keys ===\n");
+
+    int n = 1000000;
+    int* keys = generate_sequence(n);
+    Tree* T = tree_build_from_sorted(keys, n);
+    printf("Bulk loaded %d keys: height=%d (min possible %d), red-black valid=%s\n",
+           n, tree_height(T->root), (int)floor(log2(n)) + 1, rb_validate(T) > 0 ? "yes" : "no");
+
+    // Result can keep growing as a red-black tree
+    for (int i = 0; i < 1000; i++) {
+        rb_tree_insert(T, tree_alloc_node(T, n + 1 + i));
+        Node* z = tree_search(T->root, 2 * i + 1);
+        rb_tree_delete(T, z);
+        tree_free_node(T, z);
+    }
+    printf("After 1000 rb inserts/deletes: valid=%s, min=%d, max=%d\n",
+           rb_validate(T) > 0 ? "yes" : "no", tree_min(T->root)->key, tree_max(T->root)->key);
+    destroy_arena_tree(T);
+
+    for (int m = 0; m <= 4; m++) {
+        T = tree_build_from_sorted(keys, m);
+        printf("n=%d: height=%d, keys: ", m, tree_height(T->root));
+        inorder_tree_walk(T->root);
+        printf("\n");
+        destroy_arena_tree(T);
+    }
+    free(keys);
+
+    printf("\n=== Bulk load tests completed ===\n\n");
+}
+
+void test_compact_tree() {
+    printf("=== Testing Compact (32-bit index) Tree ===\n");
+    printf("sizeof(Node)=%zu, sizeof(CNode)=%zu\n", sizeof(Node), sizeof(CNode));
+
+    CompactTree* T = ctree_create(4);   // small on purpose so the array has to grow
+    int keys[] = {15, 6, 18, 3, 7, 17, 20, 2, 4, 13, 9};
+    int n = sizeof(keys) / sizeof(keys[0]);
+    for (int i = 0; i < 100; i++) {
+        ctree_insert(T, 1000 + i);
+    }
+    for (int i = 0; i < n; i++) {
+        ctree_insert(T, keys[i]);
+    }
+    for (int i = 0; i < 100; i++) {
+        ctree_delete(T, ctree_search(T, 1000 + i));
+    }
+
+    printf("Inorder traversal: ");
+    for (uint32_t x = ctree_min(T, T->root); x != CNIL; x = ctree_successor(T, x))
+        printf("%d ", T->nodes[x].key);
+    printf("\n");
+
+    ctree_delete(T, ctree_search(T, 6));
+    printf("Search for 6 after delete: %s, search for 13: %s\n",
+           ctree_search(T, 6) == CNIL ? "Not found" : "Found",
+           ctree_search(T, 13) == CNIL ? "Not found" : "Found");
+    printf("Min: %d, Max: %d\n", T->nodes[ctree_min(T, T->root)].key, T->nodes[ctree_max(T, T->root)].key);
+    ctree_destroy(T);
+
+    // 2^32 - 1 slots handed out: the array can not grow, insert refuses
+    T = ctree_create(4);
+    ctree_insert(T, 1);
+    uint32_t real_used = T->used, real_capacity = T->capacity;
+    T->used = T->capacity = UINT32_MAX;
+    uint32_t refused = ctree_insert(T, 2);
+    T->used = real_used;
+    T->capacity = real_capacity;
+    printf("Insert into a full 32-bit array: refused=%s, tree unchanged=%s\n", refused == CNIL ? "yes" : "no",
+           ctree_search(T, 2) == CNIL && ctree_search(T, 1) != CNIL ? "yes" : "no");
+    ctree_destroy(T);
+
+    printf("\n=== Compact tree tests completed ===\n\n");
+}
+
+void test_bplus_tree() {
+    printf("=== Testing B+-Tree (%d-byte nodes, %d keys per leaf, fanout %d) ===\n",
+           BPT_NODE_BYTES, BPT_LEAF_KEYS, BPT_INNER_KEYS + 1);
+
+    BPlusTree* T = bpt_create(0);
+    int keys[] = {15, 6, 18, 3, 7, 17, 20, 2, 4, 13, 9};
+    int n = sizeof(keys) / sizeof(keys[0]);
+    for (int i = 0; i < n; i++) {
+        bpt_insert(T, keys[i]);
+    }
+    printf("Inorder traversal: ");
+    bpt_inorder_walk(T);
+    printf("\n");
+    bpt_delete(T, 6);
+    printf("Search for 6 after delete: %s, search for 13: %s\n",
+           bpt_search(T, 6).leaf ? "Found" : "Not found", bpt_search(T, 13).leaf ? "Found" : "Not found");
+    printf("Min: %d, Max: %d, successor of 7: %d\n", bpt_key(bpt_min(T)), bpt_key(bpt_max(T)),
+           bpt_key(bpt_successor(bpt_search(T, 7))));
+    bpt_destroy(T);
+
+    // Big shuffled load, then delete every other key -> splits and merges on every level
+    int big = 1000000;
+    int* big_keys = generate_sequence(big);
+    fisher_yates(big_keys, big);
+    T = bpt_create(0);
+    for (int i = 0; i < big; i++) {
+        bpt_insert(T, big_keys[i]);
+    }
+    printf("%d shuffled keys: height=%d, valid=%s\n", big, T->height, bpt_validate(T) >= 0 ? "yes" : "no");
+    for (int i = 0; i < big; i++) {
+        if (big_keys[i] % 2 == 0) bpt_delete(T, big_keys[i]);
+    }
+    int sorted = 1;
+    int k = bpt_to_array(T, big_keys);
+    for (int i = 0; i < k; i++) {
+        if (big_keys[i] != 2 * i + 1) sorted = 0;
+    }
+    printf("After deleting even keys: n=%d, height=%d, valid=%s, odd keys in order=%s\n",
+           T->n, T->height, bpt_validate(T) >= 0 ? "yes" : "no", sorted ? "yes" : "no");
+    bpt_destroy(T);
+    free(big_keys);
+
+    printf("\n=== B+-tree tests completed ===\n\n");
+}
+
+void test_search_batch() {
+    printf("=== Testing Batched Search ===\n");
+
+    int n = 100000;
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    Tree* T = create_tree();
+    for (int i = 0; i < n; i++) {
+        tree_insert(T, create_node(2 * keys[i]));   // even keys, odd queries miss
+    }
+
+    int m = 3 * n + 5;                               // not a multiple of the in-flight group
+    int* queries = (int*)malloc(m * sizeof(int));
+    Node** out = (Node**)malloc(m * sizeof(Node*));
+    for (int j = 0; j < m; j++) {
+        queries[j] = j - 2;
+    }
+    tree_search_batch(T, queries, m, out);
+    int same = 1;
+    for (int j = 0; j < m; j++) {
+        if (out[j] != tree_search(T->root, queries[j])) same = 0;
+    }
+    printf("%d batched lookups (hits and misses) match tree_search: %s\n", m, same ? "yes" : "no");
+
+    tree_search_batch(T, queries + 4, 3, out);       // fewer keys than slots
+    printf("Small batch {2, 3, 4}: %s %s %s\n", out[0] ? "Found" : "Not found",
+           out[1] ? "Found" : "Not found", out[2] ? "Found" : "Not found");
+
+    free(queries);
+    free(out);
+    destroy_tree(T->root);
+    free(T);
+    free(keys);
+
+    printf("\n=== Batched search tests completed ===\n\n");
+}
+
+// keys in order and n of them -> still a valid BST
+static int sorted_with_count(Tree* T, int n) {
+    int count = 0;
+    for (Node* x = (T->root ? tree_min(T->root) : NULL); x != NULL; x = tree_successor(x)) {
+        Node* s = tree_successor(x);
+        if (s != NULL && s->key < x->key) return 0;
+        count++;
+    }
+    return count == n;
+}
+
+void test_hinted_insert() {
+    printf("=== Testing Hinted Insert ===\n");
+
+    // ascending and descending streams, previous insert as the hint
+    int n = 1000000;
+    Tree* T = create_arena_tree();
+    Node* last = NULL;
+    for (int i = 1; i <= n; i++) {
+        Node* z = tree_alloc_node(T, i);
+        tree_insert_hint(T, last, z);
+        last = z;
+    }
+    printf("Ascending %d keys: height=%d, sorted=%s\n", n, tree_height(T->root), sorted_with_count(T, n) ? "yes" : "no");
+    reset_arena_tree(T);
+    last = NULL;
+    for (int i = n; i >= 1; i--) {
+        Node* z = tree_alloc_node(T, i);
+        tree_insert_hint(T, last, z);
+        last = z;
+    }
+    printf("Descending %d keys: height=%d, sorted=%s\n", n, tree_height(T->root), sorted_with_count(T, n) ? "yes" : "no");
+    destroy_arena_tree(T);
+
+    // random tree of even keys, then each odd key next to its predecessor
+    int m = 100000;
+    int* keys = generate_sequence(m);
+    fisher_yates(keys, m);
+    T = create_tree();
+    for (int i = 0; i < m; i++) {
+        tree_insert(T, create_node(2 * keys[i]));
+    }
+    for (int i = 0; i < m; i++) {
+        tree_insert_hint(T, tree_search(T->root, 2 * keys[i]), create_node(2 * keys[i] + 1));
+    }
+    // hints that are not neighbours: root, min and max for keys far away from them
+    for (int i = 0; i < 100; i++) {
+        tree_insert_hint(T, T->root, create_node(-i));
+        tree_insert_hint(T, tree_max(T->root), create_node(i));
+        tree_insert_hint(T, tree_min(T->root), create_node(2 * m + 10 + i));
+    }
+    printf("Random tree + %d neighbour hints + 300 bad hints: sorted=%s\n", m, sorted_with_count(T, 2 * m + 300) ? "yes" : "no");
+    destroy_tree(T->root);
+    free(T);
+    free(keys);
+
+    // nearly sorted stream, previous insert as the hint even when it steps back:
+    // 120 90 100 150 used to land 150 left of 120
+    int small[] = {120, 90, 100, 150};
+    T = create_tree();
+    last = NULL;
+    for (int i = 0; i < 4; i++) {
+        Node* z = create_node(small[i]);
+        tree_insert_hint(T, last, z);
+        last = z;
+    }
+    int found = sorted_with_count(T, 4) && tree_search(T->root, 150) != NULL;
+    destroy_tree(T->root);
+    free(T);
+    T = create_arena_tree();
+    last = NULL;
+    for (int i = 0; i < m; i++) {
+        Node* z = tree_alloc_node(T, 10 * i + rand() % 25);   // runs forward, now and then a key below the last few
+        tree_insert_hint(T, last, z);
+        last = z;
+    }
+    rb_tree_insert(T, tree_alloc_node(T, 20 * m));    // new max behind the hint cache's back
+    tree_insert_hint(T, last, tree_alloc_node(T, 10 * m + 30));
+    for (Node* x = tree_min(T->root); x != NULL; x = tree_successor(x)) {
+        if (tree_search(T->root, x->key) == NULL) found = 0;
+    }
+    printf("Nearly sorted %d keys, previous node as hint: sorted=%s, search finds all=%s\n", m,
+           sorted_with_count(T, m + 2) ? "yes" : "no", found ? "yes" : "no");
+    destroy_arena_tree(T);
+
+    printf("\n=== Hinted insert tests completed ===\n\n");
+}
+
+// keys of T in order into out, returns how many
+static int treap_keys(Tree* T, int* out) {
+    int k = 0;
+    for (Node* x = (T->root ? tree_min(T->root) : NULL); x != NULL; x = tree_successor(x))
+        out[k++] = x->key;
+    return k;
+}
+
+void test_treap() {
+    printf("=== Testing Treap ===\n");
+
+    // sorted input, no shuffle: still about the height of a random BST
+    int n = 1000000;
+    Tree* T = create_tree();
+    for (int i = 1; i <= n; i++) {
+        treap_insert(T, create_node(i));
+    }
+    printf("%d sorted inserts: height=%d (lg n = %.0f), valid=%s\n", n, tree_height(T->root),
+           log2(n), treap_validate(T) ? "yes" : "no");
+    for (int i = 1; i <= n; i += 2) {
+        Node* z = tree_search(T->root, i);
+        treap_delete(T, z);
+        free(z);
+    }
+    printf("After deleting odd keys: min=%d, max=%d, valid=%s\n", tree_min(T->root)->key,
+           tree_max(T->root)->key, treap_validate(T) ? "yes" : "no");
+    destroy_tree(T->root);
+    free(T);
+
+    // lots of copies of few keys: the copies must not stack into a chain
+    T = create_tree();
+    for (int i = 0; i < 20000; i++) {
+        treap_insert(T, create_node(rand() % 4));
+    }
+    printf("20000 inserts of 4 distinct keys: height=%d (< 100: %s), valid=%s\n", tree_height(T->root),
+           tree_height(T->root) < 100 ? "yes" : "no", treap_validate(T) ? "yes" : "no");
+    destroy_tree(T->root);
+    free(T);
+
+    // split at 10, join back
+    int keys[] = {15, 6, 18, 3, 7, 17, 20, 2, 4, 13, 9};
+    int m = sizeof(keys) / sizeof(keys[0]);
+    T = create_tree();
+    for (int i = 0; i < m; i++) {
+        treap_insert(T, create_node(keys[i]));
+    }
+    Tree* L = create_tree();
+    Tree* R = create_tree();
+    treap_split(T, 10, L, R);
+    printf("Split at 10: L = ");
+    inorder_tree_walk(L->root);
+    printf(", R = ");
+    inorder_tree_walk(R->root);
+    printf("\n");
+    treap_join(T, L, R);
+    printf("Joined: ");
+    inorder_tree_walk(T->root);
+    printf(" valid=%s\n", treap_validate(T) ? "yes" : "no");
+    destroy_tree(T->root);
+    free(T);
+
+    // multiples of 2 and of 3 below 30
+    int out[32];
+    const char* names[] = {"union", "intersection", "difference"};
+    for (int op = 0; op < 3; op++) {
+        Tree* A = create_tree();
+        Tree* B = create_tree();
+        for (int i = 0; i < 30; i++) {
+            if (i % 2 == 0) treap_insert(A, create_node(i));
+            if (i % 3 == 0) treap_insert(B, create_node(i));
+        }
+        if (op == 0) treap_union(A, B);
+        if (op == 1) treap_intersection(A, B);
+        if (op == 2) treap_difference(A, B);
+        int k = treap_keys(A, out);
+        printf("%s of 2Z and 3Z below 30: ", names[op]);
+        for (int i = 0; i < k; i++) printf("%d ", out[i]);
+        printf("(valid=%s, B empty=%s)\n", treap_validate(A) ? "yes" : "no", B->root == NULL ? "yes" : "no");
+        destroy_tree(A->root);
+        free(A);
+        free(B);
+    }
+    free(L);
+    free(R);
+
+    printf("\n=== Treap tests completed ===\n\n");
+}
+
+void test_scapegoat() {
+    printf("=== Testing Scapegoat Mode + DSW Rebalance ===\n");
+
+    // sorted keys would make a 10^6 chain, scapegoat mode keeps it shallow
+    int n = 1000000;
+    Tree* T = create_arena_tree();
+    tree_set_scapegoat(T, 0.7);
+    for (int i = 1; i <= n; i++) {
+        tree_insert(T, tree_alloc_node(T, i));
+    }
+    printf("%d sorted inserts, alpha=0.7: height=%d (limit %.0f), sorted=%s\n", n, tree_height(T->root),
+           floor(log(n) / log(1 / 0.7)) + 1, sorted_with_count(T, n) ? "yes" : "no");
+    for (int i = 1; i <= n; i++) {
+        if (i % 4 != 0) {
+            Node* z = tree_search(T->root, i);
+            tree_delete(T, z);
+            tree_free_node(T, z);
+        }
+    }
+    printf("After deleting 3/4 of the keys: n=%d, height=%d, sorted=%s\n", T->sg_size,
+           tree_height(T->root), sorted_with_count(T, n / 4) ? "yes" : "no");
+    destroy_arena_tree(T);
+
+    // plain chain -> one DSW pass -> minimum height
+    T = create_arena_tree();
+    Node* last = NULL;
+    for (int i = 1; i <= n; i++) {
+        Node* z = tree_alloc_node(T, i);
+        tree_insert_hint(T, last, z);
+        last = z;
+    }
+    int before = tree_height(T->root);
+    tree_rebalance(T);
+    printf("tree_rebalance on a %d chain: height %d -> %d, sorted=%s\n", before, before,
+           tree_height(T->root), sorted_with_count(T, n) ? "yes" : "no");
+    destroy_arena_tree(T);
+
+    for (int m = 0; m <= 4; m++) {
+        T = create_tree();
+        for (int i = 1; i <= m; i++) {
+            tree_insert(T, create_node(i));
+        }
+        tree_rebalance(T);
+        printf("n=%d rebalanced: height=%d, keys: ", m, tree_height(T->root));
+        inorder_tree_walk(T->root);
+        printf("\n");
+        destroy_tree(T->root);
+        free(T);
+    }
+
+    printf("\n=== Scapegoat tests completed ===\n\n");
+}
+
+void test_splay_tree() {
+    printf("=== Testing Splay Tree ===\n");
+
+    // sorted inserts: each new max is splayed up, the tree is a left chain
+    int n = 100000;
+    Tree* T = create_arena_tree();
+    for (int i = 1; i <= n; i++) {
+        splay_tree_insert(T, tree_alloc_node(T, i));
+    }
+    printf("%d sorted inserts: root=%d, height=%d, sorted=%s\n", n, T->root->key,
+           tree_height(T->root), sorted_with_count(T, n) ? "yes" : "no");
+
+    // one pass over the keys in order roughly halves the depth every time
+    splay_tree_search(T, 1);
+    printf("After searching 1: root=%d, height=%d\n", T->root->key, tree_height(T->root));
+    for (int i = 1; i <= n; i += 97) {
+        splay_tree_search(T, i);
+    }
+    printf("After searching every 97th key: height=%d, sorted=%s\n", tree_height(T->root),
+           sorted_with_count(T, n) ? "yes" : "no");
+
+    // a hot key stays at the root, a miss splays its neighbour
+    Node* hit = splay_tree_search(T, 4242);
+    Node* miss = splay_tree_search(T, n + 5);
+    printf("Hit 4242 at root=%s, miss n+5 returns %s with root=%d\n",
+           hit != NULL && hit->key == 4242 ? "yes" : "no", miss == NULL ? "NULL" : "node", T->root->key);
+    int lo = splay_tree_min(T)->key;
+    printf("min=%d (root=%d), ", lo, T->root->key);
+    int hi = splay_tree_max(T)->key;
+    printf("max=%d (root=%d)\n", hi, T->root->key);
+
+    // delete the odd keys in random order
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    for (int i = 0; i < n; i++) {
+        if (keys[i] % 2 == 1) {
+            Node* z = tree_search(T->root, keys[i]);
+            splay_tree_delete(T, z);
+            tree_free_node(T, z);
+        }
+    }
+    int even_only = T->root == NULL || T->root->p == NULL;
+    for (Node* x = tree_min(T->root); x != NULL; x = tree_successor(x)) {
+        if (x->key % 2 != 0) even_only = 0;
+    }
+    printf("After deleting odd keys: sorted=%s, only evens=%s, height=%d\n",
+           sorted_with_count(T, n / 2) ? "yes" : "no", even_only ? "yes" : "no", tree_height(T->root));
+    free(keys);
+    destroy_arena_tree(T);
+
+    // duplicates + delete down to empty
+    T = create_tree();
+    int dup[] = {5, 3, 5, 8, 5, 1};
+    for (int i = 0; i < 6; i++) {
+        splay_tree_insert(T, create_node(dup[i]));
+    }
+    printf("Keys with duplicates: ");
+    inorder_tree_walk(T->root);
+    while (T->root != NULL) {
+        Node* z = T->root;
+        splay_tree_delete(T, z);
+        free(z);
+    }
+    printf(" -> deleted all, empty=%s\n", T->root == NULL ? "yes" : "no");
+    free(T);
+
+    printf("\n=== Splay tree tests completed ===\n\n");
+}
+
+// same keys, colours and links (parent/children by key) in both trees
+static int same_shape(Tree* A, Tree* B) {
+    Node* x = A->root ? tree_min(A->root) : NULL;
+    Node* y = B->root ? tree_min(B->root) : NULL;
+    for (; x != NULL && y != NULL; x = tree_successor(x), y = tree_successor(y)) {
+        if (x->key != y->key || x->color != y->color) return 0;
+        if ((x->p == NULL) != (y->p == NULL) || (x->p && x->p->key != y->p->key)) return 0;
+        if ((x->left == NULL) != (y->left == NULL) || (x->right == NULL) != (y->right == NULL)) return 0;
+    }
+    return x == NULL && y == NULL;
+}
+
+void test_parallel_build() {
+    printf("=== Testing Parallel Build ===\n");
+
+    int sizes[] = {0, 5, 1000, 1000003};
+    int thread_counts[] = {1, 2, 3, 8};
+    for (int s = 0; s < 4; s++) {
+        int n = sizes[s];
+        int* sorted = generate_sequence(n);
+        Tree* ref = tree_build_from_sorted(sorted, n);
+        printf("n=%d:", n);
+        for (int t = 0; t < 4; t++) {
+            int* keys = generate_sequence(n);
+            fisher_yates(keys, n);
+            Tree* T = tree_build_parallel(keys, n, thread_counts[t]);
+            int keys_sorted = 1;
+            for (int i = 0; i < n; i++) {
+                if (keys[i] != i + 1) keys_sorted = 0;
+            }
+            printf(" %d threads -> %s%s;", thread_counts[t], same_shape(T, ref) ? "same tree" : "DIFFERENT",
+                   keys_sorted ? "" : " (keys not sorted)");
+            destroy_arena_tree(T);
+            free(keys);
+        }
+        printf(" red-black valid=%s\n", n == 0 || rb_validate(ref) > 0 ? "yes" : "no");
+        destroy_arena_tree(ref);
+        free(sorted);
+    }
+
+    // duplicates, negative keys and an odd thread count
+    int n = 100000;
+    int* keys = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) keys[i] = rand() % 1000 - 500;
+    Tree* T = tree_build_parallel(keys, n, 5);
+    printf("%d keys in -500..499, 5 threads: height=%d, sorted=%s\n", n, tree_height(T->root),
+           sorted_with_count(T, n) ? "yes" : "no");
+    destroy_arena_tree(T);
+    free(keys);
+
+    printf("\n=== Parallel build tests completed ===\n\n");
+}
+
+void test_fast_teardown() {
+    printf("=== Testing Fast Teardown ===\n");
+
+    // random, chain and tiny trees on 1..8 threads, every node has to be freed once
+    int n = 200000;
+    int thread_counts[] = {1, 2, 3, 8};
+    for (int t = 0; t < 4; t++) {
+        int* keys = generate_sequence(n);
+        fisher_yates(keys, n);
+        Tree* T = create_tree();
+        for (int i = 0; i < n; i++) {
+            tree_insert(T, create_node(keys[i]));
+        }
+        int all = destroy_tree_parallel(T->root, thread_counts[t]) == n;
+        free(T);
+        free(keys);
+
+        T = create_tree();
+        Node* last = NULL;
+        for (int i = 1; i <= 50000; i++) {
+            Node* z = create_node(i);
+            tree_insert_hint(T, last, z);
+            last = z;
+        }
+        all = all && destroy_tree_parallel(T->root, thread_counts[t]) == 50000;
+        free(T);
+
+        for (int m = 0; m <= 3; m++) {
+            T = create_tree();
+            for (int i = 1; i <= m; i++) {
+                tree_insert(T, create_node(i));
+            }
+            all = all && destroy_tree_parallel(T->root, thread_counts[t]) == m;
+            free(T);
+        }
+        printf("%d threads: random %d-node tree, 50000 chain, 0..3 nodes, all freed=%s\n", thread_counts[t], n,
+               all ? "yes" : "no");
+    }
+
+    // only the subtree goes, the rest of the tree is untouched
+    Tree* T = create_tree();
+    int keys[] = {8, 4, 12, 2, 6, 10, 14, 1, 3, 5, 7};
+    for (int i = 0; i < 11; i++) {
+        tree_insert(T, create_node(keys[i]));
+    }
+    Node* sub = T->root->left;
+    T->root->left = NULL;
+    printf("Freed the left subtree of 8 (%ld nodes), left: ", destroy_tree_parallel(sub, 2));
+    inorder_tree_walk(T->root);
+    printf("\n");
+    destroy_tree(T->root);
+    free(T);
+
+    printf("\n=== Fast teardown tests completed ===\n\n");
+}
+
+// readers for test_concurrent_tree: even keys are never deleted, so every
+// lookup of one has to hit while the writer churns the odd keys around them
+typedef struct {
+    ConcurrentTree* CT;
+    int n;
+    int* stop;
+    long lookups;
+    long even_misses;
+    unsigned int seed;
+} ConcTestReader;
+
+static void* conc_test_reader(void* arg) {
+    ConcTestReader* a = (ConcTestReader*)arg;
+    ConcReader* r = conc_reader_register(a->CT);
+    while (!__atomic_load_n(a->stop, __ATOMIC_RELAXED)) {
+        int key = 2 * (1 + rand_r(&a->seed) % (a->n / 2));
+        if (!conc_tree_search(r, key)) a->even_misses++;
+        conc_tree_search(r, key - 1);
+        a->lookups += 2;
+    }
+    conc_reader_unregister(r);
+    return NULL;
+}
+
+void test_concurrent_tree() {
+    printf("=== Testing Concurrent Mode (lock-free readers) ===\n");
+
+    int n = 20000;
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    ConcurrentTree* CT = conc_tree_create();
+    for (int i = 0; i < n; i++) {
+        conc_tree_insert(CT, keys[i]);
+    }
+
+    int stop = 0;
+    ConcTestReader args[3];
+    pthread_t tid[3];
+    for (int t = 0; t < 3; t++) {
+        args[t] = (ConcTestReader){CT, n, &stop, 0, 0, 12345u + t};
+        pthread_create(&tid[t], NULL, conc_test_reader, &args[t]);
+    }
+    int ops = 200000, deleted = 0;
+    for (int i = 0; i < ops; i++) {                 // take an odd key out and put it back
+        int key = 2 * (rand() % (n / 2)) + 1;
+        deleted += conc_tree_delete(CT, key);
+        conc_tree_insert(CT, key);
+    }
+    __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+    long lookups = 0, misses = 0;
+    for (int t = 0; t < 3; t++) {
+        pthread_join(tid[t], NULL);
+        lookups += args[t].lookups;
+        misses += args[t].even_misses;
+    }
+
+    int all = sorted_with_count(CT->T, n);
+    for (int k = 1; k <= n; k++) {
+        if (tree_search(CT->T->root, k) == NULL) all = 0;
+    }
+    printf("3 readers, %d deletes + %d inserts: misses on never-deleted keys=%ld (of %ld lookups)\n",
+           deleted, ops, misses, lookups);
+    printf("After the writer: all %d keys present=%s, nodes still in limbo=%ld\n", n, all ? "yes" : "no",
+           CT->retired);
+
+    ConcReader* r = conc_reader_register(CT);
+    conc_read_begin(r);
+    Node* x = conc_tree_search_node(r, 42);
+    conc_tree_delete(CT, 42);                       // retired, but x is ours until read_end
+    printf("Held node across a delete: key=%d, still found=%s", x->key, conc_tree_search_node(r, 42) ? "yes" : "no");
+    conc_read_end(r);
+    printf(", after read_end found=%s\n", conc_tree_search(r, 42) ? "yes" : "no");
+    conc_reader_unregister(r);
+    conc_tree_destroy(CT);
+    free(keys);
+
+    printf("\n=== Concurrent mode tests completed ===\n\n");
+}
+
+// workers for test_lockfree_bst: keys 1..n are split by key % threads, so
+// the owner always knows whether its own key is in; keys n+1..n+LF_HOT are
+// fought over by everyone, and per key the successful inserts minus deletes
+// summed over all threads must come out at 0 or 1, matching the tree
+#define LF_HOT 64
+
+typedef struct {
+    LFTree* T;
+    int t, threads, n, ops;
+    char* present;          // only written for our own keys
+    int net[LF_HOT];
+    int wrong;              // own-key results that disagree with present[]
+    unsigned int seed;
+} LFTestWorker;
+
+static void* lf_test_worker(void* arg) {
+    LFTestWorker* w = (LFTestWorker*)arg;
+    LFThread* h = lf_thread_register(w->T);
+    for (int i = 0; i < w->ops; i++) {
+        int r = rand_r(&w->seed);
+        if (r % 4 == 0) {
+            int j = rand_r(&w->seed) % LF_HOT;
+            if (r % 8 == 0) w->net[j] += lf_tree_insert(h, w->n + 1 + j);
+            else w->net[j] -= lf_tree_delete(h, w->n + 1 + j);
+            continue;
+        }
+        int key = w->t + 1 + w->threads * (rand_r(&w->seed) % (w->n / w->threads));
+        if (r % 4 == 1) {
+            if (lf_tree_insert(h, key) == w->present[key]) w->wrong++;
+            w->present[key] = 1;
+        }
+        else if (r % 4 == 2) {
+            if (lf_tree_delete(h, key) != w->present[key]) w->wrong++;
+            w->present[key] = 0;
+        }
+        else {
+            if (lf_tree_search(h, key) != w->present[key]) w->wrong++;
+        }
+    }
+    lf_thread_unregister(h);
+    return NULL;
+}
+
+void test_lockfree_bst() {
+    printf("=== Testing Lock-Free BST ===\n");
+
+    int n = 20000, threads = 4, ops = 200000;
+    LFTree* T = lf_tree_create();
+    LFThread* h = lf_thread_register(T);
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    char* present = (char*)calloc(n + 1, 1);
+    int dup = 0;
+    for (int i = 0; i < n; i += 2) {
+        lf_tree_insert(h, keys[i]);
+        present[keys[i]] = 1;
+        dup += lf_tree_insert(h, keys[i]);
+    }
+    printf("Single thread: %d shuffled inserts, count=%d, re-inserts accepted=%d, valid=%s\n",
+           n / 2, lf_tree_count(T), dup, lf_tree_validate(T) ? "yes" : "no");
+    int found = lf_tree_search(h, keys[0]);
+    int first = lf_tree_delete(h, keys[0]);
+    int again = lf_tree_delete(h, keys[0]);
+    printf("search(%d)=%d, delete=%d, delete again=%d, search after=%d, delete(0)=%d\n", keys[0], found,
+           first, again, lf_tree_search(h, keys[0]), lf_tree_delete(h, 0));
+    present[keys[0]] = 0;
+    lf_thread_unregister(h);
+
+    LFTestWorker w[4];
+    pthread_t tid[4];
+    for (int t = 0; t < threads; t++) {
+        w[t] = (LFTestWorker){T, t, threads, n, ops, present, {0}, 0, 777u + t};
+        pthread_create(&tid[t], NULL, lf_test_worker, &w[t]);
+    }
+    int wrong = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tid[t], NULL);
+        wrong += w[t].wrong;
+    }
+
+    h = lf_thread_register(T);
+    int expect = 0, mismatched = 0, hot_bad = 0;
+    for (int k = 1; k <= n; k++) {
+        expect += present[k];
+        if (lf_tree_search(h, k) != present[k]) mismatched++;
+    }
+    for (int j = 0; j < LF_HOT; j++) {
+        int net = 0;
+        for (int t = 0; t < threads; t++) net += w[t].net[j];
+        if (net < 0 || net > 1 || net != lf_tree_search(h, n + 1 + j)) hot_bad++;
+        expect += lf_tree_search(h, n + 1 + j);
+    }
+    lf_thread_unregister(h);
+    printf("%d threads x %d mixed ops: wrong own-key results=%d, final mismatches=%d, bad hot keys=%d\n",
+           threads, ops, wrong, mismatched, hot_bad);
+    printf("Final tree: count=%d (expected %d), valid=%s\n", lf_tree_count(T), expect,
+           lf_tree_validate(T) ? "yes" : "no");
+
+    lf_tree_destroy(T);
+    free(present);
+    free(keys);
+
+    printf("\n=== Lock-free BST tests completed ===\n\n");
+}
+
+// in-order check for test_persistent_tree: keys sorted, returns the count
+static int pnode_sorted_count(PNode* x, int* last, int* sorted) {
+    if (x == NULL) return 0;
+    int c = pnode_sorted_count(x->left, last, sorted);
+    if (x->key < *last) *sorted = 0;
+    *last = x->key;
+    return c + 1 + pnode_sorted_count(x->right, last, sorted);
+}
+
+static int pnode_depth_of(PNode* root, int key) {
+    int d = 0;
+    for (PNode* x = root; x != NULL && x->key != key; x = (key < x->key) ? x->left : x->right) d++;
+    return d;
+}
+
+void test_persistent_tree() {
+    printf("=== Testing Persistent (Path-Copying) BST ===\n");
+
+    int n = 10000;
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    PNode* v = NULL;
+    PNode* snaps[3] = {NULL, NULL, NULL};    // after n/4, n/2 and n inserts
+    for (int i = 0; i < n; i++) {
+        PNode* next = ptree_insert(v, keys[i]);
+        ptree_release(v);
+        v = next;
+        if (i + 1 == n / 4) snaps[0] = ptree_retain(v);
+        if (i + 1 == n / 2) snaps[1] = ptree_retain(v);
+    }
+    snaps[2] = ptree_retain(v);
+    printf("%d shuffled inserts, 3 snapshots kept: live nodes=%ld (tree + full copies would be %d)\n", n,
+           ptree_live_nodes(), n + n / 4 + n / 2 + n);
+
+    long before = ptree_live_nodes();
+    int depth = pnode_depth_of(v, keys[0]);
+    PNode* del = ptree_delete(v, keys[0]);
+    printf("Delete of key at depth %d: %ld new nodes, old version still finds it=%s, new one=%s\n", depth,
+           ptree_live_nodes() - before, ptree_search(v, keys[0]) ? "yes" : "no", ptree_search(del, keys[0]) ? "yes" : "no");
+    ptree_release(v);
+    v = del;
+
+    for (int i = 1; i < n; i += 2) {              // churn: every other key out
+        PNode* next = ptree_delete(v, keys[i]);
+        ptree_release(v);
+        v = next;
+    }
+    PNode* same = ptree_delete(v, -1);            // absent key -> same version back
+    printf("Delete of an absent key returns the same version=%s\n", same == v ? "yes" : "no");
+    ptree_release(same);
+
+    int expect[3] = {n / 4, n / 2, n};
+    for (int s = 0; s < 3; s++) {
+        int last = 0, sorted = 1;
+        int c = pnode_sorted_count(snaps[s], &last, &sorted);
+        int hits = 0;
+        for (int i = 0; i < expect[s]; i++) hits += ptree_search(snaps[s], keys[i]) != NULL;
+        printf("Snapshot %d after churn: %d keys (expected %d), sorted=%s, all its keys found=%s\n", s, c,
+               expect[s], sorted ? "yes" : "no", hits == expect[s] ? "yes" : "no");
+    }
+    int last = 0, sorted = 1;
+    printf("Current version: %d keys (expected %d), sorted=%s\n", pnode_sorted_count(v, &last, &sorted),
+           n - n / 2 - 1, sorted ? "yes" : "no");
+
+    for (int s = 0; s < 3; s++) ptree_release(snaps[s]);
+    ptree_release(v);
+    printf("All versions released: live nodes=%ld\n", ptree_live_nodes());
+
+    int* sorted_keys = generate_sequence(n);
+    PNode* b = ptree_build_from_sorted(sorted_keys, n);
+    PNode* b2 = ptree_insert(b, n + 1);
+    printf("Built from sorted: height path to new max=%d, live=%ld\n", pnode_depth_of(b2, n + 1), ptree_live_nodes());
+    ptree_release(b);
+    ptree_release(b2);
+    printf("Released: live nodes=%ld\n", ptree_live_nodes());
+    free(sorted_keys);
+    free(keys);
+
+    printf("\n=== Persistent BST tests completed ===\n\n");
+}
+
+void test_tree_image() {
+    printf("=== Testing Memory-Mapped Tree Image ===\n");
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/bst_test_image_%d.bin", (int)getpid());
+    int n = 10000;
+    int* keys = generate_sequence(n);
+    fisher_yates(keys, n);
+    Tree* T = create_tree();
+    for (int i = 0; i < n; i++) {
+        tree_insert(T, create_node(2 * keys[i]));          // even keys, odd ones are misses
+    }
+    int rc = tree_image_write(T, path);
+    TreeImage* I = tree_image_open(path);
+    printf("Wrote %d-node image: rc=%d, opened=%s, %zu bytes (%zu per node)\n", n, rc, I ? "yes" : "no",
+           I ? I->bytes : 0, sizeof(ImgNode));
+
+    int found = 0, misses = 0, same_path = 1;
+    for (int k = 1; k <= 2 * n; k++) {
+        uint32_t x = image_search(I, k);
+        if (k % 2 == 0 && x != 0 && image_key(I, x) == k) found++;
+        if (k % 2 == 1 && x == 0) misses++;
+    }
+    for (int i = 0; i < 100; i++) {                          // same search path as the pointer tree
+        int k = 2 * keys[i];
+        int d_tree = 0, d_img = 0;
+        for (Node* y = T->root; y->key != k; y = (k < y->key) ? y->left : y->right) d_tree++;
+        for (uint32_t y = I->root; I->nodes[y].key != k; y = (k < I->nodes[y].key) ? I->nodes[y].left : I->nodes[y].right) d_img++;
+        if (d_tree != d_img) same_path = 0;
+    }
+    printf("On the mapping: present found=%d/%d, absent missed=%d/%d, same depths as the tree=%s\n", found, n,
+           misses, n, same_path ? "yes" : "no");
+    printf("os_select on a BST image=%u (refused)\n", image_os_select(I, 1));
+    tree_image_close(I);
+
+    truncate(path, sizeof(ImageHeader) + 100);               // cut short -> refused
+    I = tree_image_open(path);
+    printf("Truncated image opened=%s, missing file opened=%s\n", I ? "yes" : "no",
+           tree_image_open("/nonexistent/dir/image.bin") ? "yes" : "no");
+
+    Tree* E = create_tree();
+    tree_image_write(E, path);
+    I = tree_image_open(path);
+    printf("Empty tree image: opened=%s, n=%u, search=%u\n", I ? "yes" : "no", I ? I->n : 0, I ? image_search(I, 1) : 0);
+    tree_image_close(I);
+    free(E);
+
+    unlink(path);
+    destroy_tree(T->root);
+    free(T);
+    free(keys);
+
+    printf("\n=== Tree image tests completed ===\n\n");
+}
+
+void test_key_stream() {
+    printf("=== Testing Key File Streaming ===\n");
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/bst_test_keys_%d.bin", (int)getpid());
+    int n = 200000;                                           // several KEY_STREAM_CHUNKs
+    int* keys = generate_sequence(n);
+
+    key_file_write(path, keys, n, 4);
+    KeyStream* S = key_stream_open(path, 4);
+    int sorted = key_stream_is_sorted(S);
+    Tree* B = tree_build_from_stream(S);
+    Tree* ref = tree_build_from_sorted(keys, n);
+    printf("Sorted 32-bit file: count=%zu, sorted=%s, build == build_from_sorted=%s\n", S ? S->count : 0,
+           sorted ? "yes" : "no", (B && same_shape(B, ref)) ? "yes" : "no");
+    key_stream_close(S);
+    destroy_arena_tree(B);
+    destroy_arena_tree(ref);
+
+    fisher_yates(keys, n);
+    key_file_write(path, keys, n, 8);
+    S = key_stream_open(path, 8);
+    B = tree_build_from_stream(S);
+    key_stream_rewind(S);
+    Tree* T = create_arena_tree();
+    long inserted = tree_insert_stream(T, S);
+    int found = 0;
+    for (int i = 0; i < n; i++) found += tree_search(T->root, keys[i]) != NULL;
+    printf("Shuffled 64-bit file: build=%s, inserted=%ld, found=%d/%d, skipped=%zu\n", B ? "built" : "NULL (unsorted)",
+           inserted, found, n, S->skipped);
+    key_stream_close(S);
+    destroy_arena_tree(T);
+
+    // 64-bit keys outside int range are dropped, the rest still come out in order
+    int64_t wide[6] = {-5, (int64_t)INT_MAX + 1, 3, (int64_t)INT_MIN - 1, 7, INT_MAX};
+    FILE* f = fopen(path, "wb");
+    fwrite(wide, sizeof(int64_t), 6, f);
+    fclose(f);
+    S = key_stream_open(path, 8);
+    int k, out[6], m = 0;
+    while (key_stream_get(S, &k)) out[m++] = k;
+    printf("Out-of-range 64-bit keys: kept=%d (-5 3 7 INT_MAX: %s), skipped=%zu\n", m,
+           (m == 4 && out[0] == -5 && out[1] == 3 && out[2] == 7 && out[3] == INT_MAX) ? "yes" : "no", S->skipped);
+    key_stream_rewind(S);
+    B = tree_build_from_stream(S);
+    printf("Bulk load from it refused (a key was dropped): %s\n", B == NULL ? "yes" : "no");
+    key_stream_close(S);
+
+    truncate(path, 10);                                       // not a whole number of keys -> refused
+    printf("Ragged file opened=%s, missing file opened=%s\n", key_stream_open(path, 4) ? "yes" : "no",
+           key_stream_open("/nonexistent/dir/keys.bin", 4) ? "yes" : "no");
+
+    unlink(path);
+    free(keys);
+
+    printf("\n=== Key stream tests completed ===\n\n");
+}
+
 int main() {
     printf("Binary Search Tree Implementation Test\n");
     printf("======================================\n\n");
     
     test_basic_operations();
+    test_arena_tree();
+    test_deep_chain_and_cursor();
+    test_red_black_tree();
+    test_bulk_load();
+    test_compact_tree();
+    test_bplus_tree();
+    test_search_batch();
+    test_hinted_insert();
+    test_treap();
+    test_scapegoat();
+    test_splay_tree();
+    test_parallel_build();
+    test_fast_teardown();
+    test_concurrent_tree();
+    test_lockfree_bst();
+    test_persistent_tree();
+    test_tree_image();
+    test_key_stream();
     test_shuffle_methods();
     
     printf("\nAll tests completed successfully!\n");
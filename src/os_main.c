@@ -2,8 +2,42 @@
 #include <stdlib.h>
 #include <time.h>
 #include "../include/os_tree.h"
+#include "../include/os_rb_tree.h"
+#include "../include/frozen_tree.h"
+#include "../include/compact_tree.h"
+#include "../include/bplus_tree.h"
+#include "../include/splay_tree.h"
+#include "../include/persistent_tree.h"
+#include "../include/tree_image.h"
+#include "../include/aug_tree.h"
+#include "../include/fenwick_tree.h"
+#include "../include/sliding_window.h"
+#include <pthread.h>
+#include <unistd.h>
 #include "../include/utils.h"
 
+// Test 19: a report thread running quantile selects on a snapshot while
+// the main thread keeps updating the tree. The snapshot holds keys 2, 4, ...
+typedef struct {
+    OSPNode* snap;
+    int rounds;
+    int wrong;
+} QuantileReport;
+
+static void* quantile_report(void* arg) {
+    QuantileReport* q = (QuantileReport*)arg;
+    int n = os_ptree_size(q->snap);
+    for (int r = 0; r < q->rounds; r++) {
+        for (int pct = 1; pct <= 100; pct++) {
+            int i = (int)((long)pct * n / 100);
+            OSPNode* x = os_ptree_select(q->snap, i);
+            if (x == NULL || x->key != 2 * i || os_ptree_rank(q->snap, x->key) != i) q->wrong++;
+        }
+    }
+    os_ptree_release(q->snap);
+    return NULL;
+}
+
 int main(void) {
     srand(time(NULL));
 
@@ -110,6 +144,759 @@ int main(void) {
         printf("✗\n");
     }
 
+    printf("\n");
+
+    // Test 7: Arena-backed OS-tree keeps sizes the same way
+    printf("Test 7: Arena-backed OS-Tree\n");
+    OSTree* A = os_create_arena_tree();
+    for (int i = 0; i < n; i++) {
+        os_tree_insert(A, os_tree_alloc_node(A, keys[i]));
+    }
+    OSNode* gone = os_tree_search(A->root, 15);
+    os_tree_delete(A, gone);
+    os_tree_free_node(A, gone);
+    OSNode* again = os_tree_alloc_node(A, 14);
+    os_tree_insert(A, again);
+    OSNode* seventh = os_select(A->root, 7);
+    printf("Node memory reused: %s, root size=%d, OS-Select(7) = %d ",
+           again == gone ? "yes" : "no", A->root->size, seventh ? seventh->key : -1);
+    if (again == gone && A->root->size == n && seventh && seventh->key == 13) {
+        printf("✓\n");
+    } else {
+        printf("✗\n");
+    }
+    os_destroy_arena_tree(A);
+    printf("\n");
+
+    // Test 8: Cursor + stack safety on a degenerate 10^6 chain
+    printf("Test 8: Cursor and 10^6-deep chain\n");
+    OSTreeCursor c;
+    printf("Cursor backward: ");
+    for (OSNode* x = os_tree_cursor_last(&c, T); x != NULL; x = os_tree_cursor_prev(&c))
+        printf("%d ", x->key);
+    printf("\n");
+
+    int chain_n = 1000000;
+    OSTree* C = os_create_tree();
+    OSNode* last = NULL;
+    for (int i = 1; i <= chain_n; i++) {   // link sorted keys as a right chain
+        OSNode* z = os_create_node(i);
+        z->size = chain_n - i + 1;
+        if (last == NULL)
+            C->root = z;
+        else {
+            last->right = z;
+            z->p = last;
+        }
+        last = z;
+    }
+    int height = os_tree_height(C->root);
+    OSNode* mid = os_select(C->root, chain_n / 2);
+    os_inorder_tree_walk_silent(C->root);
+    printf("Height=%d, OS-Select(%d)=%d, OS-Rank(last)=%d ", height, chain_n / 2,
+           mid ? mid->key : -1, os_rank(C, last));
+    if (height == chain_n && mid && mid->key == chain_n / 2 && os_rank(C, last) == chain_n) {
+        printf("✓\n");
+    } else {
+        printf("✗\n");
+    }
+    os_destroy_tree(C->root);
+    free(C);
+
+    printf("\n");
+
+    // Test 9: Balanced OS-tree stays O(log n) high on sorted input
+    printf("Test 9: Red-black OS-Tree with sorted input\n");
+    int bal_n = 100000;
+    OSTree* B = os_create_tree();
+    for (int i = 1; i <= bal_n; i++) {
+        os_rb_tree_insert(B, os_create_node(i));
+    }
+    int ok = os_rb_validate(B) > 0 && os_tree_height(B->root) <= 34;
+    for (int i = 1; i <= bal_n; i += 997) {
+        OSNode* s = os_select(B->root, i);
+        if (s == NULL || s->key != i || os_rank(B, s) != i) ok = 0;
+    }
+    for (int i = 1; i <= bal_n; i += 2) {   // delete all odd keys
+        OSNode* d = os_tree_search(B->root, i);
+        os_rb_tree_delete(B, d);
+        free(d);
+    }
+    OSNode* s10 = os_select(B->root, 10);
+    if (os_rb_validate(B) <= 0 || B->root->size != bal_n / 2 || s10 == NULL || s10->key != 20) ok = 0;
+    printf("Height after inserts <= 2lg(n+1), sizes valid, select/rank agree after deletes ");
+    printf(ok ? "✓\n" : "✗\n");
+    os_destroy_tree(B->root);
+    free(B);
+
+    printf("\n");
+
+    // Test 10: Bulk load from sorted keys fills size in the same pass
+    printf("Test 10: OS-Tree bulk load from sorted keys\n");
+    int bulk_n = 1000000;
+    int* bulk_keys = generate_sequence(bulk_n);
+    OSTree* L = os_tree_build_from_sorted(bulk_keys, bulk_n);
+    ok = os_rb_validate(L) > 0 && os_tree_height(L->root) == 20 && L->root->size == bulk_n;
+    for (int i = 1; i <= bulk_n; i += 9973) {
+        OSNode* s = os_select(L->root, i);
+        if (s == NULL || s->key != i || os_rank(L, s) != i) ok = 0;
+    }
+    os_rb_tree_insert(L, os_tree_alloc_node(L, 0));
+    OSNode* first = os_select(L->root, 1);
+    if (first == NULL || first->key != 0 || os_rb_validate(L) <= 0) ok = 0;
+    printf("Height 20 for 10^6 keys, sizes valid, select/rank agree, rb insert afterwards ");
+    printf(ok ? "✓\n" : "✗\n");
+    os_destroy_arena_tree(L);
+    free(bulk_keys);
+
+    printf("\n");
+
+    // Test 11: Frozen (Eytzinger) snapshots agree with the pointer trees
+    printf("Test 11: Frozen snapshot search/rank/select\n");
+    ok = 1;
+    for (int m = 0; m <= 300; m += (m < 40) ? 1 : 37) {
+        int* fk = generate_sequence(m);
+        fisher_yates(fk, m);
+        OSTree* S = os_create_tree();
+        Tree* P = create_tree();
+        for (int i = 0; i < m; i++) {
+            os_tree_insert(S, os_create_node(2 * fk[i]));   // even keys only
+            tree_insert(P, create_node(2 * fk[i]));
+        }
+        FrozenTree* F = os_tree_freeze(S);
+        FrozenTree* G = tree_freeze(P);
+        for (int key = 0; key <= 2 * m + 1; key++) {
+            int present = (key % 2 == 0 && key >= 2);
+            if ((frozen_search(F, key) != 0) != present || (frozen_search(G, key) != 0) != present) ok = 0;
+            int below = (key > 0) ? (key - 1) / 2 : 0;   // even keys 2..key-1
+            if (frozen_rank(F, key) != below || frozen_rank(G, key) != below) ok = 0;
+        }
+        for (int i = 1; i <= m; i++) {
+            int slot = frozen_select(F, i);
+            if (slot == 0 || F->eyt[slot] != os_select(S->root, i)->key) ok = 0;
+        }
+        if (frozen_select(F, m + 1) != 0 || frozen_lower_bound(F, 2 * m + 1) != 0) ok = 0;
+        frozen_destroy(F);
+        frozen_destroy(G);
+        os_destroy_tree(S->root);
+        free(S);
+        destroy_tree(P->root);
+        free(P);
+        free(fk);
+    }
+    printf("Snapshots of 0..300 keys match os_select/os_rank/search ");
+    printf(ok ? "✓\n" : "✗\n");
+
+    printf("\n");
+
+    // Test 12: Compact 20-byte OS-tree gives the same answers as OSTree
+    printf("Test 12: Compact index-based OS-Tree (sizeof(COSNode)=%zu vs OSNode=%zu)\n",
+           sizeof(COSNode), sizeof(OSNode));
+    ok = 1;
+    int cn = 5000;
+    int* ck = generate_sequence(cn);
+    fisher_yates(ck, cn);
+    CompactOSTree* CT = cos_tree_create(16);
+    OSTree* PT = os_create_tree();
+    for (int i = 0; i < cn; i++) {
+        cos_tree_insert(CT, ck[i]);
+        os_tree_insert(PT, os_create_node(ck[i]));
+    }
+    for (int i = 0; i < cn; i += 3) {      // delete a third of the keys from both
+        cos_tree_delete(CT, cos_tree_search(CT, ck[i]));
+        OSNode* d = os_tree_search(PT->root, ck[i]);
+        os_tree_delete(PT, d);
+        free(d);
+    }
+    int remaining = PT->root->size;
+    if (CT->nodes[CT->root].size != remaining) ok = 0;
+    for (int i = 1; i <= remaining; i++) {
+        uint32_t c = cos_select(CT, i);
+        if (c == CNIL || CT->nodes[c].key != os_select(PT->root, i)->key || cos_rank(CT, c) != i) ok = 0;
+    }
+    printf("Same select/rank as the pointer OS-Tree after inserts + deletes ");
+    printf(ok ? "✓\n" : "✗\n");
+    cos_tree_destroy(CT);
+    os_destroy_tree(PT->root);
+    free(PT);
+    free(ck);
+
+    printf("\n");
+
+    // Test 13: Counted B+-tree select/rank against the OS-tree
+    printf("Test 13: B+-Tree select/rank (counted and uncounted)\n");
+    ok = 1;
+    int bn = 100000;
+    int* bk = generate_sequence(bn);
+    fisher_yates(bk, bn);
+    for (int counted = 0; counted <= 1; counted++) {
+        BPlusTree* B = bpt_create(counted);
+        OSTree* O = os_create_tree();
+        for (int i = 0; i < bn; i++) {
+            bpt_insert(B, 2 * bk[i]);              // even keys, so odd ones are "between"
+            os_tree_insert(O, os_create_node(2 * bk[i]));
+        }
+        for (int i = 0; i < bn; i += 4) {
+            bpt_delete(B, 2 * bk[i]);
+            OSNode* d = os_tree_search(O->root, 2 * bk[i]);
+            os_tree_delete(O, d);
+            free(d);
+        }
+        if (bpt_validate(B) < 0 || B->n != O->root->size) ok = 0;
+        for (int i = 1; i <= B->n; i += (counted ? 1 : 997)) {
+            OSNode* s = os_select(O->root, i);
+            BPlusPos b = bpt_select(B, i);
+            if (b.leaf == NULL || bpt_key(b) != s->key || bpt_rank(B, s->key) != os_rank(O, s) ||
+                bpt_rank(B, s->key + 1) != i + 1) ok = 0;
+        }
+        bpt_destroy(B);
+        os_destroy_tree(O->root);
+        free(O);
+    }
+    printf("Same select/rank as the OS-Tree after %d inserts + %d deletes ", bn, bn / 4);
+    printf(ok ? "✓\n" : "✗\n");
+    free(bk);
+
+    printf("\n");
+
+    // Test 14: Batched select gives the same nodes as one os_select per rank
+    printf("Test 14: Batched OS-SELECT\n");
+    ok = 1;
+    int sn = 50000;
+    int* sk = generate_sequence(sn);
+    fisher_yates(sk, sn);
+    OSTree* ST = os_create_tree();
+    for (int i = 0; i < sn; i++) {
+        os_tree_insert(ST, os_create_node(sk[i]));
+    }
+    int sm = sn + 7;
+    int* ranks = (int*)malloc(sm * sizeof(int));
+    OSNode** sel = (OSNode**)malloc(sm * sizeof(OSNode*));
+    for (int j = 0; j < sm; j++) {
+        ranks[j] = (j * 7919) % (sn + 2);            // 0 and n+1 are out of range
+    }
+    os_select_batch(ST, ranks, sm, sel);
+    for (int j = 0; j < sm; j++) {
+        if (sel[j] != os_select(ST->root, ranks[j])) ok = 0;
+    }
+    printf("%d batched selects (incl. out-of-range ranks) match os_select ", sm);
+    printf(ok ? "✓\n" : "✗\n");
+    free(ranks);
+    free(sel);
+    os_destroy_tree(ST->root);
+    free(ST);
+    free(sk);
+
+    printf("\n");
+
+    // Test 15: Hinted insert keeps every size right
+    printf("Test 15: Hinted OS-Tree insert\n");
+    ok = 1;
+    int hn = 100000;
+    int* hk = generate_sequence(hn);
+    for (int i = 0; i < hn; i++) {
+        hk[i] *= 2;                                   // 2, 4, .., 2n
+    }
+    OSTree* H = os_tree_build_from_sorted(hk, hn);
+    for (int i = 0; i < hn; i++) {                    // 2k+1 goes right after 2k
+        os_tree_insert_hint(H, os_tree_search(H->root, hk[i]), os_tree_alloc_node(H, hk[i] + 1));
+    }
+    os_tree_insert_hint(H, H->root, os_tree_alloc_node(H, 1));   // not a neighbour -> root insert
+    if (H->root->size != 2 * hn + 1) ok = 0;
+    for (int i = 1; i <= 2 * hn + 1; i++) {
+        OSNode* s = os_select(H->root, i);
+        if (s == NULL || s->key != i || os_rank(H, s) != i) ok = 0;
+    }
+    os_destroy_arena_tree(H);
+    free(hk);
+
+    OSTree* stream = os_create_arena_tree();           // sorted stream, previous insert as hint
+    OSNode* prev = NULL;
+    for (int i = 1; i <= 20000; i++) {
+        OSNode* z = os_tree_alloc_node(stream, i);
+        os_tree_insert_hint(stream, prev, z);
+        prev = z;
+    }
+    for (int i = 1; i <= 20000; i += 7) {
+        if (os_select(stream->root, i)->key != i) ok = 0;
+    }
+    os_destroy_arena_tree(stream);
+
+    OSTree* near = os_create_arena_tree();            // nearly sorted, the hint is often not a neighbour
+    int near_keys[] = {120, 90, 100, 150};
+    prev = NULL;
+    for (int i = 0; i < 4; i++) {
+        OSNode* z = os_tree_alloc_node(near, near_keys[i]);
+        os_tree_insert_hint(near, prev, z);
+        prev = z;
+    }
+    if (os_select(near->root, 4)->key != 150 || os_tree_search(near->root, 150) == NULL) ok = 0;
+    for (int i = 0; i < 20000; i++) {
+        OSNode* z = os_tree_alloc_node(near, 200 + 10 * i + rand() % 25);
+        os_tree_insert_hint(near, prev, z);
+        prev = z;
+    }
+    for (int i = 1; i <= near->root->size; i++) {
+        OSNode* s = os_select(near->root, i);
+        if (s == NULL || os_rank(near, s) != i) ok = 0;
+        if (i > 1 && os_select(near->root, i - 1)->key > s->key) ok = 0;
+        if (os_tree_search(near->root, s->key) == NULL) ok = 0;
+    }
+    if (near->root->size != 20004) ok = 0;
+    os_destroy_arena_tree(near);
+    printf("Odd keys hinted into a tree of even keys + sorted and nearly sorted streams: select/rank exact ");
+    printf(ok ? "✓\n" : "✗\n");
+
+    // Test 16: Splay OS-tree, sizes survive every rotation
+    printf("Test 16: Splay OS-Tree\n");
+    ok = 1;
+    int spl_n = 50000;
+    int* spl_keys = generate_sequence(spl_n);
+    fisher_yates(spl_keys, spl_n);
+    OSTree* SP = os_create_arena_tree();
+    for (int i = 0; i < spl_n; i++) {
+        os_splay_tree_insert(SP, os_tree_alloc_node(SP, 2 * spl_keys[i]));   // 2, 4, .., 2n
+        if (SP->root->key != 2 * spl_keys[i]) ok = 0;
+    }
+    for (int i = 0; i < spl_n; i += 3) {                   // search, select, rank all splay
+        OSNode* s = os_splay_tree_search(SP, 2 * spl_keys[i]);
+        if (s == NULL || SP->root != s) ok = 0;
+        s = os_splay_select(SP, spl_keys[i]);
+        if (s == NULL || s->key != 2 * spl_keys[i] || SP->root != s) ok = 0;
+        if (os_splay_rank(SP, os_tree_search(SP->root, 2 * spl_keys[i])) != spl_keys[i]) ok = 0;
+        if (os_splay_tree_search(SP, 2 * spl_keys[i] + 1) != NULL) ok = 0;
+    }
+    for (int i = 0; i < spl_n; i++) {                      // drop multiples of 4
+        if (spl_keys[i] % 2 == 0) {
+            OSNode* z = os_tree_search(SP->root, 2 * spl_keys[i]);
+            os_splay_tree_delete(SP, z);
+            os_tree_free_node(SP, z);
+        }
+    }
+    if (os_get_size(SP->root) != (spl_n + 1) / 2) ok = 0;
+    int spl_i = 0;
+    for (OSNode* x = os_tree_min(SP->root); x != NULL; x = os_tree_successor(x)) {
+        spl_i++;
+        if (x->size != os_get_size(x->left) + os_get_size(x->right) + 1) ok = 0;
+        if (x->key != 4 * spl_i - 2 || os_select(SP->root, spl_i) != x || os_rank(SP, x) != spl_i) ok = 0;
+    }
+    if (spl_i != (spl_n + 1) / 2) ok = 0;
+    os_destroy_arena_tree(SP);
+    free(spl_keys);
+    printf("Random inserts, search/select/rank splaying, deletes: sizes and ranks exact ");
+    printf(ok ? "✓\n" : "✗\n");
+
+    // Test 17: Parallel bulk load, sizes right whatever the thread count
+    printf("Test 17: Parallel OS-Tree build\n");
+    ok = 1;
+    int par_n = 300007;
+    int par_threads[] = {1, 2, 4, 7};
+    for (int t = 0; t < 4; t++) {
+        int* pk = generate_sequence(par_n);
+        fisher_yates(pk, par_n);
+        OSTree* PB = os_tree_build_parallel(pk, par_n, par_threads[t]);
+        if (os_get_size(PB->root) != par_n || os_rb_validate(PB) <= 0) ok = 0;
+        for (int i = 1; i <= par_n; i += 101) {
+            OSNode* s = os_select(PB->root, i);
+            if (s == NULL || s->key != i || os_rank(PB, s) != i) ok = 0;
+        }
+        os_destroy_arena_tree(PB);
+        free(pk);
+    }
+    printf("%d shuffled keys on 1/2/4/7 threads: select/rank exact, red-black valid ", par_n);
+    printf(ok ? "✓\n" : "✗\n");
+
+    // Test 18: Fast teardown, every node freed exactly once
+    printf("Test 18: Parallel OS-Tree teardown\n");
+    ok = 1;
+    for (int t = 1; t <= 8; t *= 2) {
+        int* tk = generate_sequence(100000);
+        fisher_yates(tk, 100000);
+        OSTree* TD = os_create_tree();
+        for (int i = 0; i < 100000; i++) {
+            os_tree_insert(TD, os_create_node(tk[i]));
+        }
+        if (os_destroy_tree_parallel(TD->root, t) != 100000) ok = 0;
+        free(TD);
+        free(tk);
+    }
+    if (os_destroy_tree_parallel(NULL, 4) != 0) ok = 0;
+    printf("100000-node trees freed on 1/2/4/8 threads ");
+    printf(ok ? "✓\n" : "✗\n");
+
+    // Test 19: Persistent OS-Tree snapshots
+    printf("\nTest 19: Persistent OS-Tree, quantiles on a snapshot during updates\n");
+    {
+        int pn = 20000;
+        int* pk = (int*)malloc(pn * sizeof(int));
+        for (int i = 0; i < pn; i++) {
+            pk[i] = 2 * (i + 1);
+        }
+        OSPNode* pv = os_ptree_build_from_sorted(pk, pn);
+        QuantileReport rep = {os_ptree_retain(pv), 200, 0};
+        pthread_t rt;
+        pthread_create(&rt, NULL, quantile_report, &rep);
+        for (int i = 0; i < pn; i++) {                 // odd keys in, every 4th even key out
+            OSPNode* nv = os_ptree_insert(pv, 2 * i + 1);
+            os_ptree_release(pv);
+            pv = nv;
+            if (i % 4 == 0) {
+                nv = os_ptree_delete(pv, pk[i]);
+                os_ptree_release(pv);
+                pv = nv;
+            }
+        }
+        pthread_join(rt, NULL);
+        printf("Report thread: %d wrong selects/ranks on the snapshot %s\n", rep.wrong, rep.wrong == 0 ? "✓" : "✗");
+
+        int want = 2 * pn - pn / 4;
+        int ok = (os_ptree_size(pv) == want);
+        int prev = 0;
+        for (int i = 1; i <= want && ok; i++) {
+            OSPNode* x = os_ptree_select(pv, i);
+            if (x->key <= prev || os_ptree_rank(pv, x->key) != i) ok = 0;
+            prev = x->key;
+        }
+        printf("Current version: size=%d (expected %d), select/rank consistent %s\n", os_ptree_size(pv), want,
+               ok ? "✓" : "✗");
+        os_ptree_release(pv);
+        printf("All versions released, live nodes=%ld %s\n", os_ptree_live_nodes(),
+               os_ptree_live_nodes() == 0 ? "✓" : "✗");
+        free(pk);
+    }
+
+    // Test 20: OS-Tree image, select/rank straight on the mapping
+    printf("\nTest 20: Memory-mapped OS-Tree image\n");
+    {
+        char ipath[64];
+        snprintf(ipath, sizeof(ipath), "/tmp/os_test_image_%d.bin", (int)getpid());
+        int in = 20000;
+        int* ik = generate_sequence(in);
+        fisher_yates(ik, in);
+        OSTree* IT = os_create_tree();
+        for (int i = 0; i < in; i++) {
+            os_tree_insert(IT, os_create_node(ik[i] % 5000));   // duplicates too
+        }
+        int rc = os_tree_image_write(IT, ipath);
+        TreeImage* OI = tree_image_open(ipath);
+        printf("Image written rc=%d, opened %s, kind OS %s, n=%u\n", rc, OI ? "✓" : "✗",
+               (OI && OI->kind == IMAGE_OS) ? "✓" : "✗", OI ? OI->n : 0);
+        int sel_ok = 1, rank_ok = 1;
+        for (int i = 1; i <= in && OI; i++) {
+            uint32_t x = image_os_select(OI, i);
+            if (x == 0 || image_key(OI, x) != os_select(IT->root, i)->key) sel_ok = 0;
+        }
+        for (int k = 0; k < 5000 && OI; k++) {
+            OSNode* y = os_tree_search(IT->root, k);
+            while (os_tree_predecessor(y) != NULL && os_tree_predecessor(y)->key == k) y = os_tree_predecessor(y);
+            if (image_os_rank(OI, k) != os_rank(IT, y)) rank_ok = 0;
+        }
+        printf("image_os_select matches os_select for all %d ranks %s\n", in, sel_ok ? "✓" : "✗");
+        printf("image_os_rank matches os_rank of each key's first node %s\n", rank_ok ? "✓" : "✗");
+        printf("Out of range: select(0)=%u select(n+1)=%u, absent key rank=%d %s\n", image_os_select(OI, 0),
+               image_os_select(OI, in + 1), image_os_rank(OI, -5),
+               (image_os_select(OI, 0) == 0 && image_os_select(OI, in + 1) == 0 && image_os_rank(OI, -5) == 0) ? "✓" : "✗");
+        tree_image_close(OI);
+        unlink(ipath);
+        os_destroy_tree(IT->root);
+        free(IT);
+        free(ik);
+    }
+
+    // Test 21: Rank by key and range counts, checked against a sorted array
+    printf("\nTest 21: os_rank_of_key / os_count_range\n");
+    {
+        int kn = 5000;
+        int* kk = (int*)malloc(kn * sizeof(int));
+        OSTree* KT = os_create_arena_tree();
+        OSTree* KR = os_create_arena_tree();
+        for (int i = 0; i < kn; i++) {
+            kk[i] = 2 * (rand() % 2000);                    // even keys with duplicates, odd ones absent
+            os_tree_insert(KT, os_tree_alloc_node(KT, kk[i]));
+            os_rb_tree_insert(KR, os_tree_alloc_node(KR, kk[i]));
+        }
+        int* sorted = (int*)malloc(kn * sizeof(int));
+        for (int i = 1; i <= kn; i++) sorted[i - 1] = os_select(KT->root, i)->key;
+        int rank_ok = 1, range_ok = 1;
+        OSTree* both[2] = {KT, KR};
+        for (int t = 0; t < 2; t++) {
+            for (int k = -3; k <= 4003; k++) {
+                int below = 0, upto = 0;
+                while (below < kn && sorted[below] < k) below++;
+                upto = below;
+                while (upto < kn && sorted[upto] == k) upto++;
+                if (os_rank_of_key(both[t], k) != below + 1 || os_rank_of_key_upper(both[t], k) != upto) rank_ok = 0;
+            }
+            for (int q = 0; q < 2000; q++) {
+                int lo = rand() % 4010 - 5, hi = lo + rand() % 600 - 100;   // some with hi < lo
+                int want = 0;
+                for (int i = 0; i < kn; i++) want += (sorted[i] >= lo && sorted[i] <= hi);
+                if (os_count_range(both[t], lo, hi) != want) range_ok = 0;
+            }
+        }
+        int first_ok = 1;                                   // present key: same as os_rank of its first node
+        for (int k = 0; k < 4000; k += 2) {
+            OSNode* y = os_tree_search(KT->root, k);
+            if (y == NULL) continue;
+            while (os_tree_predecessor(y) != NULL && os_tree_predecessor(y)->key == k) y = os_tree_predecessor(y);
+            if (os_rank_of_key(KT, k) != os_rank(KT, y)) first_ok = 0;
+        }
+        printf("Lower/upper rank of every key in -3..4003 (present, absent, duplicated), plain and red-black %s\n",
+               rank_ok ? "✓" : "✗");
+        printf("Lower rank of a present key = os_rank of its first node %s\n", first_ok ? "✓" : "✗");
+        printf("2000 random [lo, hi] counts (empty and reversed ranges too) %s\n", range_ok ? "✓" : "✗");
+        OSTree* E = os_create_tree();
+        printf("Empty tree: rank_of_key=%d upper=%d count_range=%d %s\n", os_rank_of_key(E, 1), os_rank_of_key_upper(E, 1),
+               os_count_range(E, 0, 10),
+               (os_rank_of_key(E, 1) == 1 && os_rank_of_key_upper(E, 1) == 0 && os_count_range(E, 0, 10) == 0) ? "✓" : "✗");
+        free(E);
+        os_destroy_arena_tree(KT);
+        os_destroy_arena_tree(KR);
+        free(sorted);
+        free(kk);
+    }
+
+    // Test 22: Multi-select in one descent against one os_select per rank
+    printf("\nTest 22: os_select_many\n");
+    {
+        int mn = 4000;
+        OSTree* MT = os_create_arena_tree();
+        OSTree* MC = os_create_arena_tree();                 // sorted inserts: a 4000-deep chain
+        int* mk = generate_sequence(mn);
+        fisher_yates(mk, mn);
+        for (int i = 0; i < mn; i++) {
+            os_tree_insert(MT, os_tree_alloc_node(MT, mk[i] % 1000));   // duplicate keys
+            os_tree_insert(MC, os_tree_alloc_node(MC, i));
+        }
+        int* mr = (int*)malloc((mn + 2) * sizeof(int));
+        OSNode** mo = (OSNode**)malloc((mn + 2) * sizeof(OSNode*));
+        int many_ok = 1;
+        OSTree* both[2] = {MT, MC};
+        int sizes[] = {1, 2, 7, 100, 999, mn + 2};
+        for (int t = 0; t < 2; t++) {
+            for (int si = 0; si < 6; si++) {
+                int m = sizes[si];
+                for (int j = 0; j < m; j++) mr[j] = rand() % (mn + 2);      // 0 and n+1 are out of range
+                if (m == mn + 2) for (int j = 0; j < m; j++) mr[j] = j;     // every rank once
+                parallel_sort(mr, m, 1);
+                os_select_many(both[t]->root, mr, m, mo);
+                for (int j = 0; j < m; j++) {
+                    if (mo[j] != os_select(both[t]->root, mr[j])) many_ok = 0;
+                }
+            }
+        }
+        os_select_many(MT->root, mr, 0, mo);
+        printf("Sorted rank sets of 1..%d (repeats, 0 and n+1 included), random tree and %d-deep chain %s\n", mn + 2, mn,
+               many_ok ? "✓" : "✗");
+        OSTree* E = os_create_tree();
+        mr[0] = 1;
+        os_select_many(E->root, mr, 1, mo);
+        printf("Empty tree gives NULL %s\n", mo[0] == NULL ? "✓" : "✗");
+        free(E);
+        os_destroy_arena_tree(MT);
+        os_destroy_arena_tree(MC);
+        free(mk);
+        free(mr);
+        free(mo);
+    }
+
+    // Test 23: Augmentation template, weighted tree against brute force
+    printf("\nTest 23: Augmented tree (count, sum, min, max of value)\n");
+    {
+        int an = 3000;
+        AugTree* AT = aug_tree_create();
+        AugNode** an_nodes = (AugNode**)malloc(an * sizeof(AugNode*));
+        int live = 0, valid = 1;
+        for (int step = 0; step < 4 * an; step++) {     // inserts, deletes and value updates mixed
+            int op = rand() % 4;
+            if (live < an && (op < 2 || live == 0)) {
+                an_nodes[live++] = aug_tree_insert(AT, rand() % 1000, rand() % 5000);
+            }
+            else if (op == 2) {
+                int j = rand() % live;
+                aug_tree_delete(AT, an_nodes[j]);
+                an_nodes[j] = an_nodes[--live];
+            }
+            else {
+                aug_tree_set_value(AT, an_nodes[rand() % live], rand() % 5000);
+            }
+            if (step % 97 == 0 && !aug_tree_validate(AT)) valid = 0;
+        }
+        printf("%d mixed operations, colours and all four aggregates valid %s\n", 4 * an, (valid && aug_tree_validate(AT)) ? "✓" : "✗");
+
+        // in key order: select must walk it, weighted select must land where the prefix sum crosses w
+        AugNode** order = (AugNode**)malloc((live > 0 ? live : 1) * sizeof(AugNode*));
+        int sel_ok = (aug_select(AT, 0) == NULL && aug_select(AT, live + 1) == NULL);
+        for (int i = 1; i <= live; i++) {
+            order[i - 1] = aug_select(AT, i);
+            if (order[i - 1] == NULL || (i > 1 && order[i - 2]->key > order[i - 1]->key)) sel_ok = 0;
+        }
+        long long total = 0;
+        int weight_ok = 1;
+        for (int i = 0; i < live; i++) {
+            long long before = total;
+            total += order[i]->value;
+            if (order[i]->value > 0 && (aug_select_weight(AT, before + 1) != order[i] || aug_select_weight(AT, total) != order[i]))
+                weight_ok = 0;
+        }
+        weight_ok &= (total == aug_total(AT) && aug_select_weight(AT, total + 1) == NULL && aug_select_weight(AT, 0) == NULL);
+        AugNode* p95 = aug_select_weight(AT, (total * 95 + 99) / 100);
+        printf("aug_select in key order %s, weighted select at every prefix-sum boundary %s (p95 of %lld -> key %d)\n",
+               sel_ok ? "✓" : "✗", weight_ok ? "✓" : "✗", total, p95 ? p95->key : -1);
+
+        int range_ok = 1;
+        for (int q = 0; q < 1000; q++) {
+            int lo = rand() % 1010 - 5, hi = lo + rand() % 300 - 20;
+            AugNode want = {0}, got = {0};
+            int any = 0;
+            for (int i = 0; i < live; i++) {
+                AugNode* x = order[i];
+                if (x->key < lo || x->key > hi) continue;
+                if (!any) { want.vmin = want.vmax = x->value; }
+                want.size++;
+                want.sum += x->value;
+                if (x->value < want.vmin) want.vmin = x->value;
+                if (x->value > want.vmax) want.vmax = x->value;
+                any = 1;
+            }
+            int r = aug_tree_range(AT, lo, hi, &got);
+            if (r != any || (any && (got.size != want.size || got.sum != want.sum || got.vmin != want.vmin || got.vmax != want.vmax)))
+                range_ok = 0;
+        }
+        printf("1000 range folds (count/sum/min/max) match a scan %s\n", range_ok ? "✓" : "✗");
+        free(order);
+        free(an_nodes);
+        aug_tree_destroy(AT);
+
+        // os_tree_delete now fixes sizes from the spliced spot up, duplicates included
+        OSTree* DT = os_create_arena_tree();
+        OSNode* dn[2000];
+        for (int i = 0; i < 2000; i++) {
+            dn[i] = os_tree_alloc_node(DT, rand() % 50);
+            os_tree_insert(DT, dn[i]);
+        }
+        int dup_ok = 1;
+        for (int i = 0; i < 2000; i += 2) {
+            os_tree_delete(DT, dn[i]);
+            if (DT->root->size != 2000 - i / 2 - 1) dup_ok = 0;
+        }
+        for (OSNode* x = os_tree_min(DT->root); x != NULL; x = os_tree_successor(x)) {
+            if (x->size != os_get_size(x->left) + os_get_size(x->right) + 1) dup_ok = 0;
+        }
+        printf("Plain OS-tree deletes among 50 distinct keys keep every size right %s\n", dup_ok ? "✓" : "✗");
+        os_destroy_arena_tree(DT);
+    }
+
+    // Test 24: Fenwick engine against the red-black OS-tree, same operations
+    printf("\nTest 24: Fenwick rank/select and the auto-picking order index\n");
+    {
+        int flo = -300, fhi = 1700;                         // odd universe size, negative keys
+        FenwickTree* F = fen_create(flo, fhi);
+        OSTree* FT = os_create_arena_tree();
+        int agree = 1;
+        for (int step = 0; step < 20000; step++) {
+            int k = flo - 5 + rand() % (fhi - flo + 11);    // a few out of range
+            if (rand() % 3 != 0) {
+                int in = fen_insert(F, k);
+                if (in) os_rb_tree_insert(FT, os_tree_alloc_node(FT, k));
+                if (in != (k >= flo && k <= fhi)) agree = 0;
+            }
+            else {
+                OSNode* z = os_tree_search(FT->root, k);
+                if (fen_delete(F, k) != (z != NULL)) agree = 0;
+                if (z != NULL) {
+                    os_rb_tree_delete(FT, z);
+                    os_tree_free_node(FT, z);
+                }
+            }
+        }
+        int n_now = os_get_size(FT->root);
+        for (int i = 0; i <= n_now + 1; i++) {
+            int key = 0;
+            OSNode* x = os_select(FT->root, i);
+            if (fen_select(F, i, &key) != (x != NULL) || (x != NULL && key != x->key)) agree = 0;
+        }
+        for (int k = flo - 3; k <= fhi + 3; k++) {
+            if (fen_rank(F, k) != os_rank_of_key(FT, k) || fen_count(F, k) != os_count_range(FT, k, k) ||
+                fen_count_range(F, k, k + 37) != os_count_range(FT, k, k + 37)) agree = 0;
+        }
+        printf("20000 mixed inserts/deletes (duplicates, out of range): select, rank, count, ranges match the OS-tree %s\n",
+               (agree && F->count == n_now) ? "✓" : "✗");
+
+        int* all = (int*)malloc(n_now * sizeof(int));
+        for (int i = 1; i <= n_now; i++) all[i - 1] = os_select(FT->root, i)->key;
+        fisher_yates(all, n_now);
+        FenwickTree* FB = fen_build(flo, fhi, all, n_now);
+        int same = (FB->count == F->count);
+        for (int j = 1; j <= F->universe; j++) same &= (FB->bit[j] == F->bit[j]);
+        printf("fen_build from the same keys gives the same array %s\n", same ? "✓" : "✗");
+        free(all);
+        fen_destroy(FB);
+        fen_destroy(F);
+        os_destroy_arena_tree(FT);
+
+        OrderIndex* dense = order_index_create(1, 100000, 100000);
+        OrderIndex* sparse = order_index_create(0, 2000000000, 100000);
+        int idx_ok = 1;
+        for (int i = 0; i < 1000; i++) {
+            int k = 1 + rand() % 100000;
+            order_index_insert(dense, k);
+            order_index_insert(sparse, k * 20000);
+        }
+        for (int i = 1; i <= 1000; i++) {
+            int a, b;
+            if (!order_index_select(dense, i, &a) || !order_index_select(sparse, i, &b) || b != a * 20000) idx_ok = 0;
+            if (order_index_rank(dense, a) != order_index_rank(sparse, b)) idx_ok = 0;
+        }
+        order_index_delete(dense, 1 + rand() % 100000);
+        printf("Dense range -> %s, sparse range -> %s, same answers %s\n",
+               dense->kind == ORDER_INDEX_FENWICK ? "Fenwick" : "tree", sparse->kind == ORDER_INDEX_FENWICK ? "Fenwick" : "tree",
+               (idx_ok && dense->kind == ORDER_INDEX_FENWICK && sparse->kind == ORDER_INDEX_TREE &&
+                order_index_size(sparse) == 1000 && order_index_count_range(sparse, 0, 2000000000) == 1000) ? "✓" : "✗");
+        order_index_destroy(dense);
+        order_index_destroy(sparse);
+    }
+
+    // Test 25: Sliding window quantiles against the last w samples, sorted by hand
+    printf("\nTest 25: Sliding-window quantiles\n");
+    {
+        int ws[3] = {1, 7, 100};
+        int pushes = 3000;
+        int* hist = (int*)malloc(pushes * sizeof(int));
+        int* last = (int*)malloc(100 * sizeof(int));
+        int win_ok = 1;
+        for (int t = 0; t < 3; t++) {
+            int w = ws[t];
+            SlidingWindow* W = window_create(w);
+            int v;
+            if (window_quantile(W, 0.5, &v) != 0) win_ok = 0;
+            for (int i = 0; i < pushes; i++) {
+                hist[i] = (i < pushes / 2) ? rand() % 50 : i;   // duplicates, then a rising series
+                window_push(W, hist[i]);
+                int c = (i + 1 < w) ? i + 1 : w;
+                for (int j = 0; j < c; j++) {                    // insertion sort of the last c samples
+                    int k = hist[i - j], m = j;
+                    while (m > 0 && last[m - 1] > k) { last[m] = last[m - 1]; m--; }
+                    last[m] = k;
+                }
+                if (W->count != c) win_ok = 0;
+                int r = 1 + rand() % c;
+                if (!window_select(W, r, &v) || v != last[r - 1]) win_ok = 0;
+                if (!window_quantile(W, 0.5, &v) || v != last[(c + 1) / 2 - 1]) win_ok = 0;
+                if (!window_quantile(W, 0.0, &v) || v != last[0]) win_ok = 0;
+                if (!window_quantile(W, 1.0, &v) || v != last[c - 1]) win_ok = 0;
+                if (i % 250 == 0 && os_rb_validate(W->T) < 0) win_ok = 0;
+            }
+            if (os_rb_validate(W->T) < 0 || window_select(W, w + 1, &v) != 0) win_ok = 0;
+            window_destroy(W);
+        }
+        printf("w = 1, 7, 100 over %d pushes (random with repeats, then rising): select/median/min/max %s\n", pushes,
+               win_ok ? "✓" : "✗");
+        printf("window_create(0) refused %s\n", window_create(0) == NULL ? "✓" : "✗");
+        free(hist);
+        free(last);
+    }
+
     printf("\n");
     printf("All tests completed!\n");
 
@@ -0,0 +1,60 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/os_rb_tree.h"
+#include "../include/os_aug.h"
+
+static int is_red(OSNode* x){
+    return x != NULL && x->color == OS_RB_RED;
+}
+
+// Rotations, fixups and the size bookkeeping all come from augment.h
+// (os_aug.h instance); these are the public names for them
+
+//LEFT-ROTATE + the two size lines from CLRS 14.1
+void os_rb_left_rotate(OSTree* T, OSNode* x){
+    os_aug_left_rotate(T, x);
+}
+
+void os_rb_right_rotate(OSTree* T, OSNode* x){
+    os_aug_right_rotate(T, x);
+}
+
+// size++ on the way down, then the CLRS fixup
+void os_rb_tree_insert(OSTree* T, OSNode* z){
+    os_tree_forget_ends(T);
+    os_aug_rb_insert(T, z);
+}
+
+// size-- above the spliced spot before the fixup rotates anything
+void os_rb_tree_delete(OSTree* T, OSNode* z){
+    os_tree_forget_ends(T);
+    os_aug_rb_delete(T, z);
+}
+
+// Colour rules as in rb_validate plus size == size(left) + size(right) + 1 everywhere
+int os_rb_validate(OSTree* T){
+    if (T->root == NULL)
+        return 0;
+    if (is_red(T->root))
+        return -1;
+
+    int black_height = -1;
+    for (OSNode* x = os_tree_min(T->root); x != NULL; x = os_tree_successor(x)){
+        if (!os_aug_consistent(x))
+            return -1;
+        if (is_red(x) && is_red(x->p))
+            return -1;
+        if (x->left == NULL || x->right == NULL){
+            int blacks = 0;
+            for (OSNode* y = x; y != NULL; y = y->p){
+                if (!is_red(y))
+                    blacks++;
+            }
+            if (black_height == -1)
+                black_height = blacks;
+            else if (blacks != black_height)
+                return -1;
+        }
+    }
+    return black_height;
+}
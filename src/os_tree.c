@@ -1,11 +1,22 @@
 #include "stdio.h"
 #include "stdlib.h"
+#include "assert.h"
+#include "string.h"
+#include "limits.h"
 #include "../include/os_tree.h"
+#include "../include/os_aug.h"
+#include "../include/arena.h"
+#include "../include/utils.h"
+#include "../include/key_stream.h"
+
+#define NODES_PER_FIRST_SLAB 1024
+#define BATCH_IN_FLIGHT 16    // selects kept in flight by os_select_batch
 
 OSNode* os_create_node(int key){
     OSNode* z = (OSNode*)malloc(sizeof(OSNode));
     z->key = key;
     z->size = 1;
+    z->color = 0;
     z->left = NULL;
     z->right = NULL;
     z->p = NULL;
@@ -16,9 +27,234 @@ OSNode* os_create_node(int key){
 OSTree* os_create_tree(void){
     OSTree* T = (OSTree*)malloc(sizeof(OSTree));
     T->root = NULL;
+    T->arena = NULL;
+    os_tree_forget_ends(T);
+    return T;
+}
+
+//OS tree with its own node arena
+OSTree* os_create_arena_tree(void){
+    OSTree* T = os_create_tree();
+    T->arena = arena_create(sizeof(OSNode), NODES_PER_FIRST_SLAB);
+    return T;
+}
+
+//os_create_node but from the tree's arena
+OSNode* os_tree_alloc_node(OSTree* T, int key){
+    if (T->arena == NULL){
+        return os_create_node(key);
+    }
+    OSNode* z = (OSNode*)arena_alloc(T->arena);
+    z->key = key;
+    z->size = 1;
+    z->color = 0;
+    z->left = NULL;
+    z->right = NULL;
+    z->p = NULL;
+    return z;
+}
+
+//middle key is the root of each range -> minimum height. size comes back up
+//from the children so the whole thing is one pass; deepest level red so the
+//result is also a valid tree for os_rb_tree_insert/delete
+static OSNode* os_build_range(OSNode* nodes, int* keys, int lo, int hi, OSNode* parent, int depth, int red_depth){
+    if (lo > hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    OSNode* x = &nodes[mid];
+    x->key = keys[mid];
+    x->size = hi - lo + 1;
+    x->color = (depth == red_depth) ? 0 : 1;
+    x->p = parent;
+    x->left = os_build_range(nodes, keys, lo, mid - 1, x, depth + 1, red_depth);
+    x->right = os_build_range(nodes, keys, mid + 1, hi, x, depth + 1, red_depth);
+    return x;
+}
+
+//O(n) bulk load from sorted keys, nodes + sizes set in one pass, one memory block
+OSTree* os_tree_build_from_sorted(int* keys, int n){
+    OSTree* T = os_create_tree();
+    T->arena = arena_create(sizeof(OSNode), NODES_PER_FIRST_SLAB); // the block below gets its own slab
+    if (n <= 0)
+        return T;
+
+    int height = 0;
+    while ((1 << height) <= n && height < 31)
+        height++;
+    OSNode* nodes = (OSNode*)arena_alloc_block(T->arena, n);
+    T->root = os_build_range(nodes, keys, 0, n - 1, NULL, 0, height > 1 ? height - 1 : -1);
+    return T;
+}
+
+// streamed bulk load and insert, see tree_build_from_stream in bst.c
+typedef struct OSStreamBuild {
+    KeyStream* S;
+    int last;
+    int bad;
+} OSStreamBuild;
+
+static OSNode* os_stream_range(OSStreamBuild* b, OSNode* nodes, int lo, int hi, OSNode* parent, int depth, int red_depth){
+    if (lo > hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    OSNode* x = &nodes[mid];
+    x->size = hi - lo + 1;
+    x->color = (depth == red_depth) ? 0 : 1;
+    x->p = parent;
+    x->left = os_stream_range(b, nodes, lo, mid - 1, x, depth + 1, red_depth);
+    int key = 0;
+    if (!key_stream_get(b->S, &key) || (mid > 0 && key < b->last))
+        b->bad = 1;
+    x->key = key;
+    b->last = key;
+    x->right = os_stream_range(b, nodes, mid + 1, hi, x, depth + 1, red_depth);
+    return x;
+}
+
+OSTree* os_tree_build_from_stream(KeyStream* S){
+    size_t left = S->count - S->pos;
+    if (left > INT_MAX)
+        return NULL;
+    int n = (int)left;
+    OSTree* T = os_create_tree();
+    T->arena = arena_create(sizeof(OSNode), NODES_PER_FIRST_SLAB); // the block below gets its own slab
+    if (n == 0)
+        return T;
+
+    int height = 0;
+    while ((1 << height) <= n && height < 31)
+        height++;
+    OSNode* nodes = (OSNode*)arena_alloc_block(T->arena, n);
+    OSStreamBuild b = {S, 0, 0};
+    T->root = os_stream_range(&b, nodes, 0, n - 1, NULL, 0, height > 1 ? height - 1 : -1);
+    if (b.bad){
+        os_destroy_arena_tree(T);
+        return NULL;
+    }
     return T;
 }
 
+long os_tree_insert_stream(OSTree* T, KeyStream* S){
+    long inserted = 0;
+    size_t got;
+    const int* keys;
+    while ((keys = key_stream_next(S, 0, &got)) != NULL){
+        for (size_t i = 0; i < got; i++)
+            os_tree_insert(T, os_tree_alloc_node(T, keys[i]));
+        inserted += (long)got;
+    }
+    return inserted;
+}
+
+// parallel bulk load, same split as tree_build_parallel in bst.c: spine built
+// here, the ranges below it go to the threads, sizes come from the range length
+typedef struct OSBuildTask {
+    int lo, hi;
+    OSNode* parent;
+    OSNode** link;
+    int depth;
+} OSBuildTask;
+
+typedef struct OSBuildCtx {
+    OSNode* nodes;
+    int* keys;
+    int red_depth;
+    OSBuildTask* tasks;
+} OSBuildCtx;
+
+static void os_build_spine(OSBuildCtx* c, int lo, int hi, OSNode* parent, OSNode** link, int depth, int cut, int* ntasks){
+    if (lo > hi){
+        *link = NULL;
+        return;
+    }
+    if (depth == cut){
+        OSBuildTask* t = &c->tasks[(*ntasks)++];
+        t->lo = lo;
+        t->hi = hi;
+        t->parent = parent;
+        t->link = link;
+        t->depth = depth;
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    OSNode* x = &c->nodes[mid];
+    x->key = c->keys[mid];
+    x->size = hi - lo + 1;
+    x->color = (depth == c->red_depth) ? 0 : 1;
+    x->p = parent;
+    *link = x;
+    os_build_spine(c, lo, mid - 1, x, &x->left, depth + 1, cut, ntasks);
+    os_build_spine(c, mid + 1, hi, x, &x->right, depth + 1, cut, ntasks);
+}
+
+static void os_build_task(void* arg, int task){
+    OSBuildCtx* c = (OSBuildCtx*)arg;
+    OSBuildTask* t = &c->tasks[task];
+    *t->link = os_build_range(c->nodes, c->keys, t->lo, t->hi, t->parent, t->depth, c->red_depth);
+}
+
+OSTree* os_tree_build_parallel(int* keys, int n, int threads){
+    if (threads < 1)
+        threads = 1;
+    parallel_sort(keys, n, threads);
+
+    OSTree* T = os_create_tree();
+    T->arena = arena_create(sizeof(OSNode), NODES_PER_FIRST_SLAB); // the block below gets its own slab
+    if (n <= 0)
+        return T;
+
+    int height = 0;
+    while ((1 << height) <= n && height < 31)
+        height++;
+    int cut = 0;
+    while ((1 << cut) < 4 * threads && cut < height - 1)
+        cut++;
+
+    OSBuildCtx c;
+    c.nodes = (OSNode*)arena_alloc_block(T->arena, n);
+    c.keys = keys;
+    c.red_depth = height > 1 ? height - 1 : -1;
+    c.tasks = (OSBuildTask*)malloc(((size_t)1 << cut) * sizeof(OSBuildTask));
+    int ntasks = 0;
+    os_build_spine(&c, 0, n - 1, NULL, &T->root, 0, cut, &ntasks);
+    parallel_for(threads, ntasks, os_build_task, &c);
+    free(c.tasks);
+    return T;
+}
+
+//give back a node after os_tree_delete
+void os_tree_free_node(OSTree* T, OSNode* z){
+    if (T->arena == NULL){
+        free(z);
+    }
+    else{
+        arena_free(T->arena, z);
+    }
+}
+
+//empty the tree, keep the slabs around for reuse
+void os_reset_arena_tree(OSTree* T){
+    if (T->arena != NULL){
+        arena_reset(T->arena);
+    }
+    else{
+        os_destroy_tree(T->root);
+    }
+    T->root = NULL;
+    os_tree_forget_ends(T);
+}
+
+//whole tree gone with one arena teardown
+void os_destroy_arena_tree(OSTree* T){
+    if (T->arena != NULL){
+        arena_destroy(T->arena);
+    }
+    else{
+        os_destroy_tree(T->root);
+    }
+    free(T);
+}
+
 //Size of subtree 
 int os_get_size(OSNode* x){
     if(x == NULL){
@@ -27,116 +263,268 @@ int os_get_size(OSNode* x){
     return x->size;
 }
 
-//OS-Tree Insert + size maintanence
+//OS-Tree Insert + size maintanence: size++ on the way down (augment.h)
 void os_tree_insert(OSTree* T, OSNode* z){
-    //SETup
-    OSNode* y = NULL;
-    OSNode* x = T->root;
+    os_aug_insert(T, z);
+    if (z->p == NULL)
+        T->leftmost = T->rightmost = z;
+    else if (z->p == T->rightmost && z == z->p->right)
+        T->rightmost = z;
+    else if (z->p == T->leftmost && z == z->p->left)
+        T->leftmost = z;
+}
 
-    //1)insertion point
-    while(x!= NULL){
-        y=x;
-        x->size++; //increment size of  each node on this path to maintain size
-        if(z->key < x->key){
-            x = x->left;
+// Same climb as hint_start in bst.c
+static OSNode* os_hint_start(OSTree* T, OSNode* hint, int key){
+    OSNode* a = hint;
+    if (key >= hint->key){
+        if (T->rightmost == NULL)
+            T->rightmost = os_tree_max(T->root);
+        assert(T->rightmost->right == NULL);
+        if (hint == T->rightmost)
+            return hint;
+        for (;;){
+            OSNode* c = a;
+            OSNode* p = a->p;
+            while (p != NULL && c == p->right){
+                c = p;
+                p = p->p;
+            }
+            if (p == NULL || key < p->key)
+                return a;
+            a = p;
         }
-        else{
-            x = x->right;
+    }
+    if (T->leftmost == NULL)
+        T->leftmost = os_tree_min(T->root);
+    assert(T->leftmost->left == NULL);
+    if (hint == T->leftmost)
+        return hint;
+    for (;;){
+        OSNode* c = a;
+        OSNode* p = a->p;
+        while (p != NULL && c == p->left){
+            c = p;
+            p = p->p;
         }
+        if (p == NULL || key >= p->key)
+            return a;
+        a = p;
     }
+}
 
-    //2) Normal BST insert now
-    z->p = y;
-    if (y == NULL){
-        T->root = z; //empty tree case
+// Hinted OS-insert: descend from the finger, then size++ on every ancestor.
+// The climb is O(depth) pointer hops but no key compares.
+void os_tree_insert_hint(OSTree* T, OSNode* hint, OSNode* z){
+    if (hint == NULL){
+        os_tree_insert(T, z);
+        return;
     }
-    else if (z->key < y->key){
-        y->left = z;
+    OSNode* y = NULL;
+    OSNode* x = os_hint_start(T, hint, z->key);
+    while (x != NULL){
+        y = x;
+        x = (z->key < x->key) ? x->left : x->right;
     }
-    else{
+    z->p = y;
+    if (z->key < y->key)
+        y->left = z;
+    else
         y->right = z;
-    }
+    if (y == T->rightmost && z == y->right)
+        T->rightmost = z;
+    else if (y == T->leftmost && z == y->left)
+        T->leftmost = z;
+    os_aug_add_up(y, z);
 }
 
 //TRansplant
 void os_transplant(OSTree* T, OSNode* u, OSNode* v){
-    if(u->p == NULL){
-        T->root = v;
-    }
-    else if (u == u->p->left){
-        u->p->left = v;
-    }
-    else{
-        u->p->right = v;
-    }
-
-    if (v!= NULL){
-        v->p = u->p;
-    }
+    os_aug_transplant(T, u, v);
 }
 
-//OS tree delete + maintaining size along deleted path
+//OS tree delete: normal BST delete, then size-- from the lowest
+//parent that changed up to the root
 void os_tree_delete(OSTree* T, OSNode* z) {
-    //1 Decrement size along path from root to z
-    OSNode* current = T->root;
-    while (current != NULL) {
-        current->size--;
-        if (z->key < current->key)
-            current = current->left;
-        else if (z->key > current->key)
-            current = current->right;
-        else
-            break;  // break out since we have found z
-    }
-
-    // Normal bst delete
-    if (z->left == NULL)
-        os_transplant(T, z, z->right);
-    else if (z->right == NULL)
-        os_transplant(T, z, z->left);
-    else {
-        OSNode* y = os_tree_min(z->right);
-
-        // succesor is not a direct child hence we update the nodes on the path
-        if (y->p != z) {
-            OSNode* temp = y->p;
-            while (temp != z) {
-                temp->size--;
-                temp = temp->p;
-            }
-        }
+    if (z == T->leftmost)
+        T->leftmost = NULL;
+    if (z == T->rightmost)
+        T->rightmost = NULL;
+    os_aug_delete(T, z);
+}
 
-        if (y->p != z) {
-            os_transplant(T, y, y->right);
-            y->right = z->right;
-            y->right->p = y;
-        }
-        os_transplant(T, z, y);
-        y->left = z->left;
-        y->left->p = y;
+//OS_Select to find ith smallest element in subtree (loop instead of tail recursion)
+OSNode* os_select(OSNode* x , int i){
+    while (x != NULL){
+        int r = os_get_size(x->left) + 1;  // Rank of x is in this subtree
 
-        // Update y size
-        y->size = os_get_size(y->left) + os_get_size(y->right) + 1;
+        if (i == r){
+            return x;
+        }
+        else if (i < r){
+            x = x->left;
+        }
+        else{
+            i = i - r;
+            x = x->right;
+        }
     }
+    return NULL;
 }
 
-//OS_Select to find ith smallest element in subtree
-OSNode* os_select(OSNode* x , int i){
-    if (x == NULL){
-        return NULL;    
+// Batched OS-SELECT, lookups interleaved like tree_search_batch.
+// Each node costs two dependent loads (x, then x->left for its size),
+// so every select alternates: turn 1 reads x and prefetches x->left,
+// turn 2 reads the size, picks a side and prefetches that child.
+void os_select_batch(OSTree* T, const int* ranks, int m, OSNode** out){
+    OSNode* node[BATCH_IN_FLIGHT];
+    int i[BATCH_IN_FLIGHT];       // rank still to find inside node's subtree
+    int query[BATCH_IN_FLIGHT];   // -1 = idle slot
+    int left_ready[BATCH_IN_FLIGHT];
+    int slots = (m < BATCH_IN_FLIGHT) ? m : BATCH_IN_FLIGHT;
+    int next = slots;
+    int active = slots;
+
+    for (int s = 0; s < slots; s++){
+        query[s] = s;
+        node[s] = T->root;
+        i[s] = ranks[s];
+        left_ready[s] = 0;
     }
 
-    int r = os_get_size(x->left) + 1;  // Rank of x is in this subtree
+    while (active > 0){
+        for (int s = 0; s < slots; s++){
+            if (query[s] < 0)
+                continue;
+            OSNode* x = node[s];
+            if (x != NULL && !left_ready[s]){
+                __builtin_prefetch(x->left);
+                left_ready[s] = 1;
+                continue;
+            }
+
+            int r = (x != NULL) ? os_get_size(x->left) + 1 : 0;
+            if (x == NULL || i[s] == r){
+                out[query[s]] = x;
+                if (next < m){
+                    query[s] = next++;
+                    node[s] = T->root;
+                    i[s] = ranks[query[s]];
+                    left_ready[s] = 0;
+                }
+                else{
+                    query[s] = -1;
+                    active--;
+                }
+                continue;
+            }
+            if (i[s] < r){
+                x = x->left;
+            }
+            else{
+                i[s] -= r;
+                x = x->right;
+            }
+            __builtin_prefetch(x);
+            node[s] = x;
+            left_ready[s] = 0;
+        }
+    }
+}
 
-    if (i == r){
-        return x;
+// First k in [a, b) with ranks[k] >= r, given ranks[a] < r <= ranks[b-1].
+// Galloping in from both ends costs the log of the smaller side, which is
+// what keeps the splits in os_select_many at O(m) in total.
+static int split_ranks(const int* ranks, int a, int b, int r){
+    int lo = a, hi = b - 1;   // ranks[lo] < r <= ranks[hi]
+    for (int d = 1; ; d *= 2){
+        if (a + d >= hi)
+            break;
+        if (ranks[a + d] >= r){
+            hi = a + d;
+            break;
+        }
+        lo = a + d;
+        if (b - 1 - d <= lo)
+            break;
+        if (ranks[b - 1 - d] < r){
+            lo = b - 1 - d;
+            break;
+        }
+        hi = b - 1 - d;
     }
-    else if (i < r){
-        return os_select(x->left, i);
+    while (hi - lo > 1){
+        int mid = lo + (hi - lo) / 2;
+        if (ranks[mid] >= r)
+            hi = mid;
+        else
+            lo = mid;
     }
-    else{
-        return os_select(x->right, i - r);   
+    return hi;
+}
+
+typedef struct SelectSpan {
+    OSNode* x;
+    int base;       // ranks below x's subtree
+    int a, b;       // slice of ranks that lands in it
+} SelectSpan;
+
+// Multi-select: ranks must be ascending (repeats fine). One descent for all
+// of them, the slice of ranks splits at each node instead of every query
+// starting again at the root, so the top levels are read once. Left halves
+// are followed in the loop, right halves wait on an explicit stack (a
+// degenerate tree would otherwise mean n-deep recursion).
+// out[j] = os_select(root, ranks[j]), NULL when out of range.
+void os_select_many(OSNode* root, const int* ranks, int m, OSNode** out){
+    if (m <= 0)
+        return;
+    SelectSpan inline_stack[64];    // no malloc unless the tree is deep
+    SelectSpan* stack = inline_stack;
+    int cap = 64, top = 0;
+    stack[top++] = (SelectSpan){root, 0, 0, m};
+    while (top > 0){
+        SelectSpan sp = stack[--top];
+        OSNode* x = sp.x;
+        int base = sp.base, a = sp.a, b = sp.b;
+        while (a < b){
+            if (x == NULL){
+                for (int k = a; k < b; k++)
+                    out[k] = NULL;
+                break;
+            }
+            int r = base + os_get_size(x->left) + 1;
+            if (ranks[b - 1] < r){          // whole slice on the left
+                x = x->left;
+                continue;
+            }
+            if (ranks[a] > r){              // whole slice on the right
+                base = r;
+                x = x->right;
+                continue;
+            }
+            int k = (ranks[a] == r) ? a : split_ranks(ranks, a, b, r);
+            int k2 = k;
+            while (k2 < b && ranks[k2] == r)
+                out[k2++] = x;
+            if (k2 < b){
+                if (top == cap){
+                    cap *= 2;
+                    if (stack == inline_stack){
+                        stack = (SelectSpan*)malloc(cap * sizeof(SelectSpan));
+                        memcpy(stack, inline_stack, sizeof(inline_stack));
+                    }
+                    else
+                        stack = (SelectSpan*)realloc(stack, cap * sizeof(SelectSpan));
+                }
+                __builtin_prefetch(x->right);   // its turn comes after the left side
+                stack[top++] = (SelectSpan){x->right, r, k2, b};
+            }
+            b = k;
+            x = x->left;
+        }
     }
+    if (stack != inline_stack)
+        free(stack);
 }
 
 // OS-RANK
@@ -153,15 +541,54 @@ int os_rank(OSTree* T, OSNode* x) {
     return r;
 }
 
+// Keys below key in the subtree at x (upper: keys <= key), one descent
+static int os_keys_below(OSNode* x, int key, int upper) {
+    int r = 0;
+    while (x != NULL) {
+        if (x->key < key || (upper && x->key == key)) {
+            r += os_get_size(x->left) + 1;
+            x = x->right;
+        }
+        else
+            x = x->left;
+    }
+    return r;
+}
+
+// Rank by key, no node needed: lower bound, so the rank of the first node
+// with key, or the rank key would get if inserted (n+1 past the max)
+int os_rank_of_key(OSTree* T, int key) {
+    return os_keys_below(T->root, key, 0) + 1;
+}
+
+// Upper bound: rank of the last node with key (keys <= key, 0 below the min)
+int os_rank_of_key_upper(OSTree* T, int key) {
+    return os_keys_below(T->root, key, 1);
+}
+
+// Keys in [lo, hi]. Down to the first node inside the range, then lo is
+// counted off in its left subtree and hi in its right one
+int os_count_range(OSTree* T, int lo, int hi) {
+    if (lo > hi)
+        return 0;
+    OSNode* x = T->root;
+    while (x != NULL && (x->key < lo || x->key > hi))
+        x = (x->key < lo) ? x->right : x->left;
+    if (x == NULL)
+        return 0;
+    return os_get_size(x->left) - os_keys_below(x->left, lo, 0) + 1 + os_keys_below(x->right, hi, 1);
+}
+
 
 //Search for node in tree
 OSNode* os_tree_search(OSNode* x, int k) {
-    if (x == NULL || k == x->key)
-        return x;
-    if (k < x->key)
-        return os_tree_search(x->left, k);
-    else
-        return os_tree_search(x->right, k);
+    while (x != NULL && k != x->key) {
+        if (k < x->key)
+            x = x->left;
+        else
+            x = x->right;
+    }
+    return x;
 }
 
 
@@ -173,44 +600,249 @@ OSNode* os_tree_min(OSNode* x){
     return x;
 }
 
+//tree max -> just gaan right
+OSNode* os_tree_max(OSNode* x){
+    while(x->right != NULL){
+        x = x->right;
+    }
+    return x;
+}
+
+OSNode* os_tree_successor(OSNode* x){
+    if (x->right != NULL){
+        return os_tree_min(x->right);
+    }
+    OSNode* y = x->p;
+    while (y != NULL && x == y->right){
+        x = y;
+        y = y->p;
+    }
+    return y;
+}
+
+OSNode* os_tree_predecessor(OSNode* x){
+    if (x->left != NULL){
+        return os_tree_max(x->left);
+    }
+    OSNode* y = x->p;
+    while (y != NULL && x == y->left){
+        x = y;
+        y = y->p;
+    }
+    return y;
+}
+
+//successor but stays inside the subtree at top -> lets walks run without a stack
+static OSNode* os_subtree_successor(OSNode* x, OSNode* top){
+    if (x->right != NULL){
+        return os_tree_min(x->right);
+    }
+    while (x != top && x == x->p->right){
+        x = x->p;
+    }
+    return (x == top) ? NULL : x->p;
+}
+
 
 //This one will have priting built in for output validation and testing
 void os_inorder_tree_walk(OSNode* x) {
-    if (x != NULL) {
-        os_inorder_tree_walk(x->left);
-        printf("%d(size=%d) ", x->key, x->size);
-        os_inorder_tree_walk(x->right);
-    }
+    if (x == NULL)
+        return;
+    for (OSNode* y = os_tree_min(x); y != NULL; y = os_subtree_successor(y, x))
+        printf("%d(size=%d) ", y->key, y->size);
 }
 
 //Silent version of above since we are timing it also
 void os_inorder_tree_walk_silent(OSNode* x) {
-    if (x != NULL) {
-        os_inorder_tree_walk_silent(x->left);
-        volatile int temp __attribute__((unused)) = x->key; // since i had to google this: volatile means the compiler 
+    if (x == NULL)
+        return;
+    for (OSNode* y = os_tree_min(x); y != NULL; y = os_subtree_successor(y, x)) {
+        volatile int temp __attribute__((unused)) = y->key; // since i had to google this: volatile means the compiler 
                                                             //wont optimise it since we want to time it and forcing the compiler to 
                                                             //actually read this ptr from memory instead of skipping it since it is unused
-        os_inorder_tree_walk_silent(x->right);
     }
 }
 
-//Height of tree
+//Height of tree -> no recursion, parent pointers tell us where we came from
 int os_tree_height(OSNode* node) {
     if (node == NULL)
         return 0;
 
-    int left_height = os_tree_height(node->left);
-    int right_height = os_tree_height(node->right);
-
-    return 1 + (left_height > right_height ? left_height : right_height);
+    int depth = 1, height = 1;
+    OSNode* x = node;
+    OSNode* prev = node->p;
+    while (x != NULL) {
+        if (prev == x->p && x->left != NULL) {
+            prev = x; x = x->left; depth++;
+        }
+        else if ((prev == x->p || prev == x->left) && x->right != NULL) {
+            prev = x; x = x->right; depth++;
+        }
+        else {
+            if (depth > height)
+                height = depth;
+            if (x == node)
+                break;
+            prev = x; x = x->p; depth--;
+        }
+    }
+    return height;
 }
 
 
-//free the tree
+//free the tree -> leaf by leaf going back up through parents, no recursion
 void os_destroy_tree(OSNode* root) {
-    if (root != NULL) {
-        os_destroy_tree(root->left);
-        os_destroy_tree(root->right);
-        free(root);
+    OSNode* x = root;
+    while (x != NULL) {
+        if (x->left != NULL) {
+            x = x->left;
+        }
+        else if (x->right != NULL) {
+            x = x->right;
+        }
+        else {
+            OSNode* parent = x->p;
+            if (x == root) {
+                free(x);
+                break;
+            }
+            if (parent->left == x)
+                parent->left = NULL;
+            else
+                parent->right = NULL;
+            free(x);
+            x = parent;
+        }
+    }
+}
+
+// Fast teardown, same scheme as destroy_tree_parallel in bst.c: split off
+// subtrees, groups of them per task, BATCH_IN_FLIGHT interleaved walks each
+#define DESTROY_TASKS_PER_THREAD 4
+
+// free the disjoint subtrees roots[0..m), slots refilled as walks finish.
+// Returns how many nodes went.
+static long os_destroy_walks(OSNode** roots, int m){
+    long freed = 0;
+    OSNode* sub[BATCH_IN_FLIGHT];
+    OSNode* cur[BATCH_IN_FLIGHT];
+    int slots = m < BATCH_IN_FLIGHT ? m : BATCH_IN_FLIGHT;
+    int next_root = 0;
+    for (int i = 0; i < slots; i++)
+        sub[i] = cur[i] = roots[next_root++];
+    int active = slots;
+
+    while (active > 0){
+        for (int i = 0; i < slots; i++){
+            OSNode* x = cur[i];
+            if (x == NULL)
+                continue;
+            OSNode* nx;
+            if (x->left != NULL){
+                nx = x->left;
+            }
+            else if (x->right != NULL){
+                nx = x->right;
+            }
+            else{
+                nx = x->p;
+                if (x == sub[i]){              // subtree done, start the next one
+                    nx = NULL;
+                    if (next_root < m)
+                        nx = sub[i] = roots[next_root++];
+                    else
+                        active--;
+                }
+                else if (nx->left == x){
+                    nx->left = NULL;
+                }
+                else{
+                    nx->right = NULL;
+                }
+                free(x);
+                freed++;
+            }
+            if (nx != NULL)
+                __builtin_prefetch(nx);
+            cur[i] = nx;
+        }
     }
+    return freed;
+}
+
+typedef struct OSDestroyCtx {
+    OSNode** roots;
+    int nroots;
+    int ntasks;
+    long freed;     // summed over the tasks
+} OSDestroyCtx;
+
+static void os_destroy_task(void* arg, int task){
+    OSDestroyCtx* c = (OSDestroyCtx*)arg;
+    int lo = (int)((long long)c->nroots * task / c->ntasks);
+    int hi = (int)((long long)c->nroots * (task + 1) / c->ntasks);
+    __atomic_add_fetch(&c->freed, os_destroy_walks(c->roots + lo, hi - lo), __ATOMIC_RELAXED);
+}
+
+long os_destroy_tree_parallel(OSNode* root, int threads){
+    if (root == NULL)
+        return 0;
+    if (threads < 1)
+        threads = 1;
+    int ntasks = threads > 1 ? DESTROY_TASKS_PER_THREAD * threads : 1;
+    int want = ntasks * BATCH_IN_FLIGHT;
+    OSNode** level = (OSNode**)malloc(2 * want * sizeof(OSNode*));
+    OSNode** next = (OSNode**)malloc(2 * want * sizeof(OSNode*));
+    int nlevel = 1;
+    level[0] = root;
+    long freed = 0;
+
+    // children are read before a node is freed and the walks below never
+    // look at a subtree root's parent, so the top levels can go right away
+    while (nlevel > 0 && nlevel < want){
+        int nnext = 0;
+        for (int i = 0; i < nlevel; i++){
+            OSNode* x = level[i];
+            if (x->left != NULL)
+                next[nnext++] = x->left;
+            if (x->right != NULL)
+                next[nnext++] = x->right;
+            free(x);
+            freed++;
+        }
+        OSNode** t = level; level = next; next = t;
+        nlevel = nnext;
+    }
+
+    // subtrees never touch the spine above them, so no locking
+    OSDestroyCtx c = {level, nlevel, ntasks < nlevel ? ntasks : (nlevel > 0 ? nlevel : 1), 0};
+    parallel_for(threads, c.ntasks, os_destroy_task, &c);
+    free(level);
+    free(next);
+    return freed + c.freed;
+}
+
+//In-order cursor
+OSNode* os_tree_cursor_begin(OSTreeCursor* c, OSTree* T) {
+    c->T = T;
+    c->node = (T->root == NULL) ? NULL : os_tree_min(T->root);
+    return c->node;
+}
+
+OSNode* os_tree_cursor_last(OSTreeCursor* c, OSTree* T) {
+    c->T = T;
+    c->node = (T->root == NULL) ? NULL : os_tree_max(T->root);
+    return c->node;
+}
+
+OSNode* os_tree_cursor_next(OSTreeCursor* c) {
+    if (c->node != NULL)
+        c->node = os_tree_successor(c->node);
+    return c->node;
+}
+
+OSNode* os_tree_cursor_prev(OSTreeCursor* c) {
+    if (c->node != NULL)
+        c->node = os_tree_predecessor(c->node);
+    return c->node;
 }
\ No newline at end of file
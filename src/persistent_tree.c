@@ -0,0 +1,368 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/persistent_tree.h"
+
+// Refcounts are the only thing ever written in a published node, and a
+// version can be released on one thread while another builds on it, so
+// they go through atomics. Everything else is immutable after the node is
+// built, which is what makes reading an old version from anywhere safe.
+
+static long live_nodes = 0;
+static long os_live_nodes = 0;
+
+// Root-to-node path of an update, with the side taken at each step.
+// Small paths stay on the stack, deep ones (unbalanced trees) spill to malloc.
+#define PATH_INLINE 64
+
+typedef struct {
+    void** node;
+    unsigned char* dir;     // 0 = went left, 1 = went right
+    int len, cap;
+    void* inline_node[PATH_INLINE];
+    unsigned char inline_dir[PATH_INLINE];
+} Path;
+
+static void path_init(Path* P){
+    P->node = P->inline_node;
+    P->dir = P->inline_dir;
+    P->len = 0;
+    P->cap = PATH_INLINE;
+}
+
+static void path_push(Path* P, void* x, int dir){
+    if (P->len == P->cap){
+        int cap = P->cap * 2;
+        void** node = (void**)malloc(cap * sizeof(void*));
+        unsigned char* d = (unsigned char*)malloc(cap);
+        for (int i = 0; i < P->len; i++){
+            node[i] = P->node[i];
+            d[i] = P->dir[i];
+        }
+        if (P->node != P->inline_node){
+            free(P->node);
+            free(P->dir);
+        }
+        P->node = node;
+        P->dir = d;
+        P->cap = cap;
+    }
+    P->node[P->len] = x;
+    P->dir[P->len] = (unsigned char)dir;
+    P->len++;
+}
+
+static void path_free(Path* P){
+    if (P->node != P->inline_node){
+        free(P->node);
+        free(P->dir);
+    }
+}
+
+// ---------- BST ----------
+
+// takes over the references to l and r
+static PNode* pnode_new(int key, PNode* l, PNode* r){
+    PNode* x = (PNode*)malloc(sizeof(PNode));
+    x->key = key;
+    x->refs = 1;
+    x->left = l;
+    x->right = r;
+    __atomic_add_fetch(&live_nodes, 1, __ATOMIC_RELAXED);
+    return x;
+}
+
+static PNode* share(PNode* x){
+    if (x != NULL)
+        __atomic_add_fetch(&x->refs, 1, __ATOMIC_RELAXED);
+    return x;
+}
+
+PNode* ptree_retain(PNode* root){
+    return share(root);
+}
+
+// Last reference gone -> free and drop one reference from each child.
+// Explicit stack so an old degenerate version does not recurse n deep.
+void ptree_release(PNode* root){
+    if (root == NULL || __atomic_sub_fetch(&root->refs, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+    int cap = 64, top = 0;
+    PNode** stack = (PNode**)malloc(cap * sizeof(PNode*));
+    stack[top++] = root;
+    while (top > 0){
+        PNode* x = stack[--top];
+        PNode* kids[2] = {x->left, x->right};
+        free(x);
+        __atomic_sub_fetch(&live_nodes, 1, __ATOMIC_RELAXED);
+        for (int c = 0; c < 2; c++){
+            if (kids[c] != NULL && __atomic_sub_fetch(&kids[c]->refs, 1, __ATOMIC_ACQ_REL) == 0){
+                if (top == cap){
+                    cap *= 2;
+                    stack = (PNode**)realloc(stack, cap * sizeof(PNode*));
+                }
+                stack[top++] = kids[c];
+            }
+        }
+    }
+    free(stack);
+}
+
+// Fresh copies of P's nodes bottom-up, `below` hung where the path went on;
+// the side the path did not take is shared
+static PNode* copy_path(Path* P, PNode* below){
+    for (int i = P->len - 1; i >= 0; i--){
+        PNode* x = (PNode*)P->node[i];
+        if (P->dir[i] == 0)
+            below = pnode_new(x->key, below, share(x->right));
+        else
+            below = pnode_new(x->key, share(x->left), below);
+    }
+    return below;
+}
+
+PNode* ptree_insert(PNode* root, int key){
+    Path P;
+    path_init(&P);
+    for (PNode* x = root; x != NULL; ){
+        int right = !(key < x->key);
+        path_push(&P, x, right);
+        x = right ? x->right : x->left;
+    }
+    PNode* v = copy_path(&P, pnode_new(key, NULL, NULL));
+    path_free(&P);
+    return v;
+}
+
+// z with at most one child: the path above it is copied onto that child.
+// Two children: the successor's key goes into a new node at z's place, over
+// z's left subtree and a copy of the right subtree's leftmost path without
+// the successor.
+PNode* ptree_delete(PNode* root, int key){
+    Path P;
+    path_init(&P);
+    PNode* z = root;
+    while (z != NULL && z->key != key){
+        int right = !(key < z->key);
+        path_push(&P, z, right);
+        z = right ? z->right : z->left;
+    }
+    if (z == NULL){
+        path_free(&P);
+        return share(root);
+    }
+    PNode* below;
+    if (z->left == NULL)
+        below = share(z->right);
+    else if (z->right == NULL)
+        below = share(z->left);
+    else{
+        Path S;
+        path_init(&S);
+        PNode* y = z->right;
+        while (y->left != NULL){
+            path_push(&S, y, 0);
+            y = y->left;
+        }
+        PNode* sub = copy_path(&S, share(y->right));
+        path_free(&S);
+        below = pnode_new(y->key, share(z->left), sub);
+    }
+    PNode* v = copy_path(&P, below);
+    path_free(&P);
+    return v;
+}
+
+PNode* ptree_search(PNode* root, int key){
+    PNode* x = root;
+    while (x != NULL && key != x->key)
+        x = (key < x->key) ? x->left : x->right;
+    return x;
+}
+
+static PNode* build_range(const int* keys, int lo, int hi){
+    if (lo > hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    PNode* l = build_range(keys, lo, mid - 1);
+    return pnode_new(keys[mid], l, build_range(keys, mid + 1, hi));
+}
+
+PNode* ptree_build_from_sorted(const int* keys, int n){
+    return build_range(keys, 0, n - 1);
+}
+
+long ptree_live_nodes(void){
+    return __atomic_load_n(&live_nodes, __ATOMIC_RELAXED);
+}
+
+// ---------- OS-tree ----------
+
+int os_ptree_size(OSPNode* x){
+    return x == NULL ? 0 : x->size;
+}
+
+static OSPNode* os_pnode_new(int key, OSPNode* l, OSPNode* r){
+    OSPNode* x = (OSPNode*)malloc(sizeof(OSPNode));
+    x->key = key;
+    x->size = os_ptree_size(l) + os_ptree_size(r) + 1;
+    x->refs = 1;
+    x->left = l;
+    x->right = r;
+    __atomic_add_fetch(&os_live_nodes, 1, __ATOMIC_RELAXED);
+    return x;
+}
+
+static OSPNode* os_share(OSPNode* x){
+    if (x != NULL)
+        __atomic_add_fetch(&x->refs, 1, __ATOMIC_RELAXED);
+    return x;
+}
+
+OSPNode* os_ptree_retain(OSPNode* root){
+    return os_share(root);
+}
+
+void os_ptree_release(OSPNode* root){
+    if (root == NULL || __atomic_sub_fetch(&root->refs, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+    int cap = 64, top = 0;
+    OSPNode** stack = (OSPNode**)malloc(cap * sizeof(OSPNode*));
+    stack[top++] = root;
+    while (top > 0){
+        OSPNode* x = stack[--top];
+        OSPNode* kids[2] = {x->left, x->right};
+        free(x);
+        __atomic_sub_fetch(&os_live_nodes, 1, __ATOMIC_RELAXED);
+        for (int c = 0; c < 2; c++){
+            if (kids[c] != NULL && __atomic_sub_fetch(&kids[c]->refs, 1, __ATOMIC_ACQ_REL) == 0){
+                if (top == cap){
+                    cap *= 2;
+                    stack = (OSPNode**)realloc(stack, cap * sizeof(OSPNode*));
+                }
+                stack[top++] = kids[c];
+            }
+        }
+    }
+    free(stack);
+}
+
+// sizes come out right for free: each copy is counted from its new children
+static OSPNode* os_copy_path(Path* P, OSPNode* below){
+    for (int i = P->len - 1; i >= 0; i--){
+        OSPNode* x = (OSPNode*)P->node[i];
+        if (P->dir[i] == 0)
+            below = os_pnode_new(x->key, below, os_share(x->right));
+        else
+            below = os_pnode_new(x->key, os_share(x->left), below);
+    }
+    return below;
+}
+
+OSPNode* os_ptree_insert(OSPNode* root, int key){
+    Path P;
+    path_init(&P);
+    for (OSPNode* x = root; x != NULL; ){
+        int right = !(key < x->key);
+        path_push(&P, x, right);
+        x = right ? x->right : x->left;
+    }
+    OSPNode* v = os_copy_path(&P, os_pnode_new(key, NULL, NULL));
+    path_free(&P);
+    return v;
+}
+
+OSPNode* os_ptree_delete(OSPNode* root, int key){
+    Path P;
+    path_init(&P);
+    OSPNode* z = root;
+    while (z != NULL && z->key != key){
+        int right = !(key < z->key);
+        path_push(&P, z, right);
+        z = right ? z->right : z->left;
+    }
+    if (z == NULL){
+        path_free(&P);
+        return os_share(root);
+    }
+    OSPNode* below;
+    if (z->left == NULL)
+        below = os_share(z->right);
+    else if (z->right == NULL)
+        below = os_share(z->left);
+    else{
+        Path S;
+        path_init(&S);
+        OSPNode* y = z->right;
+        while (y->left != NULL){
+            path_push(&S, y, 0);
+            y = y->left;
+        }
+        OSPNode* sub = os_copy_path(&S, os_share(y->right));
+        path_free(&S);
+        below = os_pnode_new(y->key, os_share(z->left), sub);
+    }
+    OSPNode* v = os_copy_path(&P, below);
+    path_free(&P);
+    return v;
+}
+
+OSPNode* os_ptree_search(OSPNode* root, int key){
+    OSPNode* x = root;
+    while (x != NULL && key != x->key)
+        x = (key < x->key) ? x->left : x->right;
+    return x;
+}
+
+OSPNode* os_ptree_select(OSPNode* root, int i){
+    OSPNode* x = root;
+    while (x != NULL){
+        int r = os_ptree_size(x->left) + 1;
+        if (i == r)
+            return x;
+        if (i < r){
+            x = x->left;
+        }
+        else{
+            i -= r;
+            x = x->right;
+        }
+    }
+    return NULL;
+}
+
+// no parent pointers, so rank goes by key on the way down; on a match keep
+// going left in case an equal key sits further down there
+int os_ptree_rank(OSPNode* root, int key){
+    int r = 0, found = 0;
+    OSPNode* x = root;
+    while (x != NULL){
+        if (key < x->key){
+            x = x->left;
+        }
+        else if (key > x->key){
+            r += os_ptree_size(x->left) + 1;
+            x = x->right;
+        }
+        else{
+            found = r + os_ptree_size(x->left) + 1;
+            x = x->left;
+        }
+    }
+    return found;
+}
+
+static OSPNode* os_build_range(const int* keys, int lo, int hi){
+    if (lo > hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    OSPNode* l = os_build_range(keys, lo, mid - 1);
+    return os_pnode_new(keys[mid], l, os_build_range(keys, mid + 1, hi));
+}
+
+OSPNode* os_ptree_build_from_sorted(const int* keys, int n){
+    return os_build_range(keys, 0, n - 1);
+}
+
+long os_ptree_live_nodes(void){
+    return __atomic_load_n(&os_live_nodes, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,244 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/rb_tree.h"
+
+// NULL leaves count as black
+static int is_red(Node* x){
+    return x != NULL && x->color == RB_RED;
+}
+
+void rb_left_rotate(Tree* T, Node* x){
+    Node* y = x->right;          // y moves up into x's place
+    x->right = y->left;          // y's left subtree becomes x's right
+    if (y->left != NULL)
+        y->left->p = x;
+    y->p = x->p;
+    if (x->p == NULL)
+        T->root = y;
+    else if (x == x->p->left)
+        x->p->left = y;
+    else
+        x->p->right = y;
+    y->left = x;
+    x->p = y;
+}
+
+void rb_right_rotate(Tree* T, Node* x){
+    Node* y = x->left;
+    x->left = y->right;
+    if (y->right != NULL)
+        y->right->p = x;
+    y->p = x->p;
+    if (x->p == NULL)
+        T->root = y;
+    else if (x == x->p->right)
+        x->p->right = y;
+    else
+        x->p->left = y;
+    y->right = x;
+    x->p = y;
+}
+
+// RB-INSERT-FIXUP: push the red-red violation up or fix it with <= 2 rotations
+static void rb_insert_fixup(Tree* T, Node* z){
+    while (is_red(z->p)){
+        Node* gp = z->p->p;   // parent is red so it is not the root
+        if (z->p == gp->left){
+            Node* y = gp->right;  // uncle
+            if (is_red(y)){                      // case 1: recolour
+                z->p->color = RB_BLACK;
+                y->color = RB_BLACK;
+                gp->color = RB_RED;
+                z = gp;
+            }
+            else{
+                if (z == z->p->right){           // case 2: turn into case 3
+                    z = z->p;
+                    rb_left_rotate(T, z);
+                }
+                z->p->color = RB_BLACK;          // case 3
+                z->p->p->color = RB_RED;
+                rb_right_rotate(T, z->p->p);
+            }
+        }
+        else{
+            Node* y = gp->left;
+            if (is_red(y)){
+                z->p->color = RB_BLACK;
+                y->color = RB_BLACK;
+                gp->color = RB_RED;
+                z = gp;
+            }
+            else{
+                if (z == z->p->left){
+                    z = z->p;
+                    rb_right_rotate(T, z);
+                }
+                z->p->color = RB_BLACK;
+                z->p->p->color = RB_RED;
+                rb_left_rotate(T, z->p->p);
+            }
+        }
+    }
+    T->root->color = RB_BLACK;
+}
+
+void rb_tree_insert(Tree* T, Node* z){
+    tree_forget_ends(T);
+    Node* y = NULL;
+    Node* x = T->root;
+
+    // same descent as tree_insert (equal keys go right)
+    while (x != NULL){
+        y = x;
+        if (z->key < x->key)
+            x = x->left;
+        else
+            x = x->right;
+    }
+
+    z->p = y;
+    if (y == NULL)
+        T->root = z;
+    else if (z->key < y->key)
+        y->left = z;
+    else
+        y->right = z;
+
+    z->left = NULL;
+    z->right = NULL;
+    z->color = RB_RED;
+    rb_insert_fixup(T, z);
+}
+
+// RB-DELETE-FIXUP: x carries an extra black. Without a T.nil sentinel x can be
+// NULL, so its parent is passed along separately.
+static void rb_delete_fixup(Tree* T, Node* x, Node* xp){
+    while (x != T->root && !is_red(x)){
+        if (x == xp->left){
+            Node* w = xp->right;  // sibling, never NULL here (black heights)
+            if (is_red(w)){                                    // case 1
+                w->color = RB_BLACK;
+                xp->color = RB_RED;
+                rb_left_rotate(T, xp);
+                w = xp->right;
+            }
+            if (!is_red(w->left) && !is_red(w->right)){        // case 2
+                w->color = RB_RED;
+                x = xp;
+                xp = x->p;
+            }
+            else{
+                if (!is_red(w->right)){                        // case 3
+                    w->left->color = RB_BLACK;
+                    w->color = RB_RED;
+                    rb_right_rotate(T, w);
+                    w = xp->right;
+                }
+                w->color = xp->color;                          // case 4
+                xp->color = RB_BLACK;
+                w->right->color = RB_BLACK;
+                rb_left_rotate(T, xp);
+                x = T->root;
+                xp = NULL;
+            }
+        }
+        else{
+            Node* w = xp->left;
+            if (is_red(w)){
+                w->color = RB_BLACK;
+                xp->color = RB_RED;
+                rb_right_rotate(T, xp);
+                w = xp->left;
+            }
+            if (!is_red(w->left) && !is_red(w->right)){
+                w->color = RB_RED;
+                x = xp;
+                xp = x->p;
+            }
+            else{
+                if (!is_red(w->left)){
+                    w->right->color = RB_BLACK;
+                    w->color = RB_RED;
+                    rb_left_rotate(T, w);
+                    w = xp->left;
+                }
+                w->color = xp->color;
+                xp->color = RB_BLACK;
+                w->left->color = RB_BLACK;
+                rb_right_rotate(T, xp);
+                x = T->root;
+                xp = NULL;
+            }
+        }
+    }
+    if (x != NULL)
+        x->color = RB_BLACK;
+}
+
+void rb_tree_delete(Tree* T, Node* z){
+    tree_forget_ends(T);
+    Node* y = z;
+    unsigned char y_original_color = y->color;
+    Node* x;
+    Node* xp;   // parent of x after the splice
+
+    if (z->left == NULL){
+        x = z->right;
+        xp = z->p;
+        transplant(T, z, z->right);
+    }
+    else if (z->right == NULL){
+        x = z->left;
+        xp = z->p;
+        transplant(T, z, z->left);
+    }
+    else{
+        y = tree_min(z->right);
+        y_original_color = y->color;
+        x = y->right;
+        if (y->p == z){
+            xp = y;
+        }
+        else{
+            xp = y->p;
+            transplant(T, y, y->right);
+            y->right = z->right;
+            y->right->p = y;
+        }
+        transplant(T, z, y);
+        y->left = z->left;
+        y->left->p = y;
+        y->color = z->color;
+    }
+
+    if (y_original_color == RB_BLACK)
+        rb_delete_fixup(T, x, xp);
+}
+
+// Walk every node once (no recursion): no red node with a red parent, root black,
+// and every node with a NULL child sees the same number of blacks up to the root.
+int rb_validate(Tree* T){
+    if (T->root == NULL)
+        return 0;
+    if (is_red(T->root))
+        return -1;
+
+    int black_height = -1;
+    for (Node* x = tree_min(T->root); x != NULL; x = tree_successor(x)){
+        if (is_red(x) && is_red(x->p))
+            return -1;
+        if (x->left == NULL || x->right == NULL){
+            int blacks = 0;
+            for (Node* y = x; y != NULL; y = y->p){
+                if (!is_red(y))
+                    blacks++;
+            }
+            if (black_height == -1)
+                black_height = blacks;
+            else if (blacks != black_height)
+                return -1;
+        }
+    }
+    return black_height;
+}
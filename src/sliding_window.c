@@ -0,0 +1,61 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "math.h"
+#include "../include/sliding_window.h"
+#include "../include/os_rb_tree.h"
+
+SlidingWindow* window_create(int w){
+    if (w < 1)
+        return NULL;
+    SlidingWindow* W = (SlidingWindow*)malloc(sizeof(SlidingWindow));
+    W->T = os_create_tree();
+    W->ring = (OSNode*)malloc((size_t)w * sizeof(OSNode));
+    W->capacity = w;
+    W->count = 0;
+    W->head = 0;
+    return W;
+}
+
+// the nodes are one block, not the tree's, so no os_destroy_tree here
+void window_destroy(SlidingWindow* W){
+    if (W == NULL)
+        return;
+    free(W->ring);
+    free(W->T);
+    free(W);
+}
+
+void window_push(SlidingWindow* W, int sample){
+    OSNode* z;
+    if (W->count < W->capacity){
+        z = &W->ring[(W->head + W->count) % W->capacity];
+        W->count++;
+    }
+    else{
+        z = &W->ring[W->head];                  // oldest sample, its slot is reused
+        os_rb_tree_delete(W->T, z);
+        W->head = (W->head + 1 == W->capacity) ? 0 : W->head + 1;
+    }
+    z->key = sample;
+    z->p = NULL;
+    os_rb_tree_insert(W->T, z);                 // resets links, size and colour
+}
+
+int window_select(SlidingWindow* W, int i, int* value){
+    OSNode* x = os_select(W->T->root, i);
+    if (x == NULL)
+        return 0;
+    *value = x->key;
+    return 1;
+}
+
+int window_quantile(SlidingWindow* W, double q, int* value){
+    if (W->count == 0)
+        return 0;
+    int i = (int)ceil(q * W->count);
+    if (i < 1)
+        i = 1;
+    if (i > W->count)
+        i = W->count;
+    return window_select(W, i, value);
+}
@@ -0,0 +1,265 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "../include/splay_tree.h"
+
+// ---------- BST ----------
+
+// Rotate x above its parent, *root fixed if the parent was the root
+static void rotate_up(Node** root, Node* x){
+    Node* p = x->p;
+    Node* g = p->p;
+    if (x == p->left){
+        p->left = x->right;
+        if (x->right != NULL)
+            x->right->p = p;
+        x->right = p;
+    }
+    else{
+        p->right = x->left;
+        if (x->left != NULL)
+            x->left->p = p;
+        x->left = p;
+    }
+    p->p = x;
+    x->p = g;
+    if (g == NULL)
+        *root = x;
+    else if (g->left == p)
+        g->left = x;
+    else
+        g->right = x;
+}
+
+// zig (parent is the root), zig-zig (same side: parent first), zig-zag
+static void splay_to_root(Node** root, Node* x){
+    while (x->p != NULL){
+        Node* p = x->p;
+        Node* g = p->p;
+        if (g != NULL)
+            rotate_up(root, (x == p->left) == (p == g->left) ? p : x);
+        rotate_up(root, x);
+    }
+}
+
+void splay(Tree* T, Node* x){
+    splay_to_root(&T->root, x);
+}
+
+void splay_tree_insert(Tree* T, Node* z){
+    tree_forget_ends(T);
+    Node* y = NULL;
+    Node* x = T->root;
+    while (x != NULL){
+        y = x;
+        if (z->key < x->key)
+            x = x->left;
+        else
+            x = x->right;
+    }
+    z->left = z->right = NULL;
+    z->p = y;
+    if (y == NULL)
+        T->root = z;
+    else if (z->key < y->key)
+        y->left = z;
+    else
+        y->right = z;
+    splay_to_root(&T->root, z);
+}
+
+// With z at the root, splay the max of its left subtree to the top of that
+// subtree: it has no right child, so z's right subtree hangs there
+void splay_tree_delete(Tree* T, Node* z){
+    tree_forget_ends(T);
+    splay_to_root(&T->root, z);
+    Node* l = z->left;
+    Node* r = z->right;
+    if (l == NULL){
+        T->root = r;
+        if (r != NULL)
+            r->p = NULL;
+    }
+    else{
+        l->p = NULL;
+        Node* m = l;
+        while (m->right != NULL)
+            m = m->right;
+        splay_to_root(&l, m);
+        m->right = r;
+        if (r != NULL)
+            r->p = m;
+        T->root = m;
+    }
+    z->left = z->right = z->p = NULL;
+}
+
+Node* splay_tree_search(Tree* T, int key){
+    Node* last = NULL;
+    Node* x = T->root;
+    while (x != NULL && key != x->key){
+        last = x;
+        x = (key < x->key) ? x->left : x->right;
+    }
+    if (x != NULL)
+        splay_to_root(&T->root, x);
+    else if (last != NULL)
+        splay_to_root(&T->root, last);   // misses pay for their path too
+    return x;
+}
+
+Node* splay_tree_min(Tree* T){
+    Node* x = T->root;
+    if (x == NULL)
+        return NULL;
+    while (x->left != NULL)
+        x = x->left;
+    splay_to_root(&T->root, x);
+    return x;
+}
+
+Node* splay_tree_max(Tree* T){
+    Node* x = T->root;
+    if (x == NULL)
+        return NULL;
+    while (x->right != NULL)
+        x = x->right;
+    splay_to_root(&T->root, x);
+    return x;
+}
+
+// ---------- OS-tree ----------
+
+static int size_of(OSNode* x){
+    return x == NULL ? 0 : x->size;
+}
+
+// Same rotation, x takes over p's size and p is recounted from its new children
+static void os_rotate_up(OSNode** root, OSNode* x){
+    OSNode* p = x->p;
+    OSNode* g = p->p;
+    if (x == p->left){
+        p->left = x->right;
+        if (x->right != NULL)
+            x->right->p = p;
+        x->right = p;
+    }
+    else{
+        p->right = x->left;
+        if (x->left != NULL)
+            x->left->p = p;
+        x->left = p;
+    }
+    p->p = x;
+    x->p = g;
+    if (g == NULL)
+        *root = x;
+    else if (g->left == p)
+        g->left = x;
+    else
+        g->right = x;
+    x->size = p->size;
+    p->size = size_of(p->left) + size_of(p->right) + 1;
+}
+
+static void os_splay_to_root(OSNode** root, OSNode* x){
+    while (x->p != NULL){
+        OSNode* p = x->p;
+        OSNode* g = p->p;
+        if (g != NULL)
+            os_rotate_up(root, (x == p->left) == (p == g->left) ? p : x);
+        os_rotate_up(root, x);
+    }
+}
+
+void os_splay(OSTree* T, OSNode* x){
+    os_splay_to_root(&T->root, x);
+}
+
+void os_splay_tree_insert(OSTree* T, OSNode* z){
+    os_tree_forget_ends(T);
+    OSNode* y = NULL;
+    OSNode* x = T->root;
+    while (x != NULL){
+        y = x;
+        x->size++;
+        if (z->key < x->key)
+            x = x->left;
+        else
+            x = x->right;
+    }
+    z->left = z->right = NULL;
+    z->size = 1;
+    z->p = y;
+    if (y == NULL)
+        T->root = z;
+    else if (z->key < y->key)
+        y->left = z;
+    else
+        y->right = z;
+    os_splay_to_root(&T->root, z);
+}
+
+void os_splay_tree_delete(OSTree* T, OSNode* z){
+    os_tree_forget_ends(T);
+    os_splay_to_root(&T->root, z);
+    OSNode* l = z->left;
+    OSNode* r = z->right;
+    if (l == NULL){
+        T->root = r;
+        if (r != NULL)
+            r->p = NULL;
+    }
+    else{
+        l->p = NULL;
+        OSNode* m = l;
+        while (m->right != NULL)
+            m = m->right;
+        os_splay_to_root(&l, m);     // m->size is now |l|
+        m->right = r;
+        if (r != NULL){
+            r->p = m;
+            m->size += r->size;
+        }
+        T->root = m;
+    }
+    z->left = z->right = z->p = NULL;
+    z->size = 1;
+}
+
+OSNode* os_splay_tree_search(OSTree* T, int key){
+    OSNode* last = NULL;
+    OSNode* x = T->root;
+    while (x != NULL && key != x->key){
+        last = x;
+        x = (key < x->key) ? x->left : x->right;
+    }
+    if (x != NULL)
+        os_splay_to_root(&T->root, x);
+    else if (last != NULL)
+        os_splay_to_root(&T->root, last);
+    return x;
+}
+
+OSNode* os_splay_select(OSTree* T, int i){
+    OSNode* x = T->root;
+    while (x != NULL){
+        int r = size_of(x->left) + 1;
+        if (i == r)
+            break;
+        if (i < r){
+            x = x->left;
+        }
+        else{
+            i -= r;
+            x = x->right;
+        }
+    }
+    if (x != NULL)
+        os_splay_to_root(&T->root, x);
+    return x;
+}
+
+int os_splay_rank(OSTree* T, OSNode* x){
+    os_splay_to_root(&T->root, x);
+    return size_of(x->left) + 1;
+}
@@ -0,0 +1,320 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include <stdint.h>
+#include "../include/treap.h"
+
+static unsigned int treap_seed = 0x9e3779b9u;
+
+void treap_set_seed(unsigned int seed){
+    treap_seed = seed;
+}
+
+// murmur3 finaliser: cheap and well mixed
+static unsigned int mix32(unsigned int h){
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Priority = hash of key ^ seed on top, so a key gets the same rank in every
+// treap and two treaps can be merged node by node. The low half hashes the
+// node's address: copies of one key would all tie and stack into a chain,
+// this way they are spread like any other keys.
+static unsigned long long priority(const Node* x){
+    uintptr_t a = (uintptr_t)x;
+    unsigned int tie = mix32((unsigned int)(a ^ (a >> 32)));
+    return ((unsigned long long)mix32((unsigned int)x->key ^ treap_seed) << 32) | tie;
+}
+
+// Split subtree x into keys < key (*l) and keys >= key (*r), one pass down.
+// ties_left puts keys == key in *l instead (keys <= key | keys > key).
+// If eq is given, one node with key == key is cut out into *eq instead.
+// lp/rp are the child pointers the next node on each side gets hung on.
+static void split_nodes(Node* x, int key, int ties_left, Node** l, Node** r, Node** eq){
+    Node** lp = l;
+    Node** rp = r;
+    Node* lpar = NULL;
+    Node* rpar = NULL;
+    if (eq != NULL)
+        *eq = NULL;
+
+    while (x != NULL){
+        if (eq != NULL && x->key == key){
+            *lp = x->left;
+            if (x->left != NULL)
+                x->left->p = lpar;
+            *rp = x->right;
+            if (x->right != NULL)
+                x->right->p = rpar;
+            x->left = x->right = x->p = NULL;
+            *eq = x;
+            return;
+        }
+        if (x->key < key || (ties_left && x->key == key)){
+            *lp = x;
+            x->p = lpar;
+            lpar = x;
+            lp = &x->right;
+            x = x->right;
+        }
+        else{
+            *rp = x;
+            x->p = rpar;
+            rpar = x;
+            rp = &x->left;
+            x = x->left;
+        }
+    }
+    *lp = NULL;
+    *rp = NULL;
+}
+
+// Join a and b (all keys of a <= all keys of b): zip down a's right spine and
+// b's left spine, higher priority on top. Returns the new root (parent NULL).
+static Node* join_nodes(Node* a, Node* b){
+    Node* root = NULL;
+    Node** hook = &root;
+    Node* par = NULL;
+
+    while (a != NULL && b != NULL){
+        if (priority(a) >= priority(b)){
+            *hook = a;
+            a->p = par;
+            par = a;
+            hook = &a->right;
+            a = a->right;
+        }
+        else{
+            *hook = b;
+            b->p = par;
+            par = b;
+            hook = &b->left;
+            b = b->left;
+        }
+    }
+    Node* rest = (a != NULL) ? a : b;
+    *hook = rest;
+    if (rest != NULL)
+        rest->p = par;
+    return root;
+}
+
+// Hang l and r under x as its children
+static Node* attach(Node* x, Node* l, Node* r){
+    x->left = l;
+    x->right = r;
+    if (l != NULL)
+        l->p = x;
+    if (r != NULL)
+        r->p = x;
+    return x;
+}
+
+// Free a whole subtree leaf by leaf (same walk as destroy_tree) into owner
+static void free_subtree(Tree* owner, Node* x){
+    if (x == NULL)
+        return;
+    x->p = NULL;
+    while (x != NULL){
+        if (x->left != NULL){
+            x = x->left;
+        }
+        else if (x->right != NULL){
+            x = x->right;
+        }
+        else{
+            Node* parent = x->p;
+            if (parent != NULL){
+                if (parent->left == x)
+                    parent->left = NULL;
+                else
+                    parent->right = NULL;
+            }
+            tree_free_node(owner, x);
+            x = parent;
+        }
+    }
+}
+
+// Insert: go down while the nodes on the path outrank z, then split the
+// subtree found there around z->key and put z on top of the two halves.
+// Copies of z->key end up on z's left, so copies keep their insert order and
+// the address part of the priority alone decides their shape.
+void treap_insert(Tree* T, Node* z){
+    tree_forget_ends(T);
+    unsigned long long pz = priority(z);
+    Node* y = NULL;
+    Node* x = T->root;
+
+    while (x != NULL && priority(x) >= pz){
+        y = x;
+        if (z->key < x->key)
+            x = x->left;
+        else
+            x = x->right;
+    }
+
+    Node* l;
+    Node* r;
+    split_nodes(x, z->key, 1, &l, &r, NULL);
+    attach(z, l, r);
+
+    z->p = y;
+    if (y == NULL)
+        T->root = z;
+    else if (z->key < y->key)
+        y->left = z;
+    else
+        y->right = z;
+}
+
+void treap_delete(Tree* T, Node* z){
+    tree_forget_ends(T);
+    Node* j = join_nodes(z->left, z->right);
+    transplant(T, z, j);
+    z->left = z->right = z->p = NULL;
+}
+
+void treap_split(Tree* T, int key, Tree* L, Tree* R){
+    tree_forget_ends(T);
+    tree_forget_ends(L);
+    tree_forget_ends(R);
+    split_nodes(T->root, key, 0, &L->root, &R->root, NULL);
+    T->root = NULL;
+}
+
+void treap_join(Tree* T, Tree* L, Tree* R){
+    tree_forget_ends(T);
+    tree_forget_ends(L);
+    tree_forget_ends(R);
+    T->root = join_nodes(L->root, R->root);
+    if (L != T)
+        L->root = NULL;
+    if (R != T)
+        R->root = NULL;
+}
+
+// The set operations recurse on both halves after one split.
+// Depth is the treap height, O(log n) expected.
+
+// a from A, b from B. The higher-priority root stays on top, the other
+// tree is split around its key and the halves are merged underneath.
+static Node* union_nodes(Tree* A, Node* a, Tree* B, Node* b){
+    if (a == NULL)
+        return b;
+    if (b == NULL)
+        return a;
+    if (priority(a) < priority(b)){
+        Node* t = a; a = b; b = t;
+        Tree* o = A; A = B; B = o;
+    }
+    Node* l;
+    Node* r;
+    Node* dup;
+    split_nodes(b, a->key, 0, &l, &r, &dup);
+    if (dup != NULL)
+        tree_free_node(B, dup);
+    Node* al = a->left;
+    Node* ar = a->right;
+    return attach(a, union_nodes(A, al, B, l), union_nodes(A, ar, B, r));
+}
+
+static Node* intersection_nodes(Tree* A, Node* a, Tree* B, Node* b){
+    if (a == NULL || b == NULL){
+        free_subtree(A, a);
+        free_subtree(B, b);
+        return NULL;
+    }
+    if (priority(a) < priority(b)){
+        Node* t = a; a = b; b = t;
+        Tree* o = A; A = B; B = o;
+    }
+    Node* l;
+    Node* r;
+    Node* dup;
+    split_nodes(b, a->key, 0, &l, &r, &dup);
+    Node* al = a->left;
+    Node* ar = a->right;
+    Node* left = intersection_nodes(A, al, B, l);
+    Node* right = intersection_nodes(A, ar, B, r);
+    if (dup != NULL){
+        tree_free_node(B, dup);
+        return attach(a, left, right);
+    }
+    tree_free_node(A, a);
+    return join_nodes(left, right);
+}
+
+// Not symmetric, so no swapping: split b around a's root every time
+static Node* difference_nodes(Tree* A, Node* a, Tree* B, Node* b){
+    if (a == NULL){
+        free_subtree(B, b);
+        return NULL;
+    }
+    if (b == NULL)
+        return a;
+    Node* l;
+    Node* r;
+    Node* dup;
+    split_nodes(b, a->key, 0, &l, &r, &dup);
+    Node* al = a->left;
+    Node* ar = a->right;
+    Node* left = difference_nodes(A, al, B, l);
+    Node* right = difference_nodes(A, ar, B, r);
+    if (dup != NULL){
+        tree_free_node(B, dup);
+        tree_free_node(A, a);
+        return join_nodes(left, right);
+    }
+    return attach(a, left, right);
+}
+
+void treap_union(Tree* A, Tree* B){
+    tree_forget_ends(A);
+    tree_forget_ends(B);
+    A->root = union_nodes(A, A->root, B, B->root);
+    if (A->root != NULL)
+        A->root->p = NULL;
+    B->root = NULL;
+}
+
+void treap_intersection(Tree* A, Tree* B){
+    tree_forget_ends(A);
+    tree_forget_ends(B);
+    A->root = intersection_nodes(A, A->root, B, B->root);
+    if (A->root != NULL)
+        A->root->p = NULL;
+    B->root = NULL;
+}
+
+void treap_difference(Tree* A, Tree* B){
+    tree_forget_ends(A);
+    tree_forget_ends(B);
+    A->root = difference_nodes(A, A->root, B, B->root);
+    if (A->root != NULL)
+        A->root->p = NULL;
+    B->root = NULL;
+}
+
+// In-order pass: keys sorted, children point back at their parent and
+// never outrank it
+int treap_validate(Tree* T){
+    if (T->root == NULL)
+        return 1;
+    if (T->root->p != NULL)
+        return 0;
+    Node* prev = NULL;
+    for (Node* x = tree_min(T->root); x != NULL; x = tree_successor(x)){
+        if (prev != NULL && prev->key > x->key)
+            return 0;
+        if (x->left != NULL && (x->left->p != x || priority(x->left) > priority(x)))
+            return 0;
+        if (x->right != NULL && (x->right->p != x || priority(x->right) > priority(x)))
+            return 0;
+        prev = x;
+    }
+    return 1;
+}
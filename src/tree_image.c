@@ -0,0 +1,254 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/tree_image.h"
+
+static const char IMAGE_MAGIC[8] = {'T', 'R', 'E', 'E', 'I', 'M', 'G', '1'};
+
+#define WRITE_BUF_BYTES (1 << 20)
+
+// ---------- writing ----------
+
+// Buffered sequential writer, remembers the first error
+typedef struct {
+    int fd;
+    char* buf;
+    size_t used;
+    int failed;
+} ImageWriter;
+
+static void writer_flush(ImageWriter* w){
+    size_t off = 0;
+    while (off < w->used && !w->failed){
+        ssize_t k = write(w->fd, w->buf + off, w->used - off);
+        if (k <= 0)
+            w->failed = 1;
+        else
+            off += (size_t)k;
+    }
+    w->used = 0;
+}
+
+static void writer_put(ImageWriter* w, const void* rec, size_t bytes){
+    if (w->used + bytes > WRITE_BUF_BYTES)
+        writer_flush(w);
+    memcpy(w->buf + w->used, rec, bytes);
+    w->used += bytes;
+}
+
+// FIFO of nodes for the BFS, slides back to the front instead of growing
+// while there is room: it only ever holds about one level of the tree
+typedef struct {
+    void** items;
+    size_t head, tail, cap;
+} NodeQueue;
+
+static void queue_push(NodeQueue* q, void* x){
+    if (q->tail == q->cap){
+        if (q->head > q->cap / 2){
+            memmove(q->items, q->items + q->head, (q->tail - q->head) * sizeof(void*));
+        }
+        else{
+            q->cap *= 2;
+            q->items = (void**)realloc(q->items, q->cap * sizeof(void*));
+            memmove(q->items, q->items + q->head, (q->tail - q->head) * sizeof(void*));
+        }
+        q->tail -= q->head;
+        q->head = 0;
+    }
+    q->items[q->tail++] = x;
+}
+
+// BFS: a node's children get the next free indices when it is written, so
+// every record can go out as soon as its node comes off the queue
+static int write_image(const char* path, int kind, void* root){
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return -1;
+    ImageWriter w = {fd, (char*)malloc(WRITE_BUF_BYTES), 0, 0};
+    NodeQueue q = {(void**)malloc(1024 * sizeof(void*)), 0, 0, 1024};
+
+    ImageHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, IMAGE_MAGIC, sizeof(h.magic));
+    h.kind = (uint32_t)kind;
+    h.node_bytes = (kind == IMAGE_OS) ? sizeof(ImgOSNode) : sizeof(ImgNode);
+    writer_put(&w, &h, sizeof(h));
+    ImgOSNode nil;
+    memset(&nil, 0, sizeof(nil));
+    writer_put(&w, &nil, h.node_bytes);
+
+    uint64_t next = 2;                 // index the next child gets, root is 1
+    if (root != NULL)
+        queue_push(&q, root);
+    while (q.head < q.tail){
+        void* x = q.items[q.head++];
+        if (kind == IMAGE_OS){
+            OSNode* o = (OSNode*)x;
+            ImgOSNode r = {o->key, o->size, 0, 0};
+            if (o->left != NULL){
+                r.left = (uint32_t)next++;
+                queue_push(&q, o->left);
+            }
+            if (o->right != NULL){
+                r.right = (uint32_t)next++;
+                queue_push(&q, o->right);
+            }
+            writer_put(&w, &r, sizeof(r));
+        }
+        else{
+            Node* b = (Node*)x;
+            ImgNode r = {b->key, 0, 0};
+            if (b->left != NULL){
+                r.left = (uint32_t)next++;
+                queue_push(&q, b->left);
+            }
+            if (b->right != NULL){
+                r.right = (uint32_t)next++;
+                queue_push(&q, b->right);
+            }
+            writer_put(&w, &r, sizeof(r));
+        }
+    }
+    int too_big = (next - 1 >= UINT32_MAX);
+    writer_flush(&w);
+
+    h.n = (root != NULL) ? next - 1 : 0;
+    h.root = (root != NULL) ? 1 : 0;
+    if (pwrite(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h))
+        w.failed = 1;
+    if (close(fd) != 0)
+        w.failed = 1;
+    free(w.buf);
+    free(q.items);
+    if (w.failed || too_big){
+        unlink(path);
+        return -1;
+    }
+    return 0;
+}
+
+int tree_image_write(Tree* T, const char* path){
+    return write_image(path, IMAGE_BST, T->root);
+}
+
+int os_tree_image_write(OSTree* T, const char* path){
+    return write_image(path, IMAGE_OS, T->root);
+}
+
+// ---------- reading ----------
+
+TreeImage* tree_image_open(const char* path){
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ImageHeader)){
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    void* base = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                          // the mapping keeps the file
+    if (base == MAP_FAILED)
+        return NULL;
+
+    const ImageHeader* h = (const ImageHeader*)base;
+    size_t node_bytes = (h->kind == IMAGE_OS) ? sizeof(ImgOSNode) : sizeof(ImgNode);
+    if (memcmp(h->magic, IMAGE_MAGIC, sizeof(h->magic)) != 0
+        || (h->kind != IMAGE_BST && h->kind != IMAGE_OS)
+        || h->node_bytes != node_bytes
+        || h->n >= UINT32_MAX
+        || bytes != sizeof(ImageHeader) + (h->n + 1) * node_bytes
+        || h->root > h->n){
+        munmap(base, bytes);
+        return NULL;
+    }
+
+    TreeImage* I = (TreeImage*)malloc(sizeof(TreeImage));
+    I->base = base;
+    I->bytes = bytes;
+    I->kind = (int)h->kind;
+    I->n = (uint32_t)h->n;
+    I->root = h->root;
+    const char* records = (const char*)base + sizeof(ImageHeader);
+    I->nodes = (h->kind == IMAGE_BST) ? (const ImgNode*)records : NULL;
+    I->os_nodes = (h->kind == IMAGE_OS) ? (const ImgOSNode*)records : NULL;
+    return I;
+}
+
+void tree_image_close(TreeImage* I){
+    if (I == NULL)
+        return;
+    munmap(I->base, I->bytes);
+    free(I);
+}
+
+// ---------- queries ----------
+
+uint32_t image_search(const TreeImage* I, int key){
+    uint32_t x = I->root;
+    if (I->kind == IMAGE_OS){
+        const ImgOSNode* t = I->os_nodes;
+        while (x != 0 && key != t[x].key)
+            x = (key < t[x].key) ? t[x].left : t[x].right;
+    }
+    else{
+        const ImgNode* t = I->nodes;
+        while (x != 0 && key != t[x].key)
+            x = (key < t[x].key) ? t[x].left : t[x].right;
+    }
+    return x;
+}
+
+int image_key(const TreeImage* I, uint32_t x){
+    return (I->kind == IMAGE_OS) ? I->os_nodes[x].key : I->nodes[x].key;
+}
+
+// nil record has size 0, so no checks on the way down
+uint32_t image_os_select(const TreeImage* I, int i){
+    if (I->kind != IMAGE_OS)
+        return 0;
+    const ImgOSNode* t = I->os_nodes;
+    uint32_t x = I->root;
+    while (x != 0){
+        int r = t[t[x].left].size + 1;
+        if (i == r)
+            return x;
+        if (i < r){
+            x = t[x].left;
+        }
+        else{
+            i -= r;
+            x = t[x].right;
+        }
+    }
+    return 0;
+}
+
+// no parent links in the image, so by key on the way down (see os_ptree_rank)
+int image_os_rank(const TreeImage* I, int key){
+    if (I->kind != IMAGE_OS)
+        return 0;
+    const ImgOSNode* t = I->os_nodes;
+    uint32_t x = I->root;
+    int r = 0, found = 0;
+    while (x != 0){
+        if (key < t[x].key){
+            x = t[x].left;
+        }
+        else if (key > t[x].key){
+            r += t[t[x].left].size + 1;
+            x = t[x].right;
+        }
+        else{
+            found = r + t[t[x].left].size + 1;
+            x = t[x].left;
+        }
+    }
+    return found;
+}
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <string.h>
+#include <pthread.h>
 #include "../include/utils.h"
 
 typedef struct {
@@ -79,7 +81,163 @@ double get_time_ms() {
     return ((double)clock() / CLOCKS_PER_SEC) * 1000.0;
 }
 
+// wall clock -> what multi-threaded runs need (clock() adds up every thread's CPU time)
+double get_wall_time_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
 //generate rand num
 int random_range(int min, int max) {
     return min + rand() % (max - min + 1);
-}
\ No newline at end of file
+}
+// ---------- threads ----------
+
+typedef struct {
+    int worker;
+    int threads;
+    int ntasks;
+    void (*fn)(void* ctx, int task);
+    void* ctx;
+} ParallelWorker;
+
+static void* parallel_worker(void* arg) {
+    ParallelWorker* w = (ParallelWorker*)arg;
+    for (int task = w->worker; task < w->ntasks; task += w->threads) {
+        w->fn(w->ctx, task);
+    }
+    return NULL;
+}
+
+// worker t runs tasks t, t + threads, ..; the calling thread is worker 0
+void parallel_for(int threads, int ntasks, void (*fn)(void* ctx, int task), void* ctx) {
+    if (threads > ntasks) threads = ntasks;
+    if (threads <= 1) {
+        for (int task = 0; task < ntasks; task++) {
+            fn(ctx, task);
+        }
+        return;
+    }
+    pthread_t* tid = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    ParallelWorker* w = (ParallelWorker*)malloc(threads * sizeof(ParallelWorker));
+    for (int t = 0; t < threads; t++) {
+        w[t].worker = t;
+        w[t].threads = threads;
+        w[t].ntasks = ntasks;
+        w[t].fn = fn;
+        w[t].ctx = ctx;
+    }
+    for (int t = 1; t < threads; t++) {
+        pthread_create(&tid[t], NULL, parallel_worker, &w[t]);
+    }
+    parallel_worker(&w[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(tid[t], NULL);
+    }
+    free(tid);
+    free(w);
+}
+
+// ---------- parallel sort ----------
+// Radix sort one chunk per thread, then merge runs pairwise. Every merge
+// round uses all threads: each pair's output is cut into equal pieces and a
+// binary search along the merge path finds where each piece starts in both runs.
+
+typedef struct {
+    int* src;
+    int* dst;
+    int* bounds;     // run r is src[bounds[r] .. bounds[r+1])
+    int runs;
+    int per_pair;    // pieces each pair's merge is cut into
+} SortCtx;
+
+// LSD radix sort, 4 passes of 8 bits, scratch = same slice of dst. Sign bit
+// flipped so negative keys come first. Even number of passes -> ends in src.
+static void sort_chunk(void* arg, int task) {
+    SortCtx* c = (SortCtx*)arg;
+    int lo = c->bounds[task];
+    int len = c->bounds[task + 1] - lo;
+    unsigned int* a = (unsigned int*)c->src + lo;
+    unsigned int* b = (unsigned int*)c->dst + lo;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int count[257] = {0};
+        for (int i = 0; i < len; i++) {
+            count[(((a[i] ^ 0x80000000u) >> shift) & 0xff) + 1]++;
+        }
+        for (int d = 0; d < 256; d++) {
+            count[d + 1] += count[d];
+        }
+        for (int i = 0; i < len; i++) {
+            b[count[((a[i] ^ 0x80000000u) >> shift) & 0xff]++] = a[i];
+        }
+        unsigned int* t = a; a = b; b = t;
+    }
+}
+
+// first i with i + j == d such that a[0..i) + b[0..j) are the d smallest
+static int merge_path(const int* a, int la, const int* b, int lb, int d) {
+    int lo = d > lb ? d - lb : 0;
+    int hi = d < la ? d : la;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (a[mid] <= b[d - mid - 1]) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void merge_piece(void* arg, int task) {
+    SortCtx* c = (SortCtx*)arg;
+    int pair = task / c->per_pair;
+    int piece = task % c->per_pair;
+    int r = 2 * pair;
+    int* a = c->src + c->bounds[r];
+    int* out = c->dst + c->bounds[r];
+    if (r + 1 == c->runs) {             // odd run out, just copy it over
+        if (piece == 0) memcpy(out, a, (c->bounds[r + 1] - c->bounds[r]) * sizeof(int));
+        return;
+    }
+    int la = c->bounds[r + 1] - c->bounds[r];
+    int* b = c->src + c->bounds[r + 1];
+    int lb = c->bounds[r + 2] - c->bounds[r + 1];
+    long long total = (long long)la + lb;
+    int d0 = (int)(total * piece / c->per_pair);
+    int d1 = (int)(total * (piece + 1) / c->per_pair);
+    int i = merge_path(a, la, b, lb, d0);
+    int j = d0 - i;
+    int end_i = merge_path(a, la, b, lb, d1);
+    int end_j = d1 - end_i;
+    for (int k = d0; k < d1; k++) {
+        if (j >= end_j || (i < end_i && a[i] <= b[j])) out[k] = a[i++];
+        else out[k] = b[j++];
+    }
+}
+
+void parallel_sort(int* keys, int n, int threads) {
+    if (n <= 1) return;
+    if (threads < 1) threads = 1;
+    if (threads > n / 1024) threads = n / 1024 > 0 ? n / 1024 : 1;   // tiny inputs: not worth a thread
+    int* bounds = (int*)malloc((threads + 1) * sizeof(int));
+    for (int t = 0; t <= threads; t++) {
+        bounds[t] = (int)((long long)n * t / threads);
+    }
+    int* tmp = (int*)malloc(n * sizeof(int));
+    SortCtx c = {keys, tmp, bounds, threads, 1};
+    parallel_for(threads, threads, sort_chunk, &c);
+
+    while (c.runs > 1) {
+        int pairs = (c.runs + 1) / 2;
+        c.per_pair = threads / pairs > 0 ? threads / pairs : 1;
+        parallel_for(threads, pairs * c.per_pair, merge_piece, &c);
+        for (int r = 0; r < pairs; r++) {           // run r of the next round = pair r
+            bounds[r] = bounds[2 * r];
+        }
+        bounds[pairs] = n;
+        c.runs = pairs;
+        int* t = c.src; c.src = c.dst; c.dst = t;
+    }
+    if (c.src != keys) memcpy(keys, c.src, n * sizeof(int));
+    free(tmp);
+    free(bounds);
+}